@@ -29,6 +29,22 @@ DENG_EXTERN_C int rFrameCount;
 DENG_EXTERN_C timespan_t sysTime, gameTime, demoTime;
 DENG_EXTERN_C dd_bool tickFrame;
 
+/**
+ * Subsystems whose running time is measured during a timedemo.
+ */
+typedef enum timedemosubsystem_e {
+    TDS_PLAYSIM,   ///< World and players (P_Ticker).
+    TDS_THINKERS,  ///< Thinker_Run (part of the game logic).
+    TDS_GAME,      ///< Game plugin ticker.
+    TDS_INFINE,
+    TDS_NETGAME,   ///< Client or server ticker, e.g., client mobj updates.
+    TDS_FRAMES,    ///< Generating frames for clients (server only).
+    TDS_CONSOLE,
+    TDS_PLUGINS,
+    TDS_NETWORK,
+    NUM_TIMEDEMO_SUBSYSTEMS
+} timedemosubsystem_t;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -95,8 +111,30 @@ void DD_SetGameLoopExitCode(int code);
  */
 int DD_GameLoopExitCode(void);
 
+/**
+ * Runs @a tics sharp tics back to back without waiting for real time to pass, and
+ * prints how quickly they were processed and where the time was spent. Input and
+ * rendering are not involved, so the timedemo works without a window. A map must be
+ * loaded.
+ *
+ * On a dedicated server no clients are connected, so the players are not in the
+ * game: the results cover the thinkers and the rest of the world, but not player
+ * movement or the generation of frames for clients.
+ *
+ * @param tics  Number of tics to run.
+ */
+void Loop_RunTimeDemo(int tics);
+
 #ifdef __cplusplus
 } // extern "C"
+
+#include <functional>
+
+/**
+ * Calls @a func. During a timedemo, the time spent in the call is added to the
+ * total of subsystem @a sub.
+ */
+void Loop_MeasureTime(timedemosubsystem_t sub, std::function<void ()> const &func);
 #endif
 
 #endif
@@ -81,6 +81,10 @@ ClientServerWorld &App_World();
  */
 void Con_Open(de::dint yes);
 
+/**
+ * Handles the -playdemo and -timedemo options. Called once after startup, when a game
+ * has been loaded. The timedemo is deferred until the startup map has been loaded.
+ */
 void DD_CheckTimeDemo();
 void DD_UpdateEngineState();
 
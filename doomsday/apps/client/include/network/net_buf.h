@@ -43,6 +43,7 @@ typedef struct netmessage_s {
     size_t          size;
     byte           *data;
     void           *handle;
+    size_t          bufferSize;     // Size of the buffer allocated for the data.
     double          receivedAt;     // Time when received (seconds).
 } netmessage_t;
 
@@ -127,10 +128,20 @@ void N_PrintBufferInfo(void);
 void N_PrintTransmissionStats(void);
 
 /**
- * Adds the given netmessage_s to the queue of received messages. Uses a mutex to
- * synchronize access to the message queue.
+ * Returns a message for posting with N_PostMessage(). Messages are recycled after
+ * they have been processed, so usually no memory needs to be allocated.
  *
- * @note This is called in the network receiver thread.
+ * @param sender  Network node that sent the message.
+ * @param data    Message data. A copy is made.
+ * @param size    Size of the message data.
+ */
+netmessage_t *N_NewMessage(nodeid_t sender, void const *data, size_t size);
+
+/**
+ * Adds the given netmessage_s to the queue of received messages. The queue is
+ * lock-free, so messages can be posted by multiple threads without contention.
+ *
+ * @param msg  Message allocated with N_NewMessage(). The queue takes ownership.
  */
 void N_PostMessage(netmessage_t *msg);
 
@@ -43,6 +43,21 @@ void Msg_End(void);
 
 dd_bool Msg_BeingWritten(void);
 
+/**
+ * Allocate a writer for composing a message separately from the current message
+ * (e.g., in another thread). The message type is written first.
+ *
+ * @return  Writer for the message. Finish it with Msg_EndWriter().
+ */
+Writer1 *Msg_NewWriter(int type);
+
+/**
+ * Finalize the netbuffer using a message composed with a writer allocated by
+ * Msg_NewWriter(). The writer is deleted. The current message (if any) being
+ * written is not affected.
+ */
+void Msg_EndWriter(Writer1 *writer);
+
 /**
  * Begin reading a message from netBuffer. If a message is currently being
  * written, the writing will be ended.
@@ -0,0 +1,75 @@
+/** @file visspritesort.h  Draw order sorting of vissprites.
+ *
+ * @authors Copyright © 2026 agent <agent@local>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#ifndef DENG_CLIENT_RENDER_VISSPRITESORT_H
+#define DENG_CLIENT_RENDER_VISSPRITESORT_H
+
+#include <de/libcore.h>
+#include <algorithm>
+
+/**
+ * Draw order sort key for a vissprite (see VisSprite_SortByDistance()).
+ * @ingroup render
+ */
+struct VisSpriteSortKey
+{
+    de::ddouble distance;
+    de::dint index;
+};
+
+/**
+ * Links an array of vissprites into the ring at @a head in draw order: back to
+ * front, and those at equal distance in reverse order of projection. A compact
+ * array of keys is sorted rather than the vissprites themselves.
+ *
+ * @param sprites   Vissprites to sort. Must have @c prev and @c next links.
+ * @param count     Number of vissprites in @a sprites.
+ * @param head      Head of the ring of sorted vissprites.
+ * @param keys      Work space for (at least) @a count sort keys.
+ * @param distance  Function that returns the distance of a vissprite from the viewer.
+ */
+template <typename SpriteType, typename DistanceFunc>
+void VisSprite_SortByDistance(SpriteType *sprites, de::dint count, SpriteType &head,
+                              VisSpriteSortKey *keys, DistanceFunc distance)
+{
+    for(de::dint i = 0; i < count; ++i)
+    {
+        keys[i].distance = distance(sprites[i]);
+        keys[i].index    = i;
+    }
+    std::sort(keys, keys + count, [] (VisSpriteSortKey const &a, VisSpriteSortKey const &b)
+    {
+        if(a.distance != b.distance) return a.distance > b.distance;
+        return a.index > b.index;
+    });
+
+    // Link the vissprites in sorted order.
+    SpriteType *prev = &head;
+    for(de::dint i = 0; i < count; ++i)
+    {
+        SpriteType *spr = &sprites[keys[i].index];
+        spr->prev  = prev;
+        prev->next = spr;
+        prev = spr;
+    }
+    prev->next = &head;
+    head.prev  = prev;
+}
+
+#endif  // DENG_CLIENT_RENDER_VISSPRITESORT_H
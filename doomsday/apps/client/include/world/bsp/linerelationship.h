@@ -0,0 +1,85 @@
+/** @file linerelationship.h  Logical relationship between two line segments.
+ *
+ * Originally based on glBSP 2.24 (in turn, based on BSP 2.3)
+ * @see http://sourceforge.net/projects/glbsp/
+ *
+ * @authors Copyright © 2026 agent <agent@local>
+ * @authors Copyright © 2007-2016 Daniel Swanson <danij@dengine.net>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#ifndef DENG_WORLD_BSP_LINERELATIONSHIP_H
+#define DENG_WORLD_BSP_LINERELATIONSHIP_H
+
+#include <de/types.h>
+#include <de/math.h>
+
+/// Rounding threshold within which two points are considered as co-incident.
+#define LINESEGMENT_INCIDENT_DISTANCE_EPSILON       1.0 / 128
+
+namespace world {
+namespace bsp {
+
+/**
+ * LineRelationship delineates the possible logical relationships between two
+ * line (segments) in the plane.
+ *
+ * @ingroup bsp
+ */
+enum LineRelationship
+{
+    Collinear,
+    Right,
+    RightIntercept, ///< Right vertex intercepts.
+    Left,
+    LeftIntercept,  ///< Left vertex intercepts.
+    Intersects
+};
+
+/// @todo Might be a useful global utility function? -ds
+inline LineRelationship lineRelationship(coord_t fromDist, coord_t toDist)
+{
+    static coord_t const distEpsilon = LINESEGMENT_INCIDENT_DISTANCE_EPSILON;
+
+    // Collinear with "this" line?
+    if(de::abs(fromDist) <= distEpsilon && de::abs(toDist) <= distEpsilon)
+    {
+        return Collinear;
+    }
+
+    // To the right of "this" line?.
+    if(fromDist > -distEpsilon && toDist > -distEpsilon)
+    {
+        // Close enough to intercept?
+        if(fromDist < distEpsilon || toDist < distEpsilon) return RightIntercept;
+        return Right;
+    }
+
+    // To the left of "this" line?
+    if(fromDist < distEpsilon && toDist < distEpsilon)
+    {
+        // Close enough to intercept?
+        if(fromDist > -distEpsilon || toDist > -distEpsilon) return LeftIntercept;
+        return Left;
+    }
+
+    return Intersects;
+}
+
+}  // namespace bsp
+}  // namespace world
+
+#endif  // DENG_WORLD_BSP_LINERELATIONSHIP_H
@@ -32,34 +32,13 @@
 #include "HEdge"
 #include "Line"
 #include "Vertex"
-
-/// Rounding threshold within which two points are considered as co-incident.
-#define LINESEGMENT_INCIDENT_DISTANCE_EPSILON       1.0 / 128
+#include "world/bsp/linerelationship.h"
 
 namespace world {
 namespace bsp {
 
 class ConvexSubspaceProxy;
 
-/**
- * LineRelationship delineates the possible logical relationships between two
- * line (segments) in the plane.
- *
- * @ingroup bsp
- */
-enum LineRelationship
-{
-    Collinear,
-    Right,
-    RightIntercept, ///< Right vertex intercepts.
-    Left,
-    LeftIntercept,  ///< Left vertex intercepts.
-    Intersects
-};
-
-/// @todo Might be a useful global utility function? -ds
-LineRelationship lineRelationship(coord_t fromDist, coord_t toDist);
-
 /**
  * Models a finite line segment in the plane.
  *
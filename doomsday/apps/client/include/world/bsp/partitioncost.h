@@ -0,0 +1,519 @@
+/** @file partitioncost.h  Cost metric of a would-be BSP partition.
+ *
+ * Originally based on glBSP 2.24 (in turn, based on BSP 2.3)
+ * @see http://sourceforge.net/projects/glbsp/
+ *
+ * @authors Copyright © 2026 agent <agent@local>
+ * @authors Copyright © 2007-2016 Daniel Swanson <danij@dengine.net>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#ifndef DENG_WORLD_BSP_PARTITIONCOST_H
+#define DENG_WORLD_BSP_PARTITIONCOST_H
+
+#include <QVector>
+#include <de/aabox.h>
+#include <de/String>
+#include <de/Vector>
+
+#include "world/bsp/linerelationship.h"
+
+namespace world {
+namespace bsp {
+
+/// Minimum length of a half-edge post partitioning. Used in cost evaluation.
+static de::ddouble const SHORT_HEDGE_EPSILON = 4.0;
+
+/// Smallest distance between two points before being considered equal.
+static de::ddouble const DIST_EPSILON        = 1.0 / 128.0;
+
+/**
+ * Running cost metric of a partition candidate.
+ *
+ * @ingroup bsp
+ */
+struct PartitionCost
+{
+    int total     = 0;
+    int splits    = 0;
+    int iffy      = 0;
+    int nearMiss  = 0;
+    int mapRight  = 0;
+    int mapLeft   = 0;
+    int partRight = 0;
+    int partLeft  = 0;
+
+    inline PartitionCost &addSegmentRight(bool isMap)
+    {
+        if(isMap) mapRight  += 1;
+        else      partRight += 1;
+        return *this;
+    }
+
+    inline PartitionCost &addSegmentLeft(bool isMap)
+    {
+        if(isMap) mapLeft  += 1;
+        else      partLeft += 1;
+        return *this;
+    }
+
+    PartitionCost &operator += (PartitionCost const &other)
+    {
+        total     += other.total;
+        splits    += other.splits;
+        iffy      += other.iffy;
+        nearMiss  += other.nearMiss;
+        mapLeft   += other.mapLeft;
+        mapRight  += other.mapRight;
+        partLeft  += other.partLeft;
+        partRight += other.partRight;
+        return *this;
+    }
+
+    bool operator < (PartitionCost const &rhs) const
+    {
+        return total < rhs.total;
+    }
+
+    bool operator == (PartitionCost const &rhs) const
+    {
+        return total    == rhs.total    && splits    == rhs.splits    &&
+               iffy     == rhs.iffy     && nearMiss  == rhs.nearMiss  &&
+               mapRight == rhs.mapRight && mapLeft   == rhs.mapLeft   &&
+               partRight == rhs.partRight && partLeft == rhs.partLeft;
+    }
+
+    de::String asText() const
+    {
+        return de::String("PartitionCost(Total= %1.%2; splits:%3, iffy:%4, near:%5, left:%6+%7, right:%8+%9)")
+                   .arg(total / 100).arg(total % 100, 2, QChar('0'))
+                   .arg(splits).arg(iffy).arg(nearMiss)
+                   .arg(mapLeft).arg(partLeft)
+                   .arg(mapRight).arg(partRight);
+    }
+};
+
+/**
+ * "Near miss" predicate.
+ */
+inline bool partitionNearMiss(LineRelationship rel, coord_t fromDist, coord_t toDist,
+                              coord_t *distance)
+{
+    if(rel == Right &&
+       !((fromDist >= SHORT_HEDGE_EPSILON && toDist >= SHORT_HEDGE_EPSILON) ||
+         (fromDist <= DIST_EPSILON        && toDist >= SHORT_HEDGE_EPSILON) ||
+         (toDist <= DIST_EPSILON && fromDist >= SHORT_HEDGE_EPSILON)))
+    {
+        // Need to know how close?
+        if(distance)
+        {
+            if(fromDist <= DIST_EPSILON || toDist <= DIST_EPSILON)
+            {
+                *distance = SHORT_HEDGE_EPSILON / de::max(fromDist, toDist);
+            }
+            else
+            {
+                *distance = SHORT_HEDGE_EPSILON / de::min(fromDist, toDist);
+            }
+        }
+        return true;
+    }
+
+    if(rel == Left &&
+       !((fromDist <= -SHORT_HEDGE_EPSILON && toDist <= -SHORT_HEDGE_EPSILON) ||
+         (fromDist >= -DIST_EPSILON        && toDist <= -SHORT_HEDGE_EPSILON) ||
+         (toDist >= -DIST_EPSILON && fromDist <= -SHORT_HEDGE_EPSILON)))
+    {
+        // Need to know how close?
+        if(distance)
+        {
+            if(fromDist >= -DIST_EPSILON || toDist >= -DIST_EPSILON)
+            {
+                *distance = SHORT_HEDGE_EPSILON / -de::min(fromDist, toDist);
+            }
+            else
+            {
+                *distance = SHORT_HEDGE_EPSILON / -de::max(fromDist, toDist);
+            }
+        }
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * "Near edge" predicate. Assumes intersecting line segment relationship.
+ */
+inline bool partitionNearEdge(coord_t fromDist, coord_t toDist, coord_t *distance)
+{
+    if(de::abs(fromDist) < SHORT_HEDGE_EPSILON || de::abs(toDist) < SHORT_HEDGE_EPSILON)
+    {
+        // Need to know how close?
+        if(distance)
+        {
+            *distance = SHORT_HEDGE_EPSILON / de::min(de::abs(fromDist), de::abs(toDist));
+        }
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Account for one line segment in the cost of a partition.
+ *
+ * @param cost             Cost metric to update.
+ * @param splitCostFactor  Split cost multiplier.
+ * @param rel              Relationship of the line segment with the partition.
+ * @param fromDist         Distance of the segment's from vertex to the partition.
+ * @param toDist           Distance of the segment's to vertex to the partition.
+ * @param isMap            @c true= the segment is a map line segment.
+ * @param opposite         @c true= a collinear segment runs in the opposite direction.
+ */
+inline void addPartitionSegmentCost(PartitionCost &cost, int splitCostFactor,
+                                    LineRelationship rel, coord_t fromDist, coord_t toDist,
+                                    bool isMap, bool opposite)
+{
+    switch(rel)
+    {
+    case Collinear:
+        // This line segment runs along the same line as the partition.
+        if(opposite) cost.addSegmentLeft(isMap);
+        else         cost.addSegmentRight(isMap);
+        break;
+
+    case Right:
+    case RightIntercept: {
+        cost.addSegmentRight(isMap);
+
+        /*
+         * Near misses are bad, as they have the potential to result in
+         * really short line segments being produced later on.
+         *
+         * The closer the near miss, the higher the cost.
+         */
+        coord_t nearDist;
+        if(partitionNearMiss(rel, fromDist, toDist, &nearDist))
+        {
+            cost.nearMiss += 1;
+            cost.total += int( 100 * splitCostFactor * (nearDist * nearDist - 1.0) );
+        }
+        break; }
+
+    case Left:
+    case LeftIntercept: {
+        cost.addSegmentLeft(isMap);
+
+        // Near miss?
+        coord_t nearDist;
+        if(partitionNearMiss(rel, fromDist, toDist, &nearDist))
+        {
+            /// @todo Why the cost multiplier imbalance between the left
+            /// and right edge near misses?
+            cost.nearMiss += 1;
+            cost.total += int( 70 * splitCostFactor * (nearDist * nearDist - 1.0) );
+        }
+        break; }
+
+    case Intersects: {
+        cost.splits += 1;
+        cost.total  += 100 * splitCostFactor;
+
+        /*
+         * If the split point is very close to one end, which is quite an
+         * undesirable situation (producing really short edges), thus a
+         * rather hefty surcharge.
+         *
+         * The closer to the edge, the higher the cost.
+         */
+        coord_t nearDist;
+        if(partitionNearEdge(fromDist, toDist, &nearDist))
+        {
+            cost.iffy += 1;
+            cost.total += int( 140 * splitCostFactor * (nearDist * nearDist - 1.0) );
+        }
+        break; }
+    }
+}
+
+/**
+ * Complete the costing of a partition once all line segments have been accounted.
+ *
+ * @return  @c false if the partition is not suitable for use.
+ */
+inline bool finishPartitionCost(PartitionCost &cost, slopetype_t partitionSlope)
+{
+    // Make sure there is at least one map line segment on each side.
+    if(!cost.mapLeft || !cost.mapRight)
+    {
+        return false;
+    }
+
+    // This is suitable for use as a partition.
+
+    // Increase cost by the difference between left and right.
+    cost.total += 100 * de::abs(cost.mapLeft - cost.mapRight);
+
+    // Allow partition segment counts to affect the outcome.
+    cost.total += 50 * de::abs(cost.partLeft - cost.partRight);
+
+    // Another little twist, here we show a slight preference for partition
+    // lines that lie either purely horizontally or purely vertically.
+    if(partitionSlope != ST_HORIZONTAL && partitionSlope != ST_VERTICAL)
+    {
+        cost.total += 25;
+    }
+    return true;
+}
+
+/**
+ * Bounds of a block as used when testing the block against a partition.
+ *
+ * @todo Why are we extending the bounding box for this test?
+ */
+inline AABoxd partitionTestBounds(AABoxd const &blockBounds)
+{
+    return AABoxd(blockBounds.minX - SHORT_HEDGE_EPSILON * 1.5,
+                  blockBounds.minY - SHORT_HEDGE_EPSILON * 1.5,
+                  blockBounds.maxX + SHORT_HEDGE_EPSILON * 1.5,
+                  blockBounds.maxY + SHORT_HEDGE_EPSILON * 1.5);
+}
+
+/**
+ * Structure-of-arrays snapshot of the line segments in a block tree. The segments
+ * of each block are stored contiguously so that the distances of a whole block of
+ * segments to a partition can be determined in a single, vectorizable pass.
+ *
+ * @ingroup bsp
+ */
+struct PackedSegments
+{
+    struct Block
+    {
+        AABoxd bounds;     ///< Extended block bounds (cf. partitionTestBounds()).
+        int mapCount;      ///< Map line segments at/under this block.
+        int partCount;     ///< Partition line segments at/under this block.
+        int first;         ///< Index of the first segment linked to this block.
+        int count;         ///< Number of segments linked to this block.
+        int right = -1;    ///< Index of the right child block (if any).
+        int left  = -1;    ///< Index of the left child block (if any).
+    };
+    QVector<Block> blocks; ///< In pre-order (root first).
+
+    QVector<de::ddouble> fromX, fromY;
+    QVector<de::ddouble> toX, toY;
+    QVector<de::ddouble> dirX, dirY;
+    QVector<de::ddouble> length;
+    QVector<de::dbyte> slopeType;
+    QVector<de::dbyte> isMapSegment;
+    QVector<void const *> partitionLine; ///< Source map line (identity only).
+    int maxBlockCount = 0; ///< Largest number of segments linked to a block.
+
+    void reserve(int segmentCount)
+    {
+        for(QVector<de::ddouble> *vec : { &fromX, &fromY, &toX, &toY, &dirX, &dirY, &length })
+        {
+            vec->reserve(segmentCount);
+        }
+        slopeType.reserve(segmentCount);
+        isMapSegment.reserve(segmentCount);
+        partitionLine.reserve(segmentCount);
+    }
+
+    /**
+     * Adds a block. The segments linked to the block must be added next, before any
+     * other block is added. The indices of the children are set separately.
+     *
+     * @param bounds     Bounds of the block.
+     * @param mapCount   Number of map line segments at/under the block.
+     * @param partCount  Number of partition line segments at/under the block.
+     *
+     * @return  Index of the block.
+     */
+    int addBlock(AABoxd const &bounds, int mapCount, int partCount)
+    {
+        Block packed;
+        packed.bounds    = partitionTestBounds(bounds);
+        packed.mapCount  = mapCount;
+        packed.partCount = partCount;
+        packed.first     = fromX.count();
+        packed.count     = 0;
+        blocks << packed;
+        return blocks.count() - 1;
+    }
+
+    /**
+     * Adds a line segment linked to the most recently added block.
+     *
+     * @param from           Origin of the from vertex.
+     * @param to             Origin of the to vertex.
+     * @param slope          Slope type of the segment.
+     * @param isMap          @c true= the segment is a map line segment.
+     * @param sourceLine     Map line the segment was produced from (if any). Segments
+     *                       from the same line are considered collinear.
+     */
+    void addSegment(de::Vector2d const &from, de::Vector2d const &to, slopetype_t slope,
+                    bool isMap, void const *sourceLine)
+    {
+        de::Vector2d const direction = to - from;
+        fromX  << from.x;
+        fromY  << from.y;
+        toX    << to.x;
+        toY    << to.y;
+        dirX   << direction.x;
+        dirY   << direction.y;
+        length << direction.length();
+        slopeType     << de::dbyte(slope);
+        isMapSegment  << de::dbyte(isMap);
+        partitionLine << sourceLine;
+
+        Block &block = blocks.last();
+        block.count += 1;
+        maxBlockCount = de::max(maxBlockCount, block.count);
+    }
+
+    int count() const { return fromX.count(); }
+};
+
+/**
+ * Perpendicular distance of each of the @a count points to a line. Evaluated in the
+ * same manner as LineSegment::Side::distance(), so the results are identical.
+ */
+inline void pointLinePerpDistances(int count, de::ddouble const *xs, de::ddouble const *ys,
+                                   de::ddouble lineDirX, de::ddouble lineDirY,
+                                   de::ddouble linePerp, de::ddouble lineLength,
+                                   de::ddouble *distances)
+{
+    for(int i = 0; i < count; ++i)
+    {
+        distances[i] = (xs[i] * lineDirY - ys[i] * lineDirX + linePerp) / lineLength;
+    }
+}
+
+/**
+ * Evaluates the costs of partition candidates using a PackedSegments snapshot.
+ *
+ * @ingroup bsp
+ */
+class PackedCostEvaluator
+{
+public:
+    PackedCostEvaluator(PackedSegments const &segs, int splitCostFactor)
+        : _segs(segs)
+        , _splitCostFactor(splitCostFactor)
+        , _fromDist(segs.maxBlockCount)
+        , _toDist(segs.maxBlockCount)
+    {}
+
+    /**
+     * Determine the cost of partitioning with the packed segment at @a index.
+     *
+     * @return  @c false if the segment is not suitable as a partition.
+     */
+    bool evaluate(int index, PartitionCost &cost)
+    {
+        _part.fromX  = _segs.fromX.at(index);
+        _part.fromY  = _segs.fromY.at(index);
+        _part.dirX   = _segs.dirX.at(index);
+        _part.dirY   = _segs.dirY.at(index);
+        _part.perp   = _part.fromY * _part.dirX - _part.fromX * _part.dirY;
+        _part.length = _segs.length.at(index);
+        _part.line   = _segs.partitionLine.at(index);
+
+        cost = PartitionCost();
+        costForBlock(0, cost);
+        return finishPartitionCost(cost, slopetype_t(_segs.slopeType.at(index)));
+    }
+
+private:
+    void costForBlock(int blockIndex, PartitionCost &cost)
+    {
+        PackedSegments::Block const &block = _segs.blocks.at(blockIndex);
+
+        coord_t const from[2]      = { _part.fromX, _part.fromY };
+        coord_t const direction[2] = { _part.dirX,  _part.dirY  };
+        int side = M_BoxOnLineSide2(&block.bounds, from, direction, _part.perp, _part.length,
+                                    LINESEGMENT_INCIDENT_DISTANCE_EPSILON);
+        if(side > 0)
+        {
+            // Right.
+            cost.mapRight  += block.mapCount;
+            cost.partRight += block.partCount;
+            return;
+        }
+        if(side < 0)
+        {
+            // Left.
+            cost.mapLeft  += block.mapCount;
+            cost.partLeft += block.partCount;
+            return;
+        }
+
+        if(block.count)
+        {
+            costForSegments(block.first, block.count, cost);
+        }
+
+        if(block.right >= 0) costForBlock(block.right, cost);
+        if(block.left  >= 0) costForBlock(block.left,  cost);
+    }
+
+    void costForSegments(int first, int count, PartitionCost &cost)
+    {
+        de::ddouble *fromDist = _fromDist.data();
+        de::ddouble *toDist   = _toDist.data();
+
+        // Distances of the whole block of segments in one pass.
+        pointLinePerpDistances(count, _segs.fromX.constData() + first, _segs.fromY.constData() + first,
+                               _part.dirX, _part.dirY, _part.perp, _part.length, fromDist);
+        pointLinePerpDistances(count, _segs.toX.constData() + first, _segs.toY.constData() + first,
+                               _part.dirX, _part.dirY, _part.perp, _part.length, toDist);
+
+        for(int i = 0; i < count; ++i)
+        {
+            int const k = first + i;
+
+            // Segments produced from the partition's source line are always
+            // treated as collinear (cf. LineSegment::Side::distance()).
+            if(_part.line && _part.line == _segs.partitionLine.at(k))
+            {
+                fromDist[i] = toDist[i] = 0;
+            }
+
+            LineRelationship const rel = lineRelationship(fromDist[i], toDist[i]);
+            addPartitionSegmentCost(cost, _splitCostFactor, rel, fromDist[i], toDist[i],
+                                    _segs.isMapSegment.at(k),
+                                    rel == Collinear &&
+                                    _segs.dirX.at(k) * _part.dirX + _segs.dirY.at(k) * _part.dirY < 0);
+        }
+    }
+
+    PackedSegments const &_segs;
+    int _splitCostFactor;
+    struct {
+        de::ddouble fromX, fromY;
+        de::ddouble dirX, dirY;
+        de::ddouble perp, length;
+        void const *line;
+    } _part;
+    QVector<de::ddouble> _fromDist;
+    QVector<de::ddouble> _toDist;
+};
+
+}  // namespace bsp
+}  // namespace world
+
+#endif  // DENG_WORLD_BSP_PARTITIONCOST_H
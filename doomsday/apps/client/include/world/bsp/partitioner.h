@@ -24,9 +24,11 @@
 #define DENG_WORLD_BSP_PARTITIONER_H
 
 #include <QSet>
+#include <QVector>
 #include <de/Observers>
 #include <de/Vector>
 
+#include "world/bsp/partitioncost.h"
 #include "world/map.h"
 
 class Line;
@@ -37,12 +39,6 @@ namespace de { class Mesh; }
 namespace world {
 namespace bsp {
 
-/// Minimum length of a half-edge post partitioning. Used in cost evaluation.
-static de::ddouble const SHORT_HEDGE_EPSILON = 4.0;
-
-/// Smallest distance between two points before being considered equal.
-static de::ddouble const DIST_EPSILON        = 1.0 / 128.0;
-
 /**
  * World map binary space partitioner (BSP).
  *
@@ -57,6 +53,19 @@ public:
     /// Notified when an unclosed sector is first found.
     DENG2_DEFINE_AUDIENCE(UnclosedSectorFound, void unclosedSectorFound(Sector &sector, de::Vector2d const &nearPoint))
 
+    /**
+     * Sequence of the partition choices made during a build, in the order in which the
+     * subspaces are visited (pre-order, right before left). Each element identifies the
+     * map line side chosen as the partition (line index * 2 + side id), or is one of the
+     * special values below.
+     */
+    typedef QVector<de::dint32> Plan;
+
+    enum {
+        PlanConvex  = -1, ///< The subspace is convex (not partitioned).
+        PlanUnknown = -2  ///< Partition is not along any map line side (never recorded).
+    };
+
 public:
     /**
      * Construct a new binary space partitioner.
@@ -72,6 +81,17 @@ public:
      */
     void setSplitCostFactor(de::dint newFactor);
 
+    /**
+     * Set the depth of the BSP tree down to which subspaces are evaluated in parallel.
+     * After a space is divided, the partition for its left half-space is chosen in a
+     * background task while the right half-space is being built. The resultant tree is
+     * identical to one built serially: should building the right half-space modify the
+     * line segments of the left, the background choice is discarded and re-evaluated.
+     *
+     * @param newDepth  Maximum depth for parallel evaluation. Zero to disable.
+     */
+    void setParallelDepth(de::dint newDepth);
+
     /**
      * Build a new BspTree for the given geometry.
      *
@@ -88,6 +108,28 @@ public:
      */
     BspTree *makeBspTree(QSet<Line *> const &lines, de::Mesh &mesh);
 
+    /**
+     * Provide a previously recorded plan to be followed by the next makeBspTree(). As
+     * following a plan skips the costly evaluation of partition candidates, this is
+     * considerably faster than a full build. Should some part of the plan be found not
+     * to match the geometry, the choices for the subtree in question are made by
+     * evaluation as usual, while the rest of the plan is still followed.
+     *
+     * @param plan  Plan to replay. Use an empty plan to disable replay.
+     */
+    void setPlan(Plan const &plan);
+
+    /**
+     * Returns the plan describing the partition choices made during the last build.
+     */
+    Plan const &plan() const;
+
+    /**
+     * Returns @c true if the last build followed the plan provided with setPlan() from
+     * beginning to end.
+     */
+    bool planWasReplayed() const;
+
     /**
      * Retrieve the number of Segments owned by the partitioner. When the build completes
      * this number will be the total number of line segments that were produced during that
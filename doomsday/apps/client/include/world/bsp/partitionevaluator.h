@@ -21,6 +21,7 @@
 #define DENG_WORLD_BSP_PARTITIONEVALUATOR_H
 
 #include "world/bsp/superblockmap.h"
+#include <atomic>
 
 namespace world {
 namespace bsp {
@@ -32,11 +33,34 @@ namespace bsp {
  */
 class PartitionEvaluator
 {
+public:
+    /// Methods for evaluating the partition candidates.
+    enum Method {
+        /// Each candidate is costed by traversing the block tree and its line segments.
+        /// Retained as the reference implementation.
+        Reference,
+
+        /// The line segments are first packed into a structure-of-arrays snapshot and
+        /// the distances of all segments in a block are determined in one pass.
+        Packed
+    };
+
 public:
     /**
      * @param splitCostFactor  Split cost multiplier.
+     * @param concurrent       @c true= evaluate the candidates concurrently using the
+     *                         shared thread pool. Otherwise all candidates are evaluated
+     *                         in the calling thread (which may itself be a pooled task).
+     * @param method           Evaluation method. Both methods choose the same partition.
+     */
+    PartitionEvaluator(int splitCostFactor, bool concurrent = true, Method method = Packed);
+
+    /**
+     * Allows the evaluation to be abandoned from another thread. Once @a cancelled
+     * becomes @c true, the remaining candidates are skipped and choose() returns
+     * @c nullptr. Ownership of the flag is not taken.
      */
-    PartitionEvaluator(int splitCostFactor);
+    void setCancellation(std::atomic_bool const &cancelled);
 
     /**
      * Find the best line segment to use as the next partition.
@@ -47,6 +71,16 @@ public:
      */
     LineSegmentSide *choose(LineSegmentBlockTreeNode &node);
 
+    /**
+     * Determines whether @a partition can be used to divide the line segments at
+     * @a node, i.e., there is at least one map line segment on each side of it.
+     * The same criteria are applied as when choosing a partition.
+     *
+     * @param node       Block tree node containing the remaining line segments.
+     * @param partition  Map line segment to test.
+     */
+    bool isSuitable(LineSegmentBlockTreeNode &node, LineSegmentSide &partition);
+
 private:
     DENG2_PRIVATE(d)
 };
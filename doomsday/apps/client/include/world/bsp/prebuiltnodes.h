@@ -0,0 +1,93 @@
+/** @file prebuiltnodes.h  Reader for node data produced by an external node builder.
+ *
+ * @authors Copyright © 2026 agent <agent@local>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#ifndef DENG_WORLD_BSP_PREBUILTNODES_H
+#define DENG_WORLD_BSP_PREBUILTNODES_H
+
+#include <functional>
+#include <de/String>
+#include <de/Vector>
+#include <doomsday/filesys/lumpindex.h>
+
+#include "world/bsp/partitioner.h"
+
+namespace world {
+namespace bsp {
+
+/**
+ * Node tree read from the data lumps of a map, as produced by an external node builder
+ * when the map was authored. The following formats are recognized (in order of
+ * preference):
+ *
+ * - ZDBSP extended/compressed nodes (XNOD, ZNOD, XGLN, ZGLN, XGL2, ZGL2, XGL3, ZGL3),
+ * - GL_NODES (GL nodes V1 through V5),
+ * - vanilla NODES.
+ *
+ * Only the partition lines and the shape of the tree are of interest: the nodes are
+ * used to produce a Partitioner::Plan, so that the partitions of the prebuilt tree are
+ * followed instead of searching for them. All geometry is still produced by the
+ * Partitioner, therefore node data which does not match the map is harmless.
+ *
+ * @ingroup bsp
+ */
+class PrebuiltNodes
+{
+public:
+    /**
+     * Function for determining the plan identifier of the map line side which lies on
+     * the given partition line. Returns Partitioner::PlanUnknown if there is none.
+     */
+    typedef std::function<de::dint32 (de::Vector2d const &origin,
+                                      de::Vector2d const &direction)> PartitionLookupFunc;
+
+public:
+    PrebuiltNodes();
+
+    /**
+     * Read the prebuilt nodes of the map described by @a recognized (if any).
+     *
+     * @return  @c true if usable node data was found.
+     */
+    bool read(de::Id1MapRecognizer const &recognized);
+
+    /**
+     * Returns the number of (non-leaf) nodes in the tree.
+     */
+    de::dint nodeCount() const;
+
+    /**
+     * Returns a textual, human-friendly name for the format of the node data.
+     */
+    de::String formatName() const;
+
+    /**
+     * Compose a partition plan which follows the prebuilt node tree.
+     *
+     * @param lookup  Determines the map line side for each partition.
+     */
+    Partitioner::Plan makePlan(PartitionLookupFunc lookup) const;
+
+private:
+    DENG2_PRIVATE(d)
+};
+
+}  // namespace bsp
+}  // namespace world
+
+#endif  // DENG_WORLD_BSP_PREBUILTNODES_H
@@ -42,6 +42,7 @@
 #include <de/Info>
 #include <de/Log>
 #include <de/LogSink>
+#include <de/Loop>
 #include <de/NativeFont>
 #include <de/ScriptSystem>
 #include <de/TextValue>
@@ -181,12 +182,21 @@ DENG2_PIMPL(ClientApp)
 
     /**
      * Log entry sink that passes warning messages to the main window's alert
-     * notification dialog.
+     * notification dialog. The sink is written to in the log flushing thread,
+     * so the alerts are collected and raised later in the main thread.
      */
     struct LogWarningAlarm : public LogSink
     {
+        struct Alert
+        {
+            String message;
+            LogEntry::Level level;
+            bool isMapEntry;
+        };
+
         AlertMask alertMask;
         StyledLogSinkFormatter formatter;
+        LockableT<QList<Alert>> pending;
 
         LogWarningAlarm()
             : LogSink(formatter)
@@ -199,6 +209,43 @@ DENG2_PIMPL(ClientApp)
         LogSink &operator << (LogEntry const &entry)
         {
             if (alertMask.shouldRaiseAlert(entry.metadata()))
+            {
+                DENG2_GUARD(pending);
+                foreach (String msg, formatter.logEntryToTextLines(entry))
+                {
+                    pending.value << Alert { msg, entry.level(),
+                                             (entry.metadata() & LogEntry::Map) != 0 };
+                }
+            }
+            return *this;
+        }
+
+        LogSink &operator << (String const &plainText)
+        {
+            DENG2_GUARD(pending);
+            pending.value << Alert { plainText, LogEntry::Message, false };
+            return *this;
+        }
+
+        void flush()
+        {
+            {
+                DENG2_GUARD(pending);
+                if (pending.value.isEmpty()) return;
+            }
+            Loop::mainCall([this] () { raisePendingAlerts(); });
+        }
+
+        void raisePendingAlerts()
+        {
+            DENG2_ASSERT_IN_MAIN_THREAD();
+
+            QList<Alert> alerts;
+            {
+                DENG2_GUARD(pending);
+                std::swap(alerts, pending.value);
+            }
+            for (Alert const &alert : alerts)
             {
                 // Don't raise alerts if the console history is open; the
                 // warning/error will be shown there.
@@ -206,36 +253,23 @@ DENG2_PIMPL(ClientApp)
                     ClientWindow::main().taskBar().isOpen() &&
                     ClientWindow::main().taskBar().console().isLogOpen())
                 {
-                    return *this;
+                    return;
                 }
 
                 // We don't want to raise alerts about problems in id/Raven WADs,
                 // since these just have to be accepted by the user.
-                if ((entry.metadata() & LogEntry::Map) &&
-                   ClientApp::world().hasMap())
+                if (alert.isMapEntry && ClientApp::world().hasMap())
                 {
                     world::Map const &map = ClientApp::world().map();
                     if (map.hasManifest() && !map.manifest().sourceFile()->hasCustom())
                     {
-                        return *this;
+                        continue;
                     }
                 }
 
-                foreach (String msg, formatter.logEntryToTextLines(entry))
-                {
-                    ClientApp::alert(msg, entry.level());
-                }
+                ClientApp::alert(alert.message, alert.level);
             }
-            return *this;
-        }
-
-        LogSink &operator << (String const &plainText)
-        {
-            ClientApp::alert(plainText);
-            return *this;
         }
-
-        void flush() {} // not buffered
     };
 
     LogWarningAlarm logAlarm;
@@ -23,6 +23,7 @@
 #include <de/timer.h>
 #include <de/App>
 #include <de/LogBuffer>
+#include <QElapsedTimer>
 #ifdef __SERVER__
 #  include <de/TextApp>
 #endif
@@ -36,6 +37,7 @@
 
 #ifdef __SERVER__
 #  include "server/sv_def.h"
+#  include "server/sv_frame.h"
 #endif
 
 #ifdef __CLIENT__
@@ -99,6 +101,59 @@ static dint timeDeltasIndex;
 
 static dfloat realFrameTimePos;
 
+/**
+ * Time spent in each subsystem during a timedemo.
+ */
+struct TimeDemoStats
+{
+    QElapsedTimer clock;
+    dint64 spent[NUM_TIMEDEMO_SUBSYSTEMS];  ///< Nanoseconds.
+
+    TimeDemoStats()
+    {
+        for (auto &ns : spent) ns = 0;
+        clock.start();
+    }
+};
+
+static TimeDemoStats *timeDemo;  ///< Only exists while a timedemo is running.
+
+static char const *timeDemoSubsystemName(timedemosubsystem_t sub)
+{
+    static char const *names[NUM_TIMEDEMO_SUBSYSTEMS] = {
+        "Playsim",
+        "Thinkers",
+        "Game logic",
+        "InFine",
+#ifdef __CLIENT__
+        "Client",
+#else
+        "Server",
+#endif
+        "Frames",
+        "Console",
+        "Plugins",
+        "Network",
+    };
+    return names[sub];
+}
+
+/**
+ * Calls @a func, and during a timedemo also measures how long the call takes.
+ */
+template <typename Func>
+static inline void measureTime(timedemosubsystem_t sub, Func func)
+{
+    if (!::timeDemo)
+    {
+        func();
+        return;
+    }
+    dint64 const startedAt = ::timeDemo->clock.nsecsElapsed();
+    func();
+    ::timeDemo->spent[sub] += ::timeDemo->clock.nsecsElapsed() - startedAt;
+}
+
 void DD_SetGameLoopExitCode(dint code)
 {
     ::gameLoopExitCode = code;
@@ -163,18 +218,18 @@ static void baseTicker(timespan_t time)
         // Demo ticker. Does stuff like smoothing of view angles.
         Demo_Ticker(time);
 #endif
-        P_Ticker(time);
+        measureTime(TDS_PLAYSIM, [&time] () { P_Ticker(time); });
 #ifdef __CLIENT__
         FR_Ticker(time);
 #endif
 
         // InFine ticks whenever it's active.
-        App_InFineSystem().runTicks(time);
+        measureTime(TDS_INFINE, [&time] () { App_InFineSystem().runTicks(time); });
 
         // Game logic.
         if(App_GameLoaded() && gx.Ticker)
         {
-            gx.Ticker(time);
+            measureTime(TDS_GAME, [&time] () { gx.Ticker(time); });
         }
 
 #ifdef __CLIENT__
@@ -186,10 +241,10 @@ static void baseTicker(timespan_t time)
 
         if(isClient)
         {
-            Cl_Ticker(time);
+            measureTime(TDS_NETGAME, [&time] () { Cl_Ticker(time); });
         }
 #elif __SERVER__
-        Sv_Ticker(time);
+        measureTime(TDS_NETGAME, [&time] () { Sv_Ticker(time); });
 #endif
 
         if(DD_IsSharpTick())
@@ -238,17 +293,23 @@ static void baseTicker(timespan_t time)
     }
 
     // Console is always ticking.
-    Con_Ticker(time);
-    if(::tickFrame)
+    measureTime(TDS_CONSOLE, [&time] ()
     {
-        Con_TransitionTicker(time);
-    }
+        Con_Ticker(time);
+        if(::tickFrame)
+        {
+            Con_TransitionTicker(time);
+        }
+    });
 
     // Plugins tick always.
-    DoomsdayApp::plugins().callAllHooks(HOOK_TICKER, 0, &time);
+    measureTime(TDS_PLUGINS, [&time] ()
+    {
+        DoomsdayApp::plugins().callAllHooks(HOOK_TICKER, 0, &time);
+    });
 
     // The netcode gets to tick, too.
-    Net_Ticker(time);
+    measureTime(TDS_NETWORK, [&time] () { Net_Ticker(time); });
 }
 
 /**
@@ -438,10 +499,89 @@ void Loop_RunTics()
     }
 }
 
+void Loop_MeasureTime(timedemosubsystem_t sub, std::function<void ()> const &func)
+{
+    measureTime(sub, func);
+}
+
+static void printTimeDemoResults(dint tics, TimeDemoStats const &stats, ddouble elapsed)
+{
+    ddouble spent[NUM_TIMEDEMO_SUBSYSTEMS];
+    ddouble measured = 0;
+    for (dint i = 0; i < NUM_TIMEDEMO_SUBSYSTEMS; ++i)
+    {
+        spent[i] = stats.spent[i] / 1.0e9;
+    }
+    // Thinkers are run by the game logic.
+    spent[TDS_GAME] = de::max(0.0, spent[TDS_GAME] - spent[TDS_THINKERS]);
+    for (ddouble span : spent) measured += span;
+
+    LOG_MSG(_E(b) "Timedemo: %i tics in %.3f seconds (%.1f tics/sec)")
+            << tics << elapsed << (elapsed > 0? tics / elapsed : 0.0);
+    for (dint i = 0; i < NUM_TIMEDEMO_SUBSYSTEMS; ++i)
+    {
+        LOG_MSG("  %-10s %10.3f ms %8.4f ms/tic %5.1f%%")
+                << timeDemoSubsystemName(timedemosubsystem_t(i))
+                << spent[i] * 1000
+                << spent[i] * 1000 / tics
+                << (elapsed > 0? spent[i] / elapsed * 100 : 0.0);
+    }
+    LOG_MSG("  %-10s %10.3f ms") << "Other" << de::max(0.0, elapsed - measured) * 1000;
+}
+
+void Loop_RunTimeDemo(dint tics)
+{
+    LOG_AS("Loop_RunTimeDemo");
+
+    if (::timeDemo) return;
+    if (tics <= 0) return;
+
+    if (!App_World().hasMap())
+    {
+        LOG_WARNING("A map must be loaded before running a timedemo");
+        return;
+    }
+
+    LOG_MSG("Running %i tics as fast as possible...") << tics;
+
+    TimeDemoStats stats;
+    ::timeDemo = &stats;
+
+    // Every tic is a sharp one, so the outcome does not depend on how fast the
+    // tics are processed.
+    for (dint i = 0; i < tics; ++i)
+    {
+        ::ticLength = MAX_FRAME_TIME;
+        checkSharpTick(::ticLength);
+        baseTicker(::ticLength);
+#ifdef __SERVER__
+        measureTime(TDS_FRAMES, [] () { Sv_TransmitFrame(); });
+#endif
+        advanceTime(::ticLength);
+    }
+    ddouble const elapsed = stats.clock.nsecsElapsed() / 1.0e9;
+
+    ::timeDemo = nullptr;
+
+    printTimeDemoResults(tics, stats, elapsed);
+
+    // Real time kept passing meanwhile, but it should not be caught up with.
+    DD_ResetTimer();
+}
+
+D_CMD(TimeDemo)
+{
+    DENG2_UNUSED2(src, argc);
+    Loop_RunTimeDemo(String(argv[1]).toInt());
+    return true;
+}
+
 void DD_RegisterLoop()
 {
     C_VAR_BYTE("input-sharp-lateprocessing", &::processSharpEventsAfterTickers, 0, 0, 1);
     C_VAR_INT ("refresh-rate-maximum",       &::maxFrameRate, 0, 0, 1000);
     C_VAR_INT ("rend-dev-framecount",        &::rFrameCount, CVF_NO_ARCHIVE | CVF_PROTECTED, 0, 0);
     C_VAR_BYTE("rend-info-deltas-frametime", &::devShowFrameTimeDeltas, CVF_NO_ARCHIVE, 0, 1);
+
+    C_CMD_FLAGS("timedemo", "i", TimeDemo, CMDF_NO_NULLGAME);
 }
@@ -54,6 +54,7 @@
 #include <de/Log>
 #include <de/EscapeParser>
 #include <de/NativePath>
+#include <de/Observers>
 #ifdef __CLIENT__
 #  include <de/texgamma.h>
 #  include <de/DisplayMode>
@@ -1231,6 +1232,8 @@ static void initializeWithWindowReady()
         // Automatically start the server.
         N_ServerOpen();
 #endif
+
+        DD_CheckTimeDemo();
     }
     else
     {
@@ -1447,20 +1450,66 @@ static dint DD_DummyWorker(void * /*context*/)
 }
 #endif
 
-void DD_CheckTimeDemo()
+/**
+ * Runs the -timedemo benchmark once the startup map has been loaded.
+ */
+static struct TimeDemoStarter : public World::IMapChangeObserver
 {
-    static bool checked = false;
+    dint tics = 0;
+
+    void start()
+    {
+        // Let the map change complete before running any tics.
+        Loop::get().timer(0.1, [this] ()
+        {
+            Loop_RunTimeDemo(tics);
+            Sys_Quit();
+        });
+    }
+
+    void worldMapChanged() override
+    {
+        if (!App_World().hasMap()) return;
+
+        App_World().audienceForMapChange() -= this;
+        start();
+    }
+} timeDemoStarter;
 
-    if (!checked)
+void DD_CheckTimeDemo()
+{
+    if (CommandLine_Check("-timedemo")) // Timedemo mode.
     {
-        checked = true;
-        if (CommandLine_CheckWith("-timedemo", 1) || // Timedemo mode.
-            CommandLine_CheckWith("-playdemo", 1))   // Play-once mode.
+        // By default, run one minute's worth of tics.
+        dint tics = TICSPERSEC * 60;
+        if (CommandLine_CheckWith("-timedemo", 1))
         {
-            Block cmd = String("playdemo %1").arg(CommandLine_Next()).toUtf8();
-            Con_Execute(CMDS_CMDLINE, cmd.constData(), false, false);
+            String const arg = CommandLine_Next();
+            bool ok = false;
+            tics = arg.toInt(&ok);
+            if (!ok || tics <= 0)
+            {
+                LOG_ERROR("Invalid number of tics for -timedemo: \"%s\"") << arg;
+                Sys_Quit();
+                return;
+            }
+        }
+        timeDemoStarter.tics = tics;
+        if (App_World().hasMap())
+        {
+            timeDemoStarter.start();
+        }
+        else
+        {
+            // Wait until the startup map has been loaded.
+            App_World().audienceForMapChange() += timeDemoStarter;
         }
     }
+    else if (CommandLine_CheckWith("-playdemo", 1)) // Play-once mode.
+    {
+        Block cmd = String("playdemo %1").arg(CommandLine_Next()).toUtf8();
+        Con_Execute(CMDS_CMDLINE, cmd.constData(), false, false);
+    }
 }
 
 static dint DD_UpdateEngineStateWorker(void *context)
@@ -2281,6 +2330,65 @@ D_CMD(Version)
     return true;
 }
 
+D_CMD(ZoneProfile)
+{
+    DENG2_UNUSED(src);
+
+    if (argc == 1)
+    {
+        Z_PrintProfile(20);
+        return true;
+    }
+
+    String const op = String(argv[1]).toLower();
+    if (argc == 2 && (op == "on" || op == "off"))
+    {
+        Z_EnableProfiling(op == "on");
+        LOG_SCR_MSG("Memory zone profiling %s") << (op == "on"? "enabled" : "disabled");
+        return true;
+    }
+    if (argc == 2 && op == "reset")
+    {
+        Z_ResetProfile();
+        return true;
+    }
+    if (argc == 3 && op == "write")
+    {
+        NativePath const path = NativePath::workPath() / NativePath(argv[2]).expand();
+        return Z_WriteProfile(path.toUtf8().constData());
+    }
+
+    LOG_SCR_NOTE("Usage: %s (on|off|reset|write (file))") << argv[0];
+    return false;
+}
+
+D_CMD(AudienceStats)
+{
+    DENG2_UNUSED(src);
+
+    if (argc == 1)
+    {
+        AudienceStats::print(20);
+        return true;
+    }
+
+    String const op = String(argv[1]).toLower();
+    if (argc == 2 && (op == "on" || op == "off"))
+    {
+        AudienceStats::setEnabled(op == "on");
+        LOG_SCR_MSG("Audience statistics %s") << (op == "on"? "enabled" : "disabled");
+        return true;
+    }
+    if (argc == 2 && op == "reset")
+    {
+        AudienceStats::reset();
+        return true;
+    }
+
+    LOG_SCR_NOTE("Usage: %s (on|off|reset)") << argv[0];
+    return false;
+}
+
 D_CMD(Quit)
 {
     DENG2_UNUSED2(src, argc);
@@ -2463,6 +2571,8 @@ void DD_ConsoleRegister()
     C_CMD("reload",         "",     ReloadGame);
     C_CMD("unload",         "*",    Unload);
     C_CMD("write",          "s",    WriteConsole);
+    C_CMD("zoneprofile",    "*",    ZoneProfile);
+    C_CMD("audiencestats",  "*",    AudienceStats);
 
 #ifdef DENG2_DEBUG
     C_CMD("fatalerror",     nullptr,   DebugError);
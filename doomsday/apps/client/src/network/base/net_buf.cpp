@@ -27,6 +27,8 @@
 #include <de/timer.h>
 #include <de/ByteRefArray>
 #include <de/Loop>
+#include <QList>
+#include <atomic>
 
 #ifdef __CLIENT__
 #  include "network/sys_network.h"
@@ -47,16 +49,130 @@ using namespace de;
 
 #define MSG_MUTEX_NAME  "MsgQueueMutex"
 
+#define MSG_QUEUE_CAPACITY      1024  ///< Power of two.
+#define MSG_POOL_CAPACITY       256   ///< Power of two.
+
+/// Released messages with larger data buffers are not recycled.
+#define MSG_POOL_MAX_BUFFER     0x10000
+
 dd_bool allowSending;
 netbuffer_t netBuffer;
 
-// The message queue: list of incoming messages waiting for processing.
-static netmessage_t *msgHead, *msgTail;
-static dint entryCount;
+/**
+ * Bounded lock-free queue of messages. Any number of threads may push and pop
+ * concurrently. Each cell has a sequence number that tells whether it is ready
+ * for writing or for reading on the current lap around the ring.
+ */
+template <duint Capacity>
+class MessageRing
+{
+public:
+    MessageRing()
+    {
+        static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+        for(duint i = 0; i < Capacity; ++i)
+        {
+            _cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    /// @return  @c false if the ring is full.
+    bool push(netmessage_t *msg)
+    {
+        Cell *cell;
+        dsize pos = _pushPos.load(std::memory_order_relaxed);
+        for(;;)
+        {
+            cell = &_cells[pos & (Capacity - 1)];
+            dsize const seq = cell->sequence.load(std::memory_order_acquire);
+            dint64 const diff = dint64(seq) - dint64(pos);
+            if(diff == 0)
+            {
+                if(_pushPos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if(diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = _pushPos.load(std::memory_order_relaxed);
+            }
+        }
+        cell->msg = msg;
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// @return  @c nullptr if the ring is empty.
+    netmessage_t *pop()
+    {
+        Cell *cell;
+        dsize pos = _popPos.load(std::memory_order_relaxed);
+        for(;;)
+        {
+            cell = &_cells[pos & (Capacity - 1)];
+            dsize const seq = cell->sequence.load(std::memory_order_acquire);
+            dint64 const diff = dint64(seq) - dint64(pos + 1);
+            if(diff == 0)
+            {
+                if(_popPos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if(diff < 0)
+            {
+                return nullptr;
+            }
+            else
+            {
+                pos = _popPos.load(std::memory_order_relaxed);
+            }
+        }
+        netmessage_t *msg = cell->msg;
+        cell->sequence.store(pos + Capacity, std::memory_order_release);
+        return msg;
+    }
 
-// A mutex is used to protect the addition and removal of messages from
-// the message queue.
-static mutex_t msgMutex;
+private:
+    struct Cell {
+        std::atomic<dsize> sequence;
+        netmessage_t *msg = nullptr;
+    };
+    Cell _cells[Capacity];
+    std::atomic<dsize> _pushPos { 0 };
+    std::atomic<dsize> _popPos  { 0 };
+};
+
+/*
+ * The message queue: incoming messages waiting for processing. Messages are posted
+ * by any thread but only extracted in the Doomsday thread.
+ *
+ * In the unlikely event that the ring fills up, messages spill over to a list that
+ * is protected by a mutex. While the spill-over list is in use, all messages are
+ * posted there, so that the messages of each sender remain in order.
+ */
+static MessageRing<MSG_QUEUE_CAPACITY> msgQueue;
+static QList<netmessage_t *> msgSpillOver;
+static std::atomic_bool msgSpilling { false };
+static std::atomic_int msgQueueWriters;  ///< Threads currently pushing to msgQueue.
+static mutex_t msgMutex;                 ///< Protects msgSpillOver.
+
+/// Extracted message being held back due to simulated latency.
+static netmessage_t *msgDelayed;
+
+/// Released messages waiting to be reused.
+static MessageRing<MSG_POOL_CAPACITY> msgPool;
+
+// Statistics.
+static std::atomic_int entryCount;
+static std::atomic_int peakEntryCount;
+static std::atomic_uint spillCount;
+static std::atomic_uint newMessageCount;
+static std::atomic_uint reusedMessageCount;
+static duint receivedCount;
+static ddouble totalLatency;
+static ddouble maxLatency;
 
 reader_s *Reader_NewWithNetworkBuffer()
 {
@@ -79,6 +195,13 @@ void N_Shutdown()
     // Any queued messages will be destroyed.
     N_ClearMessages();
 
+    // Free the recycled messages.
+    while(netmessage_t *msg = msgPool.pop())
+    {
+        delete [] reinterpret_cast<byte *>(msg->handle);
+        M_Free(msg);
+    }
+
     N_MasterShutdown();
 
     ::allowSending = false;
@@ -88,25 +211,49 @@ void N_Shutdown()
     msgMutex = 0;
 }
 
-/**
- * Acquire or release ownership of the message queue mutex.
- *
- * @return  @c true if successful.
- */
-static dd_bool N_LockQueue(dd_bool doAcquire)
+netmessage_t *N_NewMessage(nodeid_t sender, void const *data, dsize size)
 {
-    if(doAcquire)
-        Sys_Lock(msgMutex);
+    netmessage_t *msg = msgPool.pop();
+    if(msg)
+    {
+        ::reusedMessageCount++;
+    }
     else
-        Sys_Unlock(msgMutex);
-    return true;
+    {
+        msg = (netmessage_t *) M_Calloc(sizeof(netmessage_t));
+        ::newMessageCount++;
+    }
+
+    if(msg->bufferSize < size)
+    {
+        delete [] reinterpret_cast<byte *>(msg->handle);
+        msg->handle     = new byte[size];
+        msg->bufferSize = size;
+    }
+    msg->data   = reinterpret_cast<byte *>(msg->handle);
+    msg->size   = size;
+    msg->sender = sender;
+    if(size) std::memcpy(msg->data, data, size);
+    return msg;
 }
 
-void N_PostMessage(netmessage_t *msg)
+static void N_ReleaseMessage(netmessage_t *msg)
 {
     DENG2_ASSERT(msg);
 
-    N_LockQueue(true);
+    // Keep the message (and its buffer) for reuse, if there is room.
+    if(msg->bufferSize <= MSG_POOL_MAX_BUFFER && msgPool.push(msg))
+    {
+        return;
+    }
+
+    delete [] reinterpret_cast<byte *>(msg->handle);
+    M_Free(msg);
+}
+
+void N_PostMessage(netmessage_t *msg)
+{
+    DENG2_ASSERT(msg);
 
     // This will be the latest message.
     msg->next = nullptr;
@@ -114,23 +261,55 @@ void N_PostMessage(netmessage_t *msg)
     // Set the timestamp for reception.
     msg->receivedAt = Timer_RealSeconds();
 
-    if(::msgTail)
+    dint const count = ++::entryCount;
+    dint peak = ::peakEntryCount.load();
+    while(count > peak && !::peakEntryCount.compare_exchange_weak(peak, count)) {}
+
+    ::msgQueueWriters++;
+    if(!::msgSpilling && msgQueue.push(msg))
     {
-        // There are previous messages.
-        ::msgTail->next = msg;
+        ::msgQueueWriters--;
+        return;
     }
+    ::msgQueueWriters--;
+
+    // The queue is full (or was full recently).
+    Sys_Lock(::msgMutex);
+    ::msgSpilling = true;
+    ::msgSpillOver.append(msg);
+    ::spillCount++;
+    Sys_Unlock(::msgMutex);
+}
 
-    // The tail pointer points to the last message.
-    ::msgTail = msg;
-
-    // If there is no head, this'll be the first message.
-    if(::msgHead == nullptr)
-        ::msgHead = msg;
-
-    // One new message available.
-    ::entryCount++;
+/**
+ * Takes the oldest message out of the queue.
+ */
+static netmessage_t *N_TakeMessage()
+{
+    if(netmessage_t *msg = msgQueue.pop())
+    {
+        return msg;
+    }
+    if(!::msgSpilling) return nullptr;
 
-    N_LockQueue(false);
+    netmessage_t *msg = nullptr;
+    Sys_Lock(::msgMutex);
+    // Messages still being pushed to the ring were posted before the ones that
+    // spilled over, so they must be taken first.
+    if(::msgQueueWriters == 0)
+    {
+        msg = msgQueue.pop();
+        if(!msg && !::msgSpillOver.isEmpty())
+        {
+            msg = ::msgSpillOver.takeFirst();
+        }
+        if(::msgSpillOver.isEmpty())
+        {
+            ::msgSpilling = false;
+        }
+    }
+    Sys_Unlock(::msgMutex);
+    return msg;
 }
 
 /**
@@ -138,65 +317,46 @@ void N_PostMessage(netmessage_t *msg)
  * The caller must release the message when it's no longer needed,
  * using N_ReleaseMessage().
  *
- * We use a mutex to synchronize access to the message queue. This is
- * called in the Doomsday thread.
+ * This is called in the Doomsday thread only.
  *
  * @return  @c nullptr if no message is found.
  */
 static netmessage_t *N_GetMessage()
 {
     // This is the message we'll return.
-    netmessage_t *msg = nullptr;
+    netmessage_t *msg = ::msgDelayed;
+    ::msgDelayed = nullptr;
 
-    N_LockQueue(true);
-    if(::msgHead != nullptr)
+    if(!msg)
     {
-        msg = ::msgHead;
-
-        // Check for simulated latency.
-        if(::netSimulatedLatencySeconds > 0 &&
-           (Timer_RealSeconds() - msg->receivedAt < ::netSimulatedLatencySeconds))
-        {
-            // This message has not been received yet.
-            msg = nullptr;
-        }
-        else
-        {
-            // If there are no more messages, the tail pointer must be cleared, too.
-            if(!::msgHead->next)
-                ::msgTail = nullptr;
+        msg = N_TakeMessage();
+        if(!msg) return nullptr;
+    }
 
-            // Advance the head pointer.
-            ::msgHead = ::msgHead->next;
+    ddouble const now = Timer_RealSeconds();
 
-            if(msg)
-            {
-                // One less message available.
-                ::entryCount--;
-            }
-        }
+    // Check for simulated latency.
+    if(::netSimulatedLatencySeconds > 0 &&
+       (now - msg->receivedAt < ::netSimulatedLatencySeconds))
+    {
+        // This message has not been received yet.
+        ::msgDelayed = msg;
+        return nullptr;
     }
-    N_LockQueue(false);
+
+    // One less message available.
+    ::entryCount--;
+
+    ddouble const latency = now - msg->receivedAt;
+    ::receivedCount++;
+    ::totalLatency += latency;
+    ::maxLatency = de::max(::maxLatency, latency);
 
     // Identify the sender.
-    if(msg)
-    {
-        msg->player = N_IdentifyPlayer(msg->sender);
-    }
+    msg->player = N_IdentifyPlayer(msg->sender);
     return msg;
 }
 
-static void N_ReleaseMessage(netmessage_t *msg)
-{
-    DENG2_ASSERT(msg);
-    if(msg->handle)
-    {
-        delete [] reinterpret_cast<byte *>(msg->handle);
-        msg->handle = nullptr;
-    }
-    M_Free(msg);
-}
-
 void N_ClearMessages()
 {
     if(!msgMutex) return;  // Not initialized yet.
@@ -215,7 +375,6 @@ void N_ClearMessages()
     ::netSimulatedLatencySeconds = oldSim;
 
     // The queue is now empty.
-    ::msgHead = ::msgTail = nullptr;
     ::entryCount = 0;
 }
 
@@ -360,6 +519,20 @@ void N_PrintBufferInfo()
 {
     N_PrintTransmissionStats();
 
+    duint const allocated = ::newMessageCount;
+    duint const reused    = ::reusedMessageCount;
+    LOG_NET_MSG("Message queue: %i waiting (peak %i), %i spilled over; "
+                "%i messages allocated, %i reused")
+        << dint(::entryCount) << dint(::peakEntryCount) << duint(::spillCount)
+        << allocated << reused;
+    if(::receivedCount > 0)
+    {
+        LOG_NET_MSG("Message queue latency: %.2f ms average, %.2f ms max (%i messages)")
+            << ::totalLatency / ::receivedCount * 1000
+            << ::maxLatency * 1000
+            << ::receivedCount;
+    }
+
     double const loopRate = Loop::get().rate();
     if (loopRate > 0)
     {
@@ -1321,7 +1321,10 @@ void Net_Register()
     C_VAR_BYTE2     ("server-allowjoin",        &netAllowJoin,  0, 0, 1, serverAllowJoinChanged);
     C_VAR_CHARPTR   ("server-password",         &::netPassword, 0, 0, 0);
     C_VAR_BYTE      ("server-latencies",        &::netShowLatencies, 0, 0, 1);
+    C_VAR_INT       ("server-frame-adaptive",   &::frameAdaptive, 0, 0, 1);
     C_VAR_INT       ("server-frame-interval",   &::frameInterval, CVF_NO_MAX, 0, 0);
+    C_VAR_INT       ("server-frame-parallel",   &::frameParallel, 0, 0, 1);
+    C_VAR_INT       ("server-frame-visibility", &::svVisibility, 0, 0, 1);
     C_VAR_INT       ("server-player-limit",     &::svMaxPlayers, 0, 0, DDMAXPLAYERS);
 #endif
 
@@ -54,8 +54,25 @@ void Msg_Begin(dint type)
     }
 
     // Allocate a new writer.
-    ::msgWriter = Writer_NewWithDynamicBuffer(1 /*type*/ + NETBUFFER_MAXSIZE);
-    Writer_WriteByte(::msgWriter, type);
+    ::msgWriter = Msg_NewWriter(type);
+}
+
+Writer1 *Msg_NewWriter(dint type)
+{
+    Writer1 *writer = Writer_NewWithDynamicBuffer(1 /*type*/ + NETBUFFER_MAXSIZE);
+    Writer_WriteByte(writer, type);
+    return writer;
+}
+
+void Msg_EndWriter(Writer1 *writer)
+{
+    DENG2_ASSERT(writer);
+
+    // Finalize the netbuffer.
+    // Message type is included as the first byte.
+    ::netBuffer.length = Writer_Size(writer) - 1 /*type*/;
+    std::memcpy(&::netBuffer.msg, Writer_Data(writer), Writer_Size(writer));
+    Writer_Delete(writer);
 }
 
 dd_bool Msg_BeingWritten()
@@ -67,11 +84,7 @@ void Msg_End()
 {
     DENG2_ASSERT(::msgWriter);
 
-    // Finalize the netbuffer.
-    // Message type is included as the first byte.
-    ::netBuffer.length = Writer_Size(::msgWriter) - 1 /*type*/;
-    std::memcpy(&::netBuffer.msg, Writer_Data(::msgWriter), Writer_Size(::msgWriter));
-    Writer_Delete(::msgWriter);
+    Msg_EndWriter(::msgWriter);
     ::msgWriter = 0;
 
     // Pop a pending writer off the stack.
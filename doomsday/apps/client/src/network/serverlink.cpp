@@ -43,7 +43,6 @@
 #include <de/RecordValue>
 #include <de/Socket>
 #include <de/data/json.h>
-#include <de/memory.h>
 #include <de/shell/ServerFinder>
 #include <doomsday/DoomsdayApp>
 #include <doomsday/Games>
@@ -84,6 +83,7 @@ DENG2_PIMPL(ServerLink)
     std::function<void (Address, GameProfile const *)> profileResultCallbackWithAddress;
     shell::PackageDownloader downloader;
     LoopCallback deferred; // for deferred actions
+    bool streamCompressionRequested = false;
 
     Impl(Public *i, Flags flags)
         : Base(i)
@@ -219,6 +219,12 @@ DENG2_PIMPL(ServerLink)
         // Clients are allowed to send packets to the server.
         state = InGame;
 
+        if (streamCompressionRequested)
+        {
+            // The server has agreed to use stream compression.
+            self().socket()->enableStreamCompression();
+        }
+
         handshakeReceived = false;
         allowSending = true;
         netGame = true;             // Allow sending/receiving of packets.
@@ -705,7 +711,16 @@ void ServerLink::initiateCommunications()
         {
             pName = "Player";
         }
-        String req = String("Join %1 %2").arg(SV_VERSION, 4, 16, QChar('0')).arg(pName);
+        // Ask for stream compression if the server supports it.
+        shell::ServerInfo svInfo;
+        d->streamCompressionRequested =
+                foundServerInfo(address(), svInfo) &&
+                svInfo.flags().testFlag(shell::ServerInfo::StreamCompression);
+
+        String req = String("Join%1 %2 %3")
+                .arg(d->streamCompressionRequested? "+stream" : "")
+                .arg(SV_VERSION, 4, 16, QChar('0'))
+                .arg(pName);
         *this << req.toUtf8();
 
         d->state = WaitingForJoinResponse;
@@ -781,16 +796,8 @@ void ServerLink::handleIncomingPackets()
             /// @todo The incoming packets should be handled immediately.
 
             // Post the data into the queue.
-            netmessage_t *msg = reinterpret_cast<netmessage_t *>(M_Calloc(sizeof(netmessage_t)));
-
-            msg->sender = 0; // the server
-            msg->data = new byte[packetData.size()];
-            memcpy(msg->data, packetData.data(), packetData.size());
-            msg->size = packetData.size();
-            msg->handle = msg->data; // needs delete[]
-
             // The message queue will handle the message from now on.
-            N_PostMessage(msg);
+            N_PostMessage(N_NewMessage(0 /* the server */, packetData.data(), packetData.size()));
             break; }
 
         default:
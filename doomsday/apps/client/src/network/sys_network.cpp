@@ -55,6 +55,12 @@ void N_PrintNetworkStatus(void)
     if (isClient)
     {
         LOG_NET_NOTE(_E(b) "CLIENT: " _E(.) "Connected to server at %s") << Net_ServerLink().address();
+        if (Socket const *socket = Net_ServerLink().socket())
+        {
+            LOG_NET_MSG("Compression%s: %s")
+                    << (socket->isStreamCompressionEnabled()? " (stream)" : "")
+                    << socket->compressionStats().asText();
+        }
     }
     else
     {
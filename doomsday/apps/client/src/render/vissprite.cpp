@@ -21,6 +21,7 @@
  */
 
 #include "render/vissprite.h"
+#include "render/visspritesort.h"
 
 #include "clientapp.h"
 
@@ -41,6 +42,8 @@ vissprite_t visSprSortedHead;
 
 static vissprite_t overflowVisSprite;
 
+static VisSpriteSortKey visSpriteSortKeys[MAXVISSPRITES];
+
 void R_ClearVisSprites()
 {
     visSpriteP = visSprites;
@@ -123,51 +126,8 @@ void R_SortVisSprites()
     dint const count = visSpriteP - visSprites;
     if(count <= 0) return;
 
-    vissprite_t unsorted;
-    unsorted.next = unsorted.prev = &unsorted;
-
-    for(vissprite_t *ds = visSprites; ds < visSpriteP; ds++)
-    {
-        ds->next = ds + 1;
-        ds->prev = ds - 1;
-    }
-    visSprites[0].prev = &unsorted;
-    unsorted.next = &visSprites[0];
-    (visSpriteP - 1)->next = &unsorted;
-    unsorted.prev = visSpriteP - 1;
-
-    // Pull the vissprites out by distance.
-    visSprSortedHead.next = visSprSortedHead.prev = &visSprSortedHead;
-
-    /// @todo Optimize:
-    /// Profile results from nuts.wad show over 25% of total execution time
-    /// was spent sorting vissprites (nuts.wad map01 is a perfect pathological
-    /// test case).
-    ///
-    /// Rather than try to speed up the sort, it would make more sense to
-    /// actually construct the vissprites in z order if it can be done in
-    /// linear time.
-
-    vissprite_t *best = nullptr;
-    for(dint i = 0; i < count; ++i)
-    {
-        ddouble bestdist = 0;
-        for(vissprite_t *ds = unsorted.next; ds != &unsorted; ds = ds->next)
-        {
-            if(ds->pose.distance >= bestdist)
-            {
-                bestdist = ds->pose.distance;
-                best = ds;
-            }
-        }
-
-        best->next->prev = best->prev;
-        best->prev->next = best->next;
-        best->next = &visSprSortedHead;
-        best->prev = visSprSortedHead.prev;
-        visSprSortedHead.prev->next = best;
-        visSprSortedHead.prev = best;
-    }
+    VisSprite_SortByDistance(visSprites, count, visSprSortedHead, visSpriteSortKeys,
+                             [] (vissprite_t const &spr) { return spr.pose.distance; });
 }
 
 void VisEntityLighting::setupLighting(Vector3d const &origin, ddouble distance,
@@ -278,25 +278,6 @@ dint const MapConversionReporter::maxWarningsPerType = 10;
 
 dd_bool ddMapSetup;
 
-// Should we be caching successfully loaded maps?
-//static byte mapCache = true; // cvar
-
-static char const *mapCacheDir = "mapcache/";
-
-/// Determine the identity key for maps loaded from the specified @a sourcePath.
-static String cacheIdForMap(String const &sourcePath)
-{
-    DENG2_ASSERT(!sourcePath.isEmpty());
-
-    dushort id = 0;
-    for (dint i = 0; i < sourcePath.size(); ++i)
-    {
-        id ^= sourcePath.at(i).unicode() << ((i * 3) % 11);
-    }
-
-    return String("%1").arg(id, 4, 16);
-}
-
 DENG2_PIMPL(ClientServerWorld)
 {
     Binder binder;               ///< Doomsday Script bindings for the World.
@@ -338,26 +319,6 @@ DENG2_PIMPL(ClientServerWorld)
 #endif
     }
 
-    /**
-     * Compose the relative path (relative to the runtime directory) to the
-     * directory of the cache where maps from this source (e.g., the add-on
-     * which contains the map) will reside.
-     *
-     * @param sourcePath  Path to the primary resource file (the source) for
-     *                    the original map data.
-     *
-     * @return  The composed path.
-     */
-    static Path cachePath(String sourcePath)
-    {
-        if (sourcePath.isEmpty()) return String();
-
-        // Compose the final path.
-        return mapCacheDir + App_CurrentGame().id()
-               / sourcePath.fileNameWithoutExtension()
-               + '-' + cacheIdForMap(sourcePath);
-    }
-
     /**
      * Attempt JIT conversion of the map data with the help of a plugin. Note that
      * the map is left in an editable state in case the caller wishes to perform
@@ -407,37 +368,6 @@ DENG2_PIMPL(ClientServerWorld)
         return MPE_TakeMap();
     }
 
-#if 0
-    /**
-     * Returns @c true iff data for the map is available in the cache.
-     */
-    bool haveCachedMap(res::MapManifest &mapManifest)
-    {
-        // Disabled?
-        if (!mapCache) return false;
-        return DAM_MapIsValid(mapManifest.cachePath, mapManifest.id());
-    }
-
-    /**
-     * Attempt to load data for the map from the cache.
-     *
-     * @see isCachedDataAvailable()
-     *
-     * @return  @c true if loading completed successfully.
-     */
-    Map *loadMapFromCache(MapManifest &mapManifest)
-    {
-        Uri const mapUri = mapManifest.composeUri();
-        Map *map = DAM_MapRead(mapManifest.cachePath);
-        if (!map)
-            /// Failed to load the map specified from the data cache.
-            throw Error("loadMapFromCache", "Failed loading map \"" + mapUri.asText() + "\" from cache");
-
-        map->_uri = mapUri;
-        return map;
-    }
-#endif
-
     /**
      * Attempt to load the associated map data.
      *
@@ -447,16 +377,8 @@ DENG2_PIMPL(ClientServerWorld)
     {
         LOG_AS("ClientServerWorld::loadMap");
 
-        /*if (mapManifest.lastLoadAttemptFailed && !forceRetry)
-            return nullptr;
-
-        // Load from cache?
-        if (haveCachedMap(mapManifest))
-        {
-            return loadMapFromCache(mapManifest);
-        }*/
-
-        // Try a JIT conversion with the help of a plugin.
+        // Try a JIT conversion with the help of a plugin. Note that the map's BSP is
+        // rebuilt following a cached partition plan when available (see Map).
         Map *map = convertMap(mapManifest, reporter);
         if (!map)
         {
@@ -478,16 +400,6 @@ DENG2_PIMPL(ClientServerWorld)
         // We cannot make an editable map current.
         DENG2_ASSERT(!map->isEditable());
 
-        // Should we cache this map?
-        /*if (mapCache && !haveCachedMap(&map->def()))
-        {
-            // Ensure the destination directory exists.
-            F_MakePath(map->def().cachePath.toUtf8().constData());
-
-            // Cache the map!
-            DAM_MapWrite(map);
-        }*/
-
 #ifdef __CLIENT__
         // Connect the map to world audiences:
         /// @todo The map should instead be notified when it is made current
@@ -979,7 +891,6 @@ void ClientServerWorld::endFrame()
 
 void ClientServerWorld::consoleRegister()  // static
 {
-    //C_VAR_BYTE ("map-cache", &mapCache, 0, 0, 1);
 #ifdef __CLIENT__
     //C_VAR_FLOAT("edit-bias-grab-distance", &handDistance, 0, 10, 1000);
 #endif
@@ -32,6 +32,9 @@
 #  include "render/r_main.h"  // levelFullBright
 #  include "render/rend_fakeradio.h"
 #endif
+#ifdef __SERVER__
+#  include "server/sv_pool.h"
+#endif
 
 #include "Face"
 #include "HEdge"
@@ -632,6 +635,9 @@ dint Line::Side::flags() const
 void Line::Side::setFlags(dint flagsToChange, FlagOp operation)
 {
     applyFlagOperation(d->flags, flagsToChange, operation);
+#ifdef __SERVER__
+    Sv_MapElementChanged(*this);
+#endif
 }
 
 void Line::Side::chooseSurfaceColors(dint sectionId, Vector3f const **topColor,
@@ -1160,6 +1166,9 @@ void Line::setFlags(dint flagsToChange, FlagOp operation)
     {
         dint oldFlags = d->flags;
         d->flags = newFlags;
+#ifdef __SERVER__
+        Sv_MapElementChanged(*this);
+#endif
 
         // Notify interested parties of the change.
         DENG2_FOR_AUDIENCE(FlagsChange, i) i->lineFlagsChanged(*this, oldFlags);
@@ -35,6 +35,7 @@
 #endif
 
 #include "world/bsp/partitioner.h"
+#include "world/bsp/prebuiltnodes.h"
 #include "world/clientserverworld.h"  // ddMapSetup, validCount
 #include "world/blockmap.h"
 #include "world/lineblockmap.h"
@@ -70,15 +71,23 @@
 #  include "render/rend_main.h"
 #  include "render/rend_particle.h"
 #endif
+#ifdef __SERVER__
+#  include "server/sv_pool.h"
+#endif
 
 #include <doomsday/defs/mapinfo.h>
 #include <doomsday/defs/sky.h>
+#include <doomsday/filesys/file.h>
 #include <doomsday/EntityDatabase>
 #include <doomsday/BspNode>
 #include <doomsday/world/Materials>
 
 #include <de/LogBuffer>
+#include <de/MetadataBank>
+#include <de/Reader>
 #include <de/Rectangle>
+#include <de/Version>
+#include <de/Writer>
 
 #include <de/aabox.h>
 #include <de/charsymbols.h>
@@ -88,12 +97,19 @@
 
 #include <array>
 #include <QBitArray>
+#include <QCryptographicHash>
 #include <QMultiMap>
 #include <QVarLengthArray>
 
 using namespace de;
 
 static dint bspSplitFactor = 7;  ///< cvar
+static dbyte bspCache = true;    ///< cvar: Reuse the partition plans of earlier builds.
+static dint bspParallelDepth = 4; ///< cvar: BSP depth for parallel partition evaluation.
+static dbyte bspPrebuilt = true;  ///< cvar: Follow the partitions of prebuilt nodes.
+
+/// Metadata cache category for recorded BSP partition plans.
+static String const BSP_CACHE_CATEGORY = "Partitioner";
 
 #ifdef __CLIENT__
 #if 0
@@ -562,9 +578,156 @@ DENG2_PIMPL(Map)
         }
     }
 
+    /**
+     * Determine the identity key of this map's BSP in the metadata cache. The key changes
+     * whenever the source data lumps, the engine build, or the split cost factor change.
+     *
+     * @return  Cache key, or an empty block if the map has no source data.
+     */
+    Block bspCacheId() const
+    {
+        if (!self().hasManifest() || !self().manifest().sourceFile())
+            return Block();
+
+        QCryptographicHash hash(QCryptographicHash::Md5);
+        hash.addData(Version::currentBuild().asHumanReadableText().toUtf8());
+        hash.addData(Version::currentBuild().gitDescription.toUtf8());
+        hash.addData(String::number(bspSplitFactor).toUtf8());
+
+        auto const &lumps = self().manifest().recognizer().lumps();
+        for (auto it = lumps.constBegin(); it != lumps.constEnd(); ++it)
+        {
+            File1 &lump = *it.value();
+            Block data(lump.size());
+            lump.read(data.data(), true /*try the cache*/);
+            hash.addData(String::number(dint(it.key())).toUtf8());
+            hash.addData(data);
+        }
+        return hash.result();
+    }
+
+    bsp::Partitioner::Plan readCachedBspPlan(Block const &cacheId, dint lineCount) const
+    {
+        bsp::Partitioner::Plan plan;
+        try
+        {
+            if (Block cached = MetadataBank::get().check(BSP_CACHE_CATEGORY, cacheId))
+            {
+                cached = cached.decompressed();
+                Reader reader(cached);
+                reader.withHeader();
+
+                duint32 numLines, count;
+                reader >> numLines >> count;
+                if (dint(numLines) != lineCount)
+                {
+                    // Not for this geometry.
+                    return plan;
+                }
+                plan.resize(dint(count));
+                for (dint32 &planId : plan)
+                {
+                    reader >> planId;
+                }
+            }
+        }
+        catch (Error const &er)
+        {
+            LOGDEV_MAP_WARNING("Corrupt cached BSP plan: %s") << er.asText();
+            plan.clear();
+        }
+        return plan;
+    }
+
+    void writeCachedBspPlan(Block const &cacheId, dint lineCount,
+                            bsp::Partitioner::Plan const &plan) const
+    {
+        Block data;
+        Writer writer(data);
+        writer.withHeader() << duint32(lineCount) << duint32(plan.count());
+        for (dint32 planId : plan)
+        {
+            writer << planId;
+        }
+        MetadataBank::get().setMetadata(BSP_CACHE_CATEGORY, cacheId, data.compressed());
+    }
+
+    /**
+     * Determine the plan identifier of the line side along which a prebuilt partition
+     * lies. A node builder partitions along one of its line segments, which begins at
+     * @a origin; therefore the line sought passes through the origin and extends from
+     * there in the direction of the partition.
+     *
+     * @pre A line blockmap has been constructed.
+     */
+    dint32 planIdForPartition(Vector2d const &origin, Vector2d const &direction) const
+    {
+        // Vanilla nodes have vertex coordinates rounded to integers.
+        static ddouble const EPSILON = 1.5;
+
+        ddouble const length = direction.length();
+        if (length < EPSILON) return bsp::Partitioner::PlanUnknown;
+        Vector2d const unit = direction / length;
+
+        dint32 planId = bsp::Partitioner::PlanUnknown;
+        AABoxd const box(origin.x - EPSILON, origin.y - EPSILON,
+                         origin.x + EPSILON, origin.y + EPSILON);
+        validCount++;
+        self().forAllLinesInBox(box, LIF_SECTOR, [&origin, &unit, &planId] (Line &line)
+        {
+            if (line.definesPolyobj()) return LoopContinue;
+
+            // Both vertexes must lie on the partition line.
+            Vector2d const from = line.from().origin() - origin;
+            Vector2d const to   = line.to  ().origin() - origin;
+            if (de::abs(unit.x * from.y - unit.y * from.x) > EPSILON ||
+                de::abs(unit.x * to.y   - unit.y * to.x  ) > EPSILON)
+            {
+                return LoopContinue;
+            }
+
+            // The line must extend forward from the origin.
+            ddouble const fromPos = unit.dot(from);
+            ddouble const toPos   = unit.dot(to);
+            if (de::min(fromPos, toPos) > EPSILON || de::max(fromPos, toPos) < EPSILON)
+            {
+                return LoopContinue;
+            }
+
+            planId = line.indexInMap() * 2 + (fromPos > toPos? Line::Back : Line::Front);
+            return LoopAbort;
+        });
+        return planId;
+    }
+
+    /**
+     * Compose a partition plan from the nodes included with the map data by the author's
+     * node builder (if any).
+     */
+    bsp::Partitioner::Plan planFromPrebuiltNodes() const
+    {
+        if (!self().hasManifest()) return bsp::Partitioner::Plan();
+
+        bsp::PrebuiltNodes nodes;
+        if (!nodes.read(self().manifest().recognizer()))
+            return bsp::Partitioner::Plan();
+
+        LOGDEV_MAP_VERBOSE("Following %i prebuilt nodes (%s)")
+                << nodes.nodeCount() << nodes.formatName();
+
+        return nodes.makePlan([this] (Vector2d const &origin, Vector2d const &direction)
+        {
+            return planIdForPartition(origin, direction);
+        });
+    }
+
     /**
      * Build a new BSP tree.
      *
+     * If a partition plan for the same source data was recorded by an earlier build it is
+     * replayed, skipping the costly partition candidate evaluation. Failing that, the
+     * partitions of any prebuilt nodes in the map data are followed.
+     *
      * @pre Map line bounds have been determined and a line blockmap constructed.
      */
     bool buildBspTree()
@@ -600,12 +763,39 @@ DENG2_PIMPL(Map)
         {
             // Configure a space partitioner.
             bsp::Partitioner partitioner(bspSplitFactor);
+            partitioner.setParallelDepth(bspParallelDepth);
             partitioner.audienceForUnclosedSectorFound += this;
 
+            // Maybe we have built this BSP before?
+            Block const cacheId = (bspCache? bspCacheId() : Block());
+            bsp::Partitioner::Plan plan;
+            if (!cacheId.isEmpty())
+            {
+                plan = readCachedBspPlan(cacheId, linesToBuildFor.count());
+            }
+            bool const planIsCached = !plan.isEmpty();
+            if (!planIsCached && bspPrebuilt)
+            {
+                // Maybe the map comes with nodes?
+                plan = planFromPrebuiltNodes();
+            }
+            partitioner.setPlan(plan);
+
             // Build a new BSP tree.
             bsp.tree = partitioner.makeBspTree(linesToBuildFor, mesh);
             DENG2_ASSERT(bsp.tree);
 
+            if (partitioner.planWasReplayed())
+            {
+                LOGDEV_MAP_VERBOSE("BSP built following the %s partition plan")
+                        << (planIsCached? "cached" : "prebuilt");
+            }
+            if (!cacheId.isEmpty() && !(planIsCached && partitioner.planWasReplayed()))
+            {
+                // Remember the choices made for next time.
+                writeCachedBspPlan(cacheId, linesToBuildFor.count(), partitioner.plan());
+            }
+
             LOG_MAP_VERBOSE("BSP built: %s. With %d Segments and %d Vertexes.")
                     << bsp.tree->summary()
                     << partitioner.segmentCount()
@@ -2572,6 +2762,10 @@ void Map::link(mobj_t &mob, dint flags)
         d->linkMobjToLines(mob);
     }
 
+#ifdef __SERVER__
+    Sv_MobjChanged(mob);
+#endif
+
 #ifdef __CLIENT__
     // If this is a player - perform additional tests to see if they have either entered or exited the void.
     if (mob.dPlayer && mob.dPlayer->mo)
@@ -3547,7 +3741,10 @@ void Map::consoleRegister() // static
     Mobj_ConsoleRegister();
     Sector::consoleRegister();
 
+    C_VAR_BYTE("bsp-cache",                 &bspCache,       0, 0, 1);
     C_VAR_INT("bsp-factor",                 &bspSplitFactor, CVF_NO_MAX, 0, 0);
+    C_VAR_INT("bsp-parallel",               &bspParallelDepth, 0, 0, 16);
+    C_VAR_BYTE("bsp-prebuilt",              &bspPrebuilt,    0, 0, 1);
 #if 0
 #ifdef __CLIENT__
     C_VAR_INT("rend-bias-grid-multisample", &lgMXSample,     0, 0, 7);
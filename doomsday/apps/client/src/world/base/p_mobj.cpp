@@ -53,6 +53,10 @@
 #  include "render/billboard.h"
 #endif
 
+#ifdef __SERVER__
+#  include "server/sv_pool.h"
+#endif
+
 #include "world/clientserverworld.h" // validCount
 #include "world/p_object.h"
 #include "world/p_players.h"
@@ -132,6 +136,9 @@ mobj_t *P_MobjCreate(thinkfunc_t function, Vector3d const &origin, angle_t angle
     mob->thinker.function = function;
     Mobj_Map(*mob).thinkers().add(mob->thinker);
 
+#ifdef __SERVER__
+    Sv_MobjChanged(*mob);
+#endif
     return mob;
 }
 
@@ -193,6 +200,10 @@ DENG_EXTERN_C void Mobj_SetState(mobj_t *mob, int statenum)
     mob->sprite = mob->state->sprite;
     mob->frame  = mob->state->frame;
 
+#ifdef __SERVER__
+    Sv_MobjChanged(*mob);
+#endif
+
     if (!(mob->ddFlags & DDMF_REMOTE))
     {
         String const exec = DED_Definitions()->states[statenum].gets("execute");
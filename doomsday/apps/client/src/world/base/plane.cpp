@@ -32,6 +32,9 @@
 
 #include "dd_loop.h"  // frameTimePos
 #include "dd_main.h"  // App_Resources()
+#ifdef __SERVER__
+#  include "server/sv_pool.h"
+#endif
 
 #ifdef __CLIENT__
 #  include <doomsday/world/materialmanifest.h>
@@ -67,7 +70,11 @@ DENG2_PIMPL(Plane)
         : Base(i)
         , surface(dynamic_cast<MapElement &>(*i))
     {
+        // Map elements are only modified in the main thread.
+        audienceForHeightChange.setSynchronization(HeightChangeAudience::SingleThreaded);
 #ifdef __CLIENT__
+        audienceForHeightSmoothedChange.setSynchronization(HeightSmoothedChangeAudience::SingleThreaded);
+
         surface.audienceForMaterialChange() += this;
 #endif
     }
@@ -108,6 +115,10 @@ DENG2_PIMPL(Plane)
             self().updateSoundEmitterOrigin();
         }
 
+#ifdef __SERVER__
+        Sv_MapElementChanged(self());
+#endif
+
         notifyHeightChanged();
 
 #ifdef __CLIENT__
@@ -482,9 +493,15 @@ dint Plane::setProperty(DmuArgs const &args)
         break; }
     case DMU_TARGET_HEIGHT:
         args.value(DMT_PLANE_TARGET, &d->heightTarget, 0);
+#ifdef __SERVER__
+        Sv_MapElementChanged(*this);
+#endif
         break;
     case DMU_SPEED:
         args.value(DMT_PLANE_SPEED, &d->speed, 0);
+#ifdef __SERVER__
+        Sv_MapElementChanged(*this);
+#endif
         break;
     default:
         return MapElement::setProperty(args);
@@ -29,6 +29,9 @@
 #include "Surface"
 
 #include "dd_main.h"  // App_World()
+#ifdef __SERVER__
+#  include "server/sv_pool.h"
+#endif
 
 #include <doomsday/console/cmd.h>
 #include <de/LogBuffer>
@@ -497,6 +500,9 @@ void Sector::setLightLevel(dfloat newLightLevel)
     if (!de::fequal(d->lightLevel, newLightLevel))
     {
         d->lightLevel = newLightLevel;
+#ifdef __SERVER__
+        Sv_MapElementChanged(*this);
+#endif
         DENG2_FOR_AUDIENCE2(LightLevelChange, i) i->sectorLightLevelChanged(*this);
     }
 }
@@ -512,6 +518,9 @@ void Sector::setLightColor(Vector3f const &newLightColor)
     if (d->lightColor != newColorClamped)
     {
         d->lightColor = newColorClamped;
+#ifdef __SERVER__
+        Sv_MapElementChanged(*this);
+#endif
         DENG2_FOR_AUDIENCE2(LightColorChange, i) i->sectorLightColorChanged(*this);
     }
 }
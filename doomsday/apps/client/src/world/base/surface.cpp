@@ -38,6 +38,9 @@
 
 #  include <doomsday/resource/texturemanifest.h>
 #endif
+#ifdef __SERVER__
+#  include "server/sv_pool.h"
+#endif
 #include <doomsday/world/MaterialManifest>
 #include <doomsday/world/Material>
 #include <de/Log>
@@ -84,7 +87,17 @@ DENG2_PIMPL(Surface)
 #endif
 
     Impl(Public *i) : Base(i)
-    {}
+    {
+        // Map elements are only modified in the main thread.
+        audienceForColorChange   .setSynchronization(ColorChangeAudience::SingleThreaded);
+        audienceForMaterialChange.setSynchronization(MaterialChangeAudience::SingleThreaded);
+        audienceForNormalChange  .setSynchronization(NormalChangeAudience::SingleThreaded);
+        audienceForOpacityChange .setSynchronization(OpacityChangeAudience::SingleThreaded);
+        audienceForOriginChange  .setSynchronization(OriginChangeAudience::SingleThreaded);
+#ifdef __CLIENT__
+        audienceForOriginSmoothedChange.setSynchronization(OriginSmoothedChangeAudience::SingleThreaded);
+#endif
+    }
 
 #ifdef __CLIENT__
     ~Impl()
@@ -265,6 +278,9 @@ Surface &Surface::setMaterial(Material *newMaterial, bool isMissingFix)
 #ifdef __CLIENT__
     d->matAnimator = nullptr;
 #endif
+#ifdef __SERVER__
+    Sv_MapElementChanged(*this);
+#endif
 
     // Notify interested parties.
     DENG2_FOR_AUDIENCE2(MaterialChange, i)
@@ -346,6 +362,9 @@ Surface &Surface::setOpacity(dfloat newOpacity)
     if (!de::fequal(d->opacity, newOpacity))
     {
         d->opacity = newOpacity;
+#ifdef __SERVER__
+        Sv_MapElementChanged(*this);
+#endif
         DENG2_FOR_AUDIENCE2(OpacityChange, i) i->surfaceOpacityChanged(*this);
     }
     return *this;
@@ -365,6 +384,9 @@ Surface &Surface::setColor(Vector3f const &newColor)
     if (d->color != newColorClamped)
     {
         d->color = newColorClamped;
+#ifdef __SERVER__
+        Sv_MapElementChanged(*this);
+#endif
         DENG2_FOR_AUDIENCE2(ColorChange, i) i->surfaceColorChanged(*this);
     }
     return *this;
@@ -377,7 +399,13 @@ blendmode_t Surface::blendMode() const
 
 Surface &Surface::setBlendMode(blendmode_t newBlendMode)
 {
-    d->blendMode = newBlendMode;
+    if (d->blendMode != newBlendMode)
+    {
+        d->blendMode = newBlendMode;
+#ifdef __SERVER__
+        Sv_MapElementChanged(*this);
+#endif
+    }
     return *this;
 }
 
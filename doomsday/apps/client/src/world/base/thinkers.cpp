@@ -490,12 +490,8 @@ void Thinker_Init()
     App_World().map().thinkers().initLists(0x1);  // Init the public thinker lists.
 }
 
-#undef Thinker_Run
-void Thinker_Run()
+static void runThinkers()
 {
-    /// @todo fixme: Do not assume the current map.
-    if (!App_World().hasMap()) return;
-
     App_World().map().thinkers().forAll(0x1 | 0x2, [] (thinker_t *th)
     {
         try
@@ -538,6 +534,15 @@ void Thinker_Run()
     });
 }
 
+#undef Thinker_Run
+void Thinker_Run()
+{
+    /// @todo fixme: Do not assume the current map.
+    if (!App_World().hasMap()) return;
+
+    Loop_MeasureTime(TDS_THINKERS, runThinkers);
+}
+
 #undef Thinker_Add
 void Thinker_Add(thinker_t *th)
 {
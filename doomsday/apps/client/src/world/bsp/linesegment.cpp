@@ -277,35 +277,6 @@ void LineSegment::Side::distance(LineSegment::Side const &other, coord_t *fromDi
     }
 }
 
-LineRelationship lineRelationship(coord_t fromDist, coord_t toDist)
-{
-    static coord_t const distEpsilon = LINESEGMENT_INCIDENT_DISTANCE_EPSILON;
-
-    // Collinear with "this" line?
-    if(de::abs(fromDist) <= distEpsilon && de::abs(toDist) <= distEpsilon)
-    {
-        return Collinear;
-    }
-
-    // To the right of "this" line?.
-    if(fromDist > -distEpsilon && toDist > -distEpsilon)
-    {
-        // Close enough to intercept?
-        if(fromDist < distEpsilon || toDist < distEpsilon) return RightIntercept;
-        return Right;
-    }
-
-    // To the left of "this" line?
-    if(fromDist < distEpsilon && toDist < distEpsilon)
-    {
-        // Close enough to intercept?
-        if(fromDist > -distEpsilon || toDist > -distEpsilon) return LeftIntercept;
-        return Left;
-    }
-
-    return Intersects;
-}
-
 LineRelationship LineSegment::Side::relationship(LineSegment::Side const &other,
     coord_t *retFromDist, coord_t *retToDist) const
 {
@@ -25,11 +25,14 @@
 #include "world/bsp/partitioner.h"
 
 #include <algorithm>
+#include <atomic>
+#include <memory>
 #include <QHash>
 #include <QList>
 #include <QtAlgorithms>
 #include <de/vector1.h>
 #include <de/LogBuffer>
+#include <de/TaskGroup>
 #include <doomsday/BspNode>
 
 #include "BspLeaf"
@@ -59,6 +62,7 @@ typedef QHash<Vertex *, EdgeTips>  EdgeTipSetMap;
 DENG2_PIMPL(Partitioner)
 {
     int splitCostFactor = 7;     ///< Cost of splitting a line segment.
+    int parallelDepth = 0;       ///< Depth limit for parallel partition evaluation.
 
     Lines lines;                 ///< Set of map lines to build from (in index order, not owned).
     Mesh *mesh = nullptr;        ///< Provider of map geometries (cf. Factory).
@@ -73,6 +77,25 @@ DENG2_PIMPL(Partitioner)
     BspTree *bspRoot = nullptr;  ///< The BSP tree under construction.
     HPlane hplane;               ///< Current space half-plane (partitioner state).
 
+    /**
+     * Partition choice being made in the background for a subspace that has not yet
+     * been reached by the build.
+     */
+    struct Speculation
+    {
+        TaskGroup tasks;
+        LineSegmentSide *choice = nullptr;
+        std::atomic_bool cancelled { false }; ///< Evaluation should be abandoned.
+        bool stale = false;      ///< Subspace was modified after evaluation began.
+    };
+    typedef QHash<LineSegmentBlockTreeNode *, Speculation *> Speculations;
+    Speculations speculations;   ///< Keyed by block tree root node (owned).
+
+    Plan plan;                   ///< Partition choices made during the build.
+    Plan replayPlan;             ///< Partition choices to be replayed (if any).
+    int replayPos = 0;           ///< Position of the next choice in replayPlan.
+    int replayMismatches = 0;    ///< Number of planned subtrees not matching the geometry.
+
     struct LineSegmentBlockTree
     {
         LineSegmentBlockTreeNode *rootNode;
@@ -102,7 +125,11 @@ DENG2_PIMPL(Partitioner)
     };
 
     Impl(Public *i) : Base(i) {}
-    ~Impl() { clear(); }
+    ~Impl()
+    {
+        DENG2_ASSERT(speculations.isEmpty());
+        clear();
+    }
 
     static int clearBspElementWorker(BspTree &subtree, void *)
     {
@@ -129,6 +156,9 @@ DENG2_PIMPL(Partitioner)
         subspaces.clear();
         edgeTipSets.clear();
         hplane.clearIntercepts();
+        plan.clear();
+        replayPos        = 0;
+        replayMismatches = 0;
 
         segmentCount = vertexCount = 0;
     }
@@ -313,6 +343,12 @@ DENG2_PIMPL(Partitioner)
         //LOG_DEBUG("Splitting line segment %p at %s")
         //        << &frontLeft << point.asText();
 
+        // The twin may belong to a subspace being evaluated in the background.
+        if(auto *twinNode = (LineSegmentBlockTreeNode *)frontLeft.back().blockTreeNodePtr())
+        {
+            invalidateSpeculation(blockTreeRoot(*twinNode));
+        }
+
         Vertex *newVert = makeVertex(point);
 
         LineSegment &oldSeg = frontLeft.line();
@@ -839,11 +875,222 @@ DENG2_PIMPL(Partitioner)
         return bounds;
     }
 
-    LineSegmentSide *choosePartition(LineSegmentBlockTreeNode &candidateSet)
+    /**
+     * Begin choosing the partition for the subspace at @a rootNode in the background.
+     * The candidates are evaluated concurrently in a group nested in the speculation
+     * task, so the left subspace is costed on the whole thread pool alongside the
+     * building of the right subtree.
+     */
+    void beginSpeculation(LineSegmentBlockTreeNode &rootNode)
+    {
+        DENG2_ASSERT(!speculations.contains(&rootNode));
+
+        auto *spec = new Speculation;
+        speculations.insert(&rootNode, spec);
+
+        int const costFactor = splitCostFactor;
+        spec->tasks.start([spec, &rootNode, costFactor] ()
+        {
+            PartitionEvaluator evaluator(costFactor);
+            evaluator.setCancellation(spec->cancelled);
+            spec->choice = evaluator.choose(rootNode);
+        });
+    }
+
+    /**
+     * Cancel the background evaluation of the subspace at @a rootNode (if any) and mark
+     * the result stale. Must be done before the line segments of the subspace are
+     * modified. Only the candidates already being costed are waited for.
+     */
+    void invalidateSpeculation(LineSegmentBlockTreeNode &rootNode)
+    {
+        if(Speculation *spec = speculations.value(&rootNode))
+        {
+            spec->cancelled = true;
+            spec->tasks.wait();
+            spec->stale = true;
+        }
+    }
+
+    /**
+     * Conclude the background evaluation of the subspace at @a rootNode (if any).
+     *
+     * @param choice  The chosen partition is written here, if the result is usable.
+     *
+     * @return @c true if a usable choice was made.
+     */
+    bool endSpeculation(LineSegmentBlockTreeNode &rootNode, LineSegmentSide **choice = nullptr)
+    {
+        Speculation *spec = speculations.take(&rootNode);
+        if(!spec) return false;
+
+        spec->tasks.wait();
+        bool const usable = !spec->stale;
+        if(usable && choice) *choice = spec->choice;
+        delete spec;
+        return usable;
+    }
+
+    /**
+     * Ensures the background evaluation of a subspace is concluded before the block
+     * tree of the subspace is destroyed.
+     */
+    struct SpeculationGuard
+    {
+        Impl &d;
+        LineSegmentBlockTreeNode &rootNode;
+
+        SpeculationGuard(Impl &d, LineSegmentBlockTreeNode &rootNode)
+            : d(d), rootNode(rootNode) {}
+        ~SpeculationGuard() { d.endSpeculation(rootNode); }
+    };
+
+    static LineSegmentBlockTreeNode &blockTreeRoot(LineSegmentBlockTreeNode &node)
+    {
+        LineSegmentBlockTreeNode *root = &node;
+        while(root->parentPtr()) root = root->parentPtr();
+        return *root;
+    }
+
+    static dint32 planIdForSegment(LineSegmentSide const &seg)
+    {
+        DENG2_ASSERT(seg.hasMapSide());
+        return seg.mapSide().line().indexInMap() * 2 + seg.mapSide().sideId();
+    }
+
+    /**
+     * Skip over the remaining elements of a planned subtree, the first element of which
+     * (@a planId) has already been consumed.
+     */
+    void skipPlannedSubtree(dint32 planId)
+    {
+        int pending = (planId == PlanConvex? 0 : 2);
+        while(pending > 0 && replayPos < replayPlan.count())
+        {
+            pending += (replayPlan.at(replayPos++) == PlanConvex? -1 : 1);
+        }
+    }
+
+    /**
+     * Locate the line segment with the given plan identifier in the candidate set.
+     * Candidates are considered in the same order as PartitionEvaluator does, so the
+     * first segment of the line side is the one found.
+     */
+    static LineSegmentSide *findPlannedPartition(LineSegmentBlockTreeNode &candidateSet,
+                                                 dint32 planId)
+    {
+        // Iterative pre-order traversal.
+        LineSegmentBlockTreeNode const *cur  = &candidateSet;
+        LineSegmentBlockTreeNode const *prev = nullptr;
+        while(cur)
+        {
+            while(cur)
+            {
+                for(LineSegmentSide *seg : cur->userData()->all())
+                {
+                    if(seg->hasMapSide() && planIdForSegment(*seg) == planId)
+                        return seg;
+                }
+
+                if(prev == cur->parentPtr())
+                {
+                    // Descending - right first, then left.
+                    prev = cur;
+                    if(cur->hasRight()) cur = cur->rightPtr();
+                    else                cur = cur->leftPtr();
+                }
+                else if(prev == cur->rightPtr())
+                {
+                    // Last moved up the right branch - descend the left.
+                    prev = cur;
+                    cur = cur->leftPtr();
+                }
+                else if(prev == cur->leftPtr())
+                {
+                    // Last moved up the left branch - continue upward.
+                    prev = cur;
+                    cur = cur->parentPtr();
+                }
+            }
+
+            if(prev)
+            {
+                // No left child - back up.
+                cur = prev->parentPtr();
+            }
+        }
+        return nullptr;
+    }
+
+    LineSegmentSide *evaluatePartition(LineSegmentBlockTreeNode &candidateSet) const
     {
         return PartitionEvaluator(splitCostFactor).choose(candidateSet);
     }
 
+    /**
+     * @param followPlan  @c true= the subspace is described by the next element of the
+     *                    plan. Cleared if the plan is found not to match the geometry, in
+     *                    which case the rest of the subtree must be chosen by evaluation.
+     */
+    LineSegmentSide *choosePartition(LineSegmentBlockTreeNode &candidateSet, bool &followPlan)
+    {
+        LineSegmentSide *partSeg = nullptr;
+
+        // Perhaps the choice has already been made in the background?
+        if(endSpeculation(candidateSet, &partSeg))
+        {
+            plan << (partSeg? planIdForSegment(*partSeg) : dint32(PlanConvex));
+            return partSeg;
+        }
+
+        // Are we following a plan?
+        if(followPlan)
+        {
+            if(replayPos < replayPlan.count())
+            {
+                dint32 const planId = replayPlan.at(replayPos++);
+                if(planId == PlanConvex)
+                {
+                    // Confirm that the subspace really is convex. Evaluation is cheap here
+                    // as only a handful of line segments remain by this point.
+                    if(!(partSeg = evaluatePartition(candidateSet)))
+                    {
+                        plan << PlanConvex;
+                        return nullptr;
+                    }
+
+                    LOGDEV_MAP_XVERBOSE("Planned convex subspace needs partitioning", "");
+                    replayMismatches += 1;
+                    followPlan = false;
+                    plan << planIdForSegment(*partSeg);
+                    return partSeg;
+                }
+
+                // The planned partition must still have map line segments on both sides,
+                // or the resulting subspaces would be degenerate.
+                if(planId >= 0 && (partSeg = findPlannedPartition(candidateSet, planId)) != nullptr &&
+                   PartitionEvaluator(splitCostFactor, false /*serially*/).isSuitable(candidateSet, *partSeg))
+                {
+                    plan << planId;
+                    return partSeg;
+                }
+
+                LOGDEV_MAP_XVERBOSE("Planned partition %i not usable; reverting to evaluation")
+                        << planId;
+                skipPlannedSubtree(planId);
+            }
+
+            // Either the plan does not match or it ran out before the build did. The
+            // rest of this subtree is chosen by evaluation.
+            replayMismatches += 1;
+            followPlan = false;
+        }
+
+        partSeg = evaluatePartition(candidateSet);
+        plan << (partSeg? planIdForSegment(*partSeg) : dint32(PlanConvex));
+        return partSeg;
+    }
+
     /**
      * Takes the line segment list and determines if it is convex, possibly
      * converting it into a BSP leaf. Otherwise, the list is divided into two
@@ -859,12 +1106,14 @@ DENG2_PIMPL(Partitioner)
      * If the line segments on the right side are convex create another leaf
      * else put the line segments into the right list.
      *
-     * @param node  Tree node for the block containing the line segments to
-     *              be partitioned.
+     * @param node        Tree node for the block containing the line segments to
+     *                    be partitioned.
+     * @param depth       Depth of the subtree in the BSP.
+     * @param followPlan  @c true= follow the partition plan for this subtree.
      *
      * @return  Newly created BSP subtree; otherwise @c nullptr (degenerate).
      */
-    BspTree *partitionSpace(LineSegmentBlockTreeNode &node)
+    BspTree *partitionSpace(LineSegmentBlockTreeNode &node, int depth = 0, bool followPlan = false)
     {
         LOG_AS("Partitioner::partitionSpace");
 
@@ -873,7 +1122,7 @@ DENG2_PIMPL(Partitioner)
         BspTree *leftBspTree   = nullptr;
 
         // Pick a line segment to use as the next partition plane.
-        if(LineSegmentSide *partSeg = choosePartition(node))
+        if(LineSegmentSide *partSeg = choosePartition(node, followPlan))
         {
             // Reconfigure the half-plane for the next round of partitioning.
             hplane.configure(*partSeg);
@@ -911,9 +1160,18 @@ DENG2_PIMPL(Partitioner)
             //AABoxd rightBounds = segmentBounds(rightTree);
             //AABoxd leftBounds  = segmentBounds(leftTree);
 
+            // Choose the partition for the left space while the right is being built.
+            std::unique_ptr<SpeculationGuard> guard;
+            if(depth < parallelDepth && !followPlan &&
+               static_cast<LineSegmentBlockTreeNode &>(leftTree).userData()->totalCount())
+            {
+                beginSpeculation(leftTree);
+                guard.reset(new SpeculationGuard(*this, leftTree));
+            }
+
             // Recurse on each suspace, first the right space then left.
-            rightBspTree = partitionSpace(rightTree);
-            leftBspTree  = partitionSpace(leftTree);
+            rightBspTree = partitionSpace(rightTree, depth + 1, followPlan);
+            leftBspTree  = partitionSpace(leftTree,  depth + 1, followPlan);
 
             // Collapse degenerates upward.
             if(!rightBspTree || !leftBspTree)
@@ -1105,6 +1363,11 @@ void Partitioner::setSplitCostFactor(int newFactor)
     d->splitCostFactor = newFactor;
 }
 
+void Partitioner::setParallelDepth(int newDepth)
+{
+    d->parallelDepth = de::max(0, newDepth);
+}
+
 static AABox blockmapBounds(AABoxd const &mapBounds)
 {
     AABox mapBoundsi;
@@ -1165,7 +1428,7 @@ BspTree *Partitioner::makeBspTree(QSet<Line *> const &lines, Mesh &mesh)
 
     d->createInitialLineSegments(blockTree);
 
-    d->bspRoot = d->partitionSpace(blockTree);
+    d->bspRoot = d->partitionSpace(blockTree, 0, !d->replayPlan.isEmpty());
 
     // At this point we know that *something* useful was built.
     d->splitOverlappingSegments();
@@ -1174,6 +1437,22 @@ BspTree *Partitioner::makeBspTree(QSet<Line *> const &lines, Mesh &mesh)
     return d->bspRoot;
 }
 
+void Partitioner::setPlan(Plan const &plan)
+{
+    d->replayPlan = plan;
+}
+
+Partitioner::Plan const &Partitioner::plan() const
+{
+    return d->plan;
+}
+
+bool Partitioner::planWasReplayed() const
+{
+    return !d->replayPlan.isEmpty() && !d->replayMismatches
+           && d->replayPos == d->replayPlan.count();
+}
+
 int Partitioner::segmentCount()
 {
     return d->segmentCount;
@@ -24,12 +24,13 @@
 #include "world/bsp/partitionevaluator.h"
 
 #include <QList>
+#include <QSet>
+#include <QVector>
+#include <de/aabox.h>
 #include <de/Log>
 #include <de/String>
-#include <de/Task>
-#include <de/TaskPool>
+#include <de/TaskGroup>
 #include "world/bsp/partitioner.h"
-#include "world/clientserverworld.h" // validCount
 
 using namespace de;
 
@@ -38,137 +39,54 @@ namespace bsp {
 
 namespace internal
 {
-    struct PartitionCost
+    /**
+     * Packs the line segments of a block tree into a PackedSegments snapshot.
+     * The source segments are recorded in the same order.
+     */
+    struct SegmentPacker
     {
-        int total     = 0;
-        int splits    = 0;
-        int iffy      = 0;
-        int nearMiss  = 0;
-        int mapRight  = 0;
-        int mapLeft   = 0;
-        int partRight = 0;
-        int partLeft  = 0;
-
-        inline PartitionCost &addSegmentRight(LineSegmentSide const &seg)
-        {
-            if(seg.hasMapSide()) mapRight  += 1;
-            else                 partRight += 1;
-            return *this;
-        }
-
-        inline PartitionCost &addSegmentLeft(LineSegmentSide const &seg)
-        {
-            if(seg.hasMapSide()) mapLeft  += 1;
-            else                 partLeft += 1;
-            return *this;
-        }
+        PackedSegments segs;
+        QVector<LineSegmentSide *> sides;
 
-        PartitionCost &operator += (PartitionCost const &other)
+        SegmentPacker(LineSegmentBlockTreeNode const &rootNode)
         {
-            total     += other.total;
-            splits    += other.splits;
-            iffy      += other.iffy;
-            nearMiss  += other.nearMiss;
-            mapLeft   += other.mapLeft;
-            mapRight  += other.mapRight;
-            partLeft  += other.partLeft;
-            partRight += other.partRight;
-            return *this;
-        }
+            int const total = rootNode.userData()->totalCount();
+            segs.reserve(total);
+            sides.reserve(total);
 
-        PartitionCost &operator = (PartitionCost const &other)
-        {
-            total     = other.total;
-            splits    = other.splits;
-            iffy      = other.iffy;
-            nearMiss  = other.nearMiss;
-            mapLeft   = other.mapLeft;
-            mapRight  = other.mapRight;
-            partLeft  = other.partLeft;
-            partRight = other.partRight;
-            return *this;
+            pack(rootNode);
         }
 
-        bool operator < (PartitionCost const &rhs) const
+        /// Packs the block at @a node and its children (right first) in pre-order.
+        int pack(LineSegmentBlockTreeNode const &node)
         {
-            return total < rhs.total;
-        }
+            LineSegmentBlock const &block = *node.userData();
+            AABox const &bounds = block.bounds();
 
-        String asText() const
-        {
-            return String("PartitionCost(Total= %1.%2; splits:%3, iffy:%4, near:%5, left:%6+%7, right:%8+%9)")
-                       .arg(total / 100).arg(total % 100, 2, QChar('0'))
-                       .arg(splits).arg(iffy).arg(nearMiss)
-                       .arg(mapLeft).arg(partLeft)
-                       .arg(mapRight).arg(partRight);
-        }
-    };
-
-    /**
-     * "Near miss" predicate.
-     */
-    static bool nearMiss(LineRelationship rel, coord_t fromDist, coord_t toDist,
-                         coord_t *distance)
-    {
-        if(rel == Right &&
-           !((fromDist >= SHORT_HEDGE_EPSILON && toDist >= SHORT_HEDGE_EPSILON) ||
-             (fromDist <= DIST_EPSILON        && toDist >= SHORT_HEDGE_EPSILON) ||
-             (toDist <= DIST_EPSILON && fromDist >= SHORT_HEDGE_EPSILON)))
-        {
-            // Need to know how close?
-            if(distance)
+            int const index = segs.addBlock(AABoxd(coord_t( bounds.minX ), coord_t( bounds.minY ),
+                                                   coord_t( bounds.maxX ), coord_t( bounds.maxY )),
+                                            block.mapCount(), block.partCount());
+            for(LineSegmentSide *seg : block.all())
             {
-                if(fromDist <= DIST_EPSILON || toDist <= DIST_EPSILON)
-                {
-                    *distance = SHORT_HEDGE_EPSILON / de::max(fromDist, toDist);
-                }
-                else
-                {
-                    *distance = SHORT_HEDGE_EPSILON / de::min(fromDist, toDist);
-                }
+                segs.addSegment(seg->from().origin(), seg->to().origin(), seg->slopeType(),
+                                seg->hasMapSide(), seg->partitionMapLine());
+                sides << seg;
             }
-            return true;
-        }
 
-        if(rel == Left &&
-           !((fromDist <= -SHORT_HEDGE_EPSILON && toDist <= -SHORT_HEDGE_EPSILON) ||
-             (fromDist >= -DIST_EPSILON        && toDist <= -SHORT_HEDGE_EPSILON) ||
-             (toDist >= -DIST_EPSILON && fromDist <= -SHORT_HEDGE_EPSILON)))
-        {
-            // Need to know how close?
-            if(distance)
+            // Note: packing a child may reallocate the block array.
+            if(node.hasRight())
             {
-                if(fromDist >= -DIST_EPSILON || toDist >= -DIST_EPSILON)
-                {
-                    *distance = SHORT_HEDGE_EPSILON / -de::min(fromDist, toDist);
-                }
-                else
-                {
-                    *distance = SHORT_HEDGE_EPSILON / -de::max(fromDist, toDist);
-                }
+                int const right = pack(*node.rightPtr());
+                segs.blocks[index].right = right;
             }
-            return true;
-        }
-
-        return false;
-    }
-
-    /**
-     * "Near edge" predicate. Assumes intersecting line segment relationship.
-     */
-    static bool nearEdge(coord_t fromDist, coord_t toDist, coord_t *distance)
-    {
-        if(de::abs(fromDist) < SHORT_HEDGE_EPSILON || de::abs(toDist) < SHORT_HEDGE_EPSILON)
-        {
-            // Need to know how close?
-            if(distance)
+            if(node.hasLeft())
             {
-                *distance = SHORT_HEDGE_EPSILON / de::min(de::abs(fromDist), de::abs(toDist));
+                int const left = pack(*node.leftPtr());
+                segs.blocks[index].left = left;
             }
-            return true;
+            return index;
         }
-        return false;
-    }
+    };
 }
 
 using namespace internal;
@@ -176,6 +94,9 @@ using namespace internal;
 DENG2_PIMPL_NOREF(PartitionEvaluator)
 {
     int splitCostFactor = 7;
+    bool concurrent = true;
+    Method method = Packed;
+    std::atomic_bool const *cancelled = nullptr;
 
     LineSegmentBlockTreeNode *rootNode = nullptr; ///< Current block tree root node.
 
@@ -192,12 +113,12 @@ DENG2_PIMPL_NOREF(PartitionEvaluator)
 
     PartitionCandidate *nextCandidate()
     {
-        DENG2_ASSERT(costTaskPool.isDone());
+        DENG2_ASSERT(costTasks.isDone());
         if(candidates.isEmpty()) return nullptr;
         return candidates.takeFirst();
     }
 
-    class CostTask : public Task
+    class CostTask
     {
     public:
         Impl &evaluator;
@@ -216,115 +137,35 @@ DENG2_PIMPL_NOREF(PartitionEvaluator)
          */
         void runTask()
         {
-            LineSegmentSide **partition = &candidate.line;
-            PartitionCost &cost         = candidate.cost;
-
-            costForBlock(*evaluator.rootNode);
-
-            // Make sure there is at least one map line segment on each side.
-            if(!cost.mapLeft || !cost.mapRight)
+            if(evaluator.isCancelled())
             {
-                //LOG_DEBUG("evaluate: No map line segments on %s%sside")
-                //        << (cost.mapLeft ? "" : "left ")
-                //        << (cost.mapRight? "" : "right ");
-                *partition = nullptr;
+                candidate.line = nullptr;
                 return;
             }
 
-            // This is suitable for use as a partition.
-
-            // Increase cost by the difference between left and right.
-            cost.total += 100 * de::abs(cost.mapLeft - cost.mapRight);
-
-            // Allow partition segment counts to affect the outcome.
-            cost.total += 50 * de::abs(cost.partLeft - cost.partRight);
+            costForBlock(*evaluator.rootNode);
 
-            // Another little twist, here we show a slight preference for partition
-            // lines that lie either purely horizontally or purely vertically.
-            if((*partition)->slopeType() != ST_HORIZONTAL &&
-               (*partition)->slopeType() != ST_VERTICAL)
+            if(!finishPartitionCost(candidate.cost, candidate.line->slopeType()))
             {
-                cost.total += 25;
+                // Not suitable.
+                candidate.line = nullptr;
             }
         }
 
     private:
         void costForSegment(LineSegmentSide const &seg)
         {
-            LineSegmentSide **partition = &candidate.line;
-            PartitionCost &cost         = candidate.cost;
-            int const splitCostFactor   = evaluator.splitCostFactor;
+            LineSegmentSide const &partition = *candidate.line;
 
             /// Determine the relationship between @a seg and the partition plane.
             coord_t fromDist, toDist;
-            LineRelationship rel = seg.relationship(**partition, &fromDist, &toDist);
-            switch(rel)
-            {
-            case Collinear: {
-                // This line segment runs along the same line as the partition.
-                // Check whether it goes in the same direction or the opposite.
-                if(seg.direction().dot((*partition)->direction()) < 0)
-                {
-                    cost.addSegmentLeft(seg);
-                }
-                else
-                {
-                    cost.addSegmentRight(seg);
-                }
-                break; }
-
-            case Right:
-            case RightIntercept: {
-                cost.addSegmentRight(seg);
-
-                /*
-                 * Near misses are bad, as they have the potential to result in
-                 * really short line segments being produced later on.
-                 *
-                 * The closer the near miss, the higher the cost.
-                 */
-                coord_t nearDist;
-                if(nearMiss(rel, fromDist, toDist, &nearDist))
-                {
-                    cost.nearMiss += 1;
-                    cost.total += int( 100 * splitCostFactor * (nearDist * nearDist - 1.0) );
-                }
-                break; }
-
-            case Left:
-            case LeftIntercept: {
-                cost.addSegmentLeft(seg);
-
-                // Near miss?
-                coord_t nearDist;
-                if(nearMiss(rel, fromDist, toDist, &nearDist))
-                {
-                    /// @todo Why the cost multiplier imbalance between the left
-                    /// and right edge near misses?
-                    cost.nearMiss += 1;
-                    cost.total += int( 70 * splitCostFactor * (nearDist * nearDist - 1.0) );
-                }
-                break; }
-
-            case Intersects: {
-                cost.splits += 1;
-                cost.total  += 100 * splitCostFactor;
-
-                /*
-                 * If the split point is very close to one end, which is quite an
-                 * undesirable situation (producing really short edges), thus a
-                 * rather hefty surcharge.
-                 *
-                 * The closer to the edge, the higher the cost.
-                 */
-                coord_t nearDist;
-                if(nearEdge(fromDist, toDist, &nearDist))
-                {
-                    cost.iffy += 1;
-                    cost.total += int( 140 * splitCostFactor * (nearDist * nearDist - 1.0) );
-                }
-                break; }
-            }
+            LineRelationship rel = seg.relationship(partition, &fromDist, &toDist);
+
+            // A collinear segment may run in the same direction or the opposite.
+            addPartitionSegmentCost(candidate.cost, evaluator.splitCostFactor, rel,
+                                    fromDist, toDist, seg.hasMapSide(),
+                                    rel == Collinear &&
+                                    seg.direction().dot(partition.direction()) < 0);
         }
 
         /**
@@ -338,14 +179,13 @@ DENG2_PIMPL_NOREF(PartitionEvaluator)
             LineSegmentSide const *partition = candidate.line;
             PartitionCost &cost              = candidate.cost;
 
-            /// @todo Why are we extending the bounding box for this test? Also,
-            /// there is no need to convert from integer to floating-point each
+            /// @todo There is no need to convert from integer to floating-point each
             /// time this is tested. (If we intend to do this with floating-point
             /// then we should return that representation in SuperBlock::bounds() ).
-            AABoxd bounds(coord_t( block.bounds().minX ) - SHORT_HEDGE_EPSILON * 1.5,
-                          coord_t( block.bounds().minY ) - SHORT_HEDGE_EPSILON * 1.5,
-                          coord_t( block.bounds().maxX ) + SHORT_HEDGE_EPSILON * 1.5,
-                          coord_t( block.bounds().maxY ) + SHORT_HEDGE_EPSILON * 1.5);
+            AABoxd bounds = partitionTestBounds(AABoxd(coord_t( block.bounds().minX ),
+                                                       coord_t( block.bounds().minY ),
+                                                       coord_t( block.bounds().maxX ),
+                                                       coord_t( block.bounds().maxY )));
 
             int side = partition->boxOnSide(bounds);
             if(side > 0)
@@ -378,7 +218,12 @@ DENG2_PIMPL_NOREF(PartitionEvaluator)
             }
         }
     };
-    TaskPool costTaskPool;
+    TaskGroup costTasks;
+
+    inline bool isCancelled() const
+    {
+        return cancelled && cancelled->load(std::memory_order_relaxed);
+    }
 
     /**
      * @param line  Partition line to evaluate.
@@ -389,25 +234,126 @@ DENG2_PIMPL_NOREF(PartitionEvaluator)
         // Run a new partition cost task.
         PartitionCandidate *newCandidate = new PartitionCandidate(*line);
         candidates << newCandidate;
-        costTaskPool.start(new CostTask(*this, *newCandidate));
+        if(concurrent)
+        {
+            costTasks.start([this, newCandidate] ()
+            {
+                CostTask(*this, *newCandidate).runTask();
+            });
+        }
+        else
+        {
+            CostTask(*this, *newCandidate).runTask();
+        }
+    }
+
+    /**
+     * Choose the best partition using a packed snapshot of the line segments.
+     * Candidates are considered in the same order as with the Reference method.
+     */
+    LineSegmentSide *choosePacked(LineSegmentBlockTreeNode const &node) const
+    {
+        SegmentPacker const packer(node);
+        PackedSegments const &segs = packer.segs;
+
+        // Determine the candidates. Only the first map line segment produced from a
+        // given line is tested because they are all collinear.
+        QVector<int> candidateIndices;
+        QSet<Line const *> testedLines;
+        for(int i = 0; i < segs.count(); ++i)
+        {
+            if(!segs.isMapSegment.at(i)) continue;
+
+            Line const *line = &packer.sides.at(i)->mapLine();
+            if(testedLines.contains(line)) continue;
+
+            testedLines.insert(line);
+            candidateIndices << i;
+        }
+
+        int const candidateCount = candidateIndices.count();
+        if(!candidateCount) return nullptr;
+
+        QVector<PartitionCost> costs(candidateCount);
+        QVector<dbyte> suitable(candidateCount);
+
+        int const *indices    = candidateIndices.constData();
+        PartitionCost *costAt = costs.data();
+        dbyte *suitableAt     = suitable.data();
+        int const costFactor  = splitCostFactor;
+        auto evaluateRange = [this, &segs, indices, costAt, suitableAt, costFactor] (int begin, int end)
+        {
+            PackedCostEvaluator evaluator(segs, costFactor);
+            for(int k = begin; k < end; ++k)
+            {
+                suitableAt[k] = !isCancelled() && evaluator.evaluate(indices[k], costAt[k]);
+            }
+        };
+
+        if(concurrent && candidateCount > 1)
+        {
+            // Evaluate ranges of candidates in parallel.
+            parallelFor(0, candidateCount, evaluateRange);
+        }
+        else
+        {
+            evaluateRange(0, candidateCount);
+        }
+        if(isCancelled()) return nullptr;
+
+        LineSegmentSide *best = nullptr;
+        PartitionCost bestCost;
+        for(int k = 0; k < candidateCount; ++k)
+        {
+            if(suitable.at(k) && (!best || costs.at(k) < bestCost))
+            {
+                // We have a new better choice.
+                best     = packer.sides.at(indices[k]);
+                bestCost = costs.at(k);
+            }
+        }
+        return best;
     }
 };
 
-PartitionEvaluator::PartitionEvaluator(int splitCostFactor) : d(new Impl)
+PartitionEvaluator::PartitionEvaluator(int splitCostFactor, bool concurrent, Method method)
+    : d(new Impl)
 {
     d->splitCostFactor = splitCostFactor;
+    d->concurrent      = concurrent;
+    d->method          = method;
+}
+
+void PartitionEvaluator::setCancellation(std::atomic_bool const &cancelled)
+{
+    d->cancelled = &cancelled;
+}
+
+bool PartitionEvaluator::isSuitable(LineSegmentBlockTreeNode &node, LineSegmentSide &partition)
+{
+    DENG2_ASSERT(partition.hasMapSide());
+
+    d->rootNode = &node;
+    Impl::PartitionCandidate candidate(partition);
+    Impl::CostTask(*d, candidate).runTask();
+    return candidate.line != nullptr;
 }
 
 LineSegmentSide *PartitionEvaluator::choose(LineSegmentBlockTreeNode &node)
 {
     LOG_AS("PartitionEvaluator");
 
+    if(d->method == Packed)
+    {
+        return d->choosePacked(node);
+    }
+
     d->rootNode = &node;
 
-    // Increment valid count so we can avoid testing the line segments
-    // produced from a single line more than once per round of partition
-    // selection.
-    validCount++;
+    // Lines whose segments have already been tested during this round of partition
+    // selection. (A local set rather than Line::validCount, as several evaluations
+    // may be in progress concurrently.)
+    QSet<Line const *> testedLines;
 
     // Iterative pre-order traversal.
     LineSegmentBlockTreeNode const *cur  = d->rootNode;
@@ -434,11 +380,11 @@ LineSegmentSide *PartitionEvaluator::choose(LineSegmentBlockTreeNode &node)
                 // Optimization: Only the first line segment produced from a
                 // given line is tested per round of partition costing because
                 // they are all collinear.
-                if(candidate->mapLine().validCount() == validCount)
+                if(testedLines.contains(&candidate->mapLine()))
                     continue; // Skip this.
 
                 // Don't consider further segments of the candidate.
-                candidate->mapLine().setValidCount(validCount);
+                testedLines.insert(&candidate->mapLine());
 
                 // Determine candidate suitability and cost.
                 d->beginPartitionCosting(candidate);
@@ -475,7 +421,13 @@ LineSegmentSide *PartitionEvaluator::choose(LineSegmentBlockTreeNode &node)
     LineSegmentSide *best = nullptr;
     if(!d->candidates.isEmpty())
     {
-        d->costTaskPool.waitForDone();
+        d->costTasks.wait();
+        if(d->isCancelled())
+        {
+            qDeleteAll(d->candidates);
+            d->candidates.clear();
+            return nullptr;
+        }
         PartitionCost bestCost;
         while(Impl::PartitionCandidate *candidate = d->nextCandidate())
         {
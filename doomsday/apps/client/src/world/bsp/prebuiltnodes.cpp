@@ -0,0 +1,352 @@
+/** @file prebuiltnodes.cpp  Reader for node data produced by an external node builder.
+ *
+ * @authors Copyright © 2026 agent <agent@local>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#include "world/bsp/prebuiltnodes.h"
+
+#include <QVector>
+#include <doomsday/filesys/file.h>
+#include <de/Block>
+#include <de/Log>
+#include <de/Reader>
+#include <de/Writer>
+
+using namespace de;
+
+namespace world {
+namespace bsp {
+
+namespace internal
+{
+    /// Child references with this bit set are indexes of subsectors (i.e., leafs).
+    static duint32 const NODE_CHILD_IS_LEAF = 0x80000000;
+
+    /// Fixed-point (16.16) to floating-point.
+    static inline ddouble fixedToDouble(dint32 value)
+    {
+        return ddouble(value) / 65536.0;
+    }
+
+    /**
+     * Ensure that @a count elements of @a elemSize bytes remain to be read. The element
+     * counts are read from the lump and are thus untrusted.
+     */
+    static void checkElementsRemain(Reader const &reader, duint32 count, dsize elemSize)
+    {
+        if(dsize(count) * elemSize > reader.remainingSize())
+        {
+            throw IByteArray::OffsetError("PrebuiltNodes", "Node data is truncated");
+        }
+    }
+
+    static void skipElements(Reader &reader, duint32 count, dsize elemSize)
+    {
+        checkElementsRemain(reader, count, elemSize);
+        if(count) reader.seek(IByteArray::Delta(dsize(count) * elemSize));
+    }
+
+    /**
+     * Decompress a zlib stream of unknown uncompressed size.
+     */
+    static Block inflateNodes(Block const &compressed)
+    {
+        // qUncompress expects the size of the uncompressed data as a (big-endian)
+        // prefix. It is not stored in the lump, so provide an estimate -- the output
+        // buffer is enlarged as needed.
+        Block prefixed;
+        Writer(prefixed, bigEndianByteOrder) << duint32(compressed.size() * 4);
+        prefixed += compressed;
+        return prefixed.decompressed();
+    }
+}
+
+using namespace internal;
+
+DENG2_PIMPL_NOREF(PrebuiltNodes)
+{
+    struct Node
+    {
+        Vector2d origin;
+        Vector2d direction;
+        duint32 children[2];   ///< Right, left. Leafs are flagged with NODE_CHILD_IS_LEAF.
+    };
+    QVector<Node> nodes;
+    String formatName;
+
+    static Block readLump(Id1MapRecognizer const &recognized, Id1MapRecognizer::DataType type)
+    {
+        File1 *lump = recognized.lumps().value(type);
+        if(!lump || !lump->size()) return Block();
+
+        Block data(lump->size());
+        lump->read(data.data(), true /*try the cache*/);
+        return data;
+    }
+
+    /**
+     * Read @a count nodes in the id Tech 1 layout: the partition line and bounding boxes
+     * as 16-bit integers, followed by the child references.
+     *
+     * @param wideChildren  @c true= the child references are 32-bit.
+     */
+    void readNodes(Reader &reader, duint32 count, bool wideChildren)
+    {
+        checkElementsRemain(reader, count, wideChildren? 32 : 28);
+
+        nodes.resize(dint(count));
+        for(Node &node : nodes)
+        {
+            dint16 x, y, dx, dy;
+            reader >> x >> y >> dx >> dy;
+            node.origin    = Vector2d(x, y);
+            node.direction = Vector2d(dx, dy);
+
+            reader.seek(2 * 4 * 2); // Skip the bounding boxes.
+
+            for(duint32 &child : node.children)
+            {
+                if(wideChildren)
+                {
+                    reader >> child;
+                }
+                else
+                {
+                    duint16 shortChild;
+                    reader >> shortChild;
+                    child = (shortChild & 0x8000)? ((shortChild & 0x7fff) | NODE_CHILD_IS_LEAF)
+                                                 : shortChild;
+                }
+            }
+        }
+    }
+
+    /**
+     * Read ZDBSP extended nodes (the data following the four byte signature).
+     *
+     * @param segSize      Size of a seg record in bytes.
+     * @param fixedPoint   @c true= partition lines are in 16.16 fixed-point.
+     */
+    void readExtendedNodes(Block const &data, dsize segSize, bool fixedPoint)
+    {
+        Reader reader(data);
+
+        duint32 origVertexCount, newVertexCount;
+        reader >> origVertexCount >> newVertexCount;
+        skipElements(reader, newVertexCount, 2 * 4);
+
+        duint32 subsectorCount;
+        reader >> subsectorCount;
+        skipElements(reader, subsectorCount, 4);
+
+        duint32 segCount;
+        reader >> segCount;
+        skipElements(reader, segCount, segSize);
+
+        duint32 nodeCount;
+        reader >> nodeCount;
+        if(!fixedPoint)
+        {
+            readNodes(reader, nodeCount, true /*wide children*/);
+            return;
+        }
+
+        checkElementsRemain(reader, nodeCount, 40);
+
+        nodes.resize(dint(nodeCount));
+        for(Node &node : nodes)
+        {
+            dint32 x, y, dx, dy;
+            reader >> x >> y >> dx >> dy;
+            node.origin    = Vector2d(fixedToDouble(x),  fixedToDouble(y));
+            node.direction = Vector2d(fixedToDouble(dx), fixedToDouble(dy));
+
+            reader.seek(2 * 4 * 2); // Skip the bounding boxes.
+
+            reader >> node.children[0] >> node.children[1];
+        }
+    }
+
+    /**
+     * Try the ZDBSP extended node formats, which are identified by a signature at the
+     * start of the SSECTORS (GL nodes) or NODES lump.
+     */
+    bool readExtended(Id1MapRecognizer const &recognized)
+    {
+        struct Signature {
+            char const *id;
+            Id1MapRecognizer::DataType lumpType;
+            bool compressed;
+            dsize segSize;
+            bool fixedPoint;
+        };
+        static Signature const signatures[] = {
+            { "XGL3", Id1MapRecognizer::SubsectorData, false, 13, true  },
+            { "ZGL3", Id1MapRecognizer::SubsectorData, true,  13, true  },
+            { "XGL2", Id1MapRecognizer::SubsectorData, false, 13, false },
+            { "ZGL2", Id1MapRecognizer::SubsectorData, true,  13, false },
+            { "XGLN", Id1MapRecognizer::SubsectorData, false, 11, false },
+            { "ZGLN", Id1MapRecognizer::SubsectorData, true,  11, false },
+            { "XNOD", Id1MapRecognizer::NodeData,      false, 11, false },
+            { "ZNOD", Id1MapRecognizer::NodeData,      true,  11, false },
+        };
+
+        Block const subsectorData = readLump(recognized, Id1MapRecognizer::SubsectorData);
+        Block const nodeData      = readLump(recognized, Id1MapRecognizer::NodeData);
+
+        for(Signature const &sig : signatures)
+        {
+            Block const &data = (sig.lumpType == Id1MapRecognizer::NodeData? nodeData : subsectorData);
+            if(!data.startsWith(sig.id)) continue;
+
+            Block payload = data.mid(4);
+            if(sig.compressed)
+            {
+                payload = inflateNodes(payload);
+                if(payload.isEmpty()) return false;
+            }
+            readExtendedNodes(payload, sig.segSize, sig.fixedPoint);
+            formatName = String("ZDBSP extended (%1)").arg(String(sig.id));
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * Try the GL_NODES lump. GL nodes V4 ("gNd4") and V5 ("gNd5") have 32-bit child
+     * references; the version is identified by a signature at the start of the GL_VERT
+     * lump.
+     */
+    bool readGLNodes(Id1MapRecognizer const &recognized)
+    {
+        Block const data = readLump(recognized, Id1MapRecognizer::GLNodeData);
+        if(data.isEmpty()) return false;
+
+        Block const vertexData = readLump(recognized, Id1MapRecognizer::GLVertexData);
+        bool const isV4 = vertexData.startsWith("gNd4");
+        bool const isV5 = vertexData.startsWith("gNd5");
+        bool const wideChildren = isV4 || isV5;
+
+        Reader reader(data);
+        readNodes(reader, duint32(data.size() / (wideChildren? 32 : 28)), wideChildren);
+        formatName = String("GL_NODES (%1)").arg(isV4? "V4" : isV5? "V5" : "V1-3");
+        return true;
+    }
+
+    /**
+     * Try the NODES lump. Besides the vanilla format, the DeePBSP extended format
+     * (32-bit child references) is recognized by its signature.
+     */
+    bool readVanillaNodes(Id1MapRecognizer const &recognized)
+    {
+        Block const data = readLump(recognized, Id1MapRecognizer::NodeData);
+        if(data.isEmpty()) return false;
+
+        Reader reader(data);
+        if(data.startsWith(QByteArray("xNd4\0\0\0\0", 8)))
+        {
+            reader.seek(8);
+            readNodes(reader, duint32((data.size() - 8) / 32), true /*wide children*/);
+            formatName = "DeePBSP extended NODES";
+            return true;
+        }
+
+        readNodes(reader, duint32(data.size() / 28), false);
+        formatName = "NODES";
+        return true;
+    }
+};
+
+PrebuiltNodes::PrebuiltNodes() : d(new Impl)
+{}
+
+bool PrebuiltNodes::read(Id1MapRecognizer const &recognized)
+{
+    LOG_AS("PrebuiltNodes");
+
+    d->nodes.clear();
+    d->formatName.clear();
+
+    // Doom64 and UDMF maps are not supported.
+    if(recognized.format() != Id1MapRecognizer::DoomFormat &&
+       recognized.format() != Id1MapRecognizer::HexenFormat)
+    {
+        return false;
+    }
+
+    try
+    {
+        if(!d->readExtended(recognized) &&
+           !d->readGLNodes(recognized) &&
+           !d->readVanillaNodes(recognized))
+        {
+            return false;
+        }
+    }
+    catch(Error const &er)
+    {
+        LOGDEV_MAP_WARNING("Failed reading node data: %s") << er.asText();
+        d->nodes.clear();
+    }
+    return !d->nodes.isEmpty();
+}
+
+dint PrebuiltNodes::nodeCount() const
+{
+    return d->nodes.count();
+}
+
+String PrebuiltNodes::formatName() const
+{
+    return d->formatName;
+}
+
+Partitioner::Plan PrebuiltNodes::makePlan(PartitionLookupFunc lookup) const
+{
+    Partitioner::Plan plan;
+    if(d->nodes.isEmpty()) return plan;
+
+    // Pre-order traversal, right before left. The root is the last node.
+    QVector<bool> visited(d->nodes.count(), false);
+    QVector<duint32> stack;
+    stack << duint32(d->nodes.count() - 1);
+    while(!stack.isEmpty())
+    {
+        duint32 const child = stack.takeLast();
+        if(child & NODE_CHILD_IS_LEAF)
+        {
+            plan << Partitioner::PlanConvex;
+            continue;
+        }
+
+        // A malformed tree is of no use.
+        if(child >= duint32(d->nodes.count()) || visited[child])
+        {
+            LOGDEV_MAP_WARNING("Node tree is malformed (node #%i)") << child;
+            return Partitioner::Plan();
+        }
+        visited[child] = true;
+
+        Impl::Node const &node = d->nodes.at(child);
+        plan << lookup(node.origin, node.direction);
+        stack << node.children[1] << node.children[0];
+    }
+    return plan;
+}
+
+}  // namespace bsp
+}  // namespace world
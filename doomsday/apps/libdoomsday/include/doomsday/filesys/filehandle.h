@@ -77,6 +77,12 @@ public:
     /// @return  Offset in bytes from the start of the file to begin read.
     size_t baseOffset() const;
 
+    /**
+     * Returns the native file system handle of the file, or @c nullptr if the file
+     * is not a native file (e.g., it is a lump).
+     */
+    FILE *nativeFile() const;
+
     /**
      * @return  Number of bytes read (at most @a count bytes will be read).
      */
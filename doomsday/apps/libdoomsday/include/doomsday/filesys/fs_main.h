@@ -544,6 +544,10 @@ public:
      * Finds all paths which match the search criteria. Will search the Zip
      * lump index, lump => path mappings and native files in the local system.
      *
+     * Only the Zip lumps under the part of the pattern preceding the first
+     * wildcard are examined, and the contents of native directories are cached
+     * until the directory is modified or the loaded files change.
+     *
      * @param searchPattern Pattern which defines the scope of the search.
      * @param flags         @ref searchPathFlags
      * @param found         Set of (absolute) paths that match the result.
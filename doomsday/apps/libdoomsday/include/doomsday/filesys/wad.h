@@ -34,6 +34,11 @@ namespace de {
  * WAD archive file format.
  * @ingroup fs
  *
+ * If the WAD is a native file, it is memory-mapped and the lumps are accessed
+ * directly in the mapping instead of being read into the lump cache. The mapping
+ * is copy-on-write, so a page of the file is only copied if someone writes to the
+ * "cached" data. Use the @c -nowadmap option to disable the mapping.
+ *
  * @see file.h, File1
  *
  * @todo This should be replaced with a FS2 based WadFolder class.
@@ -164,7 +169,8 @@ public:
                     bool tryCache = true);
 
     /**
-     * Read the data associated with lump @a lumpIndex into the cache.
+     * Read the data associated with lump @a lumpIndex into the cache. If the WAD is
+     * memory-mapped, nothing is read and the data is returned from the mapping.
      *
      * @param lumpIndex   Lump index associated with the data to be cached.
      *
@@ -197,6 +203,11 @@ public:
      */
     void clearLumpCache();
 
+    /**
+     * Determines if the WAD file is memory-mapped.
+     */
+    bool isMapped() const;
+
     /**
      * @attention Uses an extremely simple formula which does not conform to any CRC
      *            standard. Should not be used for anything critical.
@@ -148,6 +148,15 @@ size_t FileHandle::baseOffset() const
     return d->baseOffset;
 }
 
+FILE *FileHandle::nativeFile() const
+{
+    if (d->flags.reference)
+    {
+        return d->file->handle().nativeFile();
+    }
+    return d->hndl;
+}
+
 size_t FileHandle::length()
 {
     errorIfNotValid(*this, "FileHandle::Length");
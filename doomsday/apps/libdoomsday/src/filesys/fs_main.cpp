@@ -33,8 +33,13 @@
 #include "doomsday/filesys/zip.h"
 
 #include <ctime>
+#include <algorithm>
+#include <QDateTime>
 #include <QDir>
+#include <QFileInfo>
+#include <QHash>
 #include <QList>
+#include <QStringList>
 #include <QtAlgorithms>
 #include <de/App>
 #include <de/Log>
@@ -163,6 +168,188 @@ static bool matchFileName(String const &string, String const &pattern)
     return st->isNull();
 }
 
+namespace {
+
+/**
+ * Index of the lumps of the Zip lump index, organized by path segment. Wildcard
+ * searches only need to look at the lumps under the longest literal prefix of
+ * the pattern, instead of composing and matching the paths of all lumps.
+ *
+ * The trie is built from the lumps' PathTree nodes, so each directory of each
+ * Zip is visited only once.
+ */
+class LumpPathTrie
+{
+public:
+    void clear()
+    {
+        _root.clear();
+        _trieNodes.clear();
+        _isValid = false;
+    }
+
+    bool isValid() const { return _isValid; }
+
+    void build(LumpIndex::Lumps const &lumps)
+    {
+        clear();
+        for (int i = 0; i < lumps.size(); ++i)
+        {
+            nodeFor(lumps.at(i)->directoryNode()).lumps.append(i);
+        }
+        _trieNodes.clear(); // Only needed while building.
+        _isValid = true;
+    }
+
+    /**
+     * Collects the lumps whose path may match @a pattern. A path can only match
+     * if it begins with the part of the pattern preceding the first wildcard.
+     *
+     * @param pattern     Search pattern (* and ? are wildcards).
+     * @param candidates  Indices of the lumps are appended here, in ascending order.
+     */
+    void findCandidates(String const &pattern, QList<int> &candidates) const
+    {
+        DENG2_ASSERT(_isValid);
+
+        int wildPos = pattern.indexOf(QChar('*'));
+        int const questionPos = pattern.indexOf(QChar('?'));
+        if (questionPos >= 0 && (wildPos < 0 || questionPos < wildPos))
+        {
+            wildPos = questionPos;
+        }
+        QStringList const segments = pattern.left(wildPos).toLower().split(QChar('/'));
+
+        // Descend through all the complete segments.
+        Node const *node = &_root;
+        for (int i = 0; i < segments.size() - 1; ++i)
+        {
+            auto found = node->children.constFind(segments.at(i));
+            if (found == node->children.constEnd()) return;
+            node = found.value();
+        }
+
+        // The last segment may be incomplete.
+        int const firstCandidate = candidates.size();
+        QString const &partial = segments.last();
+        for (auto i = node->children.constBegin(); i != node->children.constEnd(); ++i)
+        {
+            if (i.key().startsWith(partial))
+            {
+                i.value()->collect(candidates);
+            }
+        }
+
+        // Keep the original order of the lumps.
+        std::sort(candidates.begin() + firstCandidate, candidates.end());
+    }
+
+private:
+    struct Node
+    {
+        QHash<String, Node *> children; ///< Keyed by lower-case segment name.
+        QList<int> lumps;               ///< Lumps with this exact path.
+
+        ~Node() { qDeleteAll(children); }
+
+        void clear()
+        {
+            qDeleteAll(children);
+            children.clear();
+            lumps.clear();
+        }
+
+        void collect(QList<int> &found) const
+        {
+            found.append(lumps);
+            for (Node const *child : children) child->collect(found);
+        }
+    };
+
+    Node &nodeFor(PathTree::Node const &treeNode)
+    {
+        if (Node *known = _trieNodes.value(&treeNode)) return *known;
+
+        Node &parent = (treeNode.isAtRootLevel()? _root : nodeFor(treeNode.parent()));
+        Node *&child = parent.children[treeNode.name().toLower()];
+        if (!child) child = new Node;
+        _trieNodes.insert(&treeNode, child);
+        return *child;
+    }
+
+    Node _root;
+    QHash<PathTree::Node const *, Node *> _trieNodes;
+    bool _isValid = false;
+};
+
+/**
+ * Contents of native directories, reused until the modification time of the
+ * directory changes.
+ */
+class NativeDirectoryCache
+{
+public:
+    struct Entry
+    {
+        String name;
+        int attrib;
+    };
+    typedef QList<Entry> Entries;
+
+    void clear() { _listings.clear(); }
+
+    /**
+     * Returns the contents of a native directory. The relative directory
+     * symbolics are omitted.
+     *
+     * @param directory  Path of the directory, ending in a separator.
+     */
+    Entries const &entries(String const &directory)
+    {
+        QDateTime const modifiedAt = QFileInfo(directory).lastModified();
+
+        // Modification times may have a resolution of only one second (or two), so
+        // a listing made soon after a modification may miss changes that get the
+        // same timestamp. Such a listing is not trusted.
+        Listing &listing = _listings[directory];
+        if (!listing.isScanned || listing.modifiedAt != modifiedAt ||
+            modifiedAt.msecsTo(listing.scannedAt) < 2000)
+        {
+            listing.entries.clear();
+            listing.modifiedAt = modifiedAt;
+            listing.scannedAt  = QDateTime::currentDateTime();
+            listing.isScanned  = true;
+
+            FindData fd;
+            if (!FindFile_FindFirst(&fd, (directory + "*").toUtf8().constData()))
+            {
+                do
+                {
+                    if (Str_Compare(&fd.name, ".") && Str_Compare(&fd.name, ".."))
+                    {
+                        listing.entries << Entry{ NativePath(Str_Text(&fd.name)).withSeparators('/'),
+                                                  int(fd.attrib) };
+                    }
+                } while (!FindFile_FindNext(&fd));
+            }
+            FindFile_Finish(&fd);
+        }
+        return listing.entries;
+    }
+
+private:
+    struct Listing
+    {
+        QDateTime modifiedAt;
+        QDateTime scannedAt;
+        bool isScanned = false;
+        Entries entries;
+    };
+    QHash<String, Listing> _listings;
+};
+
+} // namespace
+
 DENG2_PIMPL(FS1)
 {
     bool loadingForStartup;     ///< @c true= Flag newly opened files as "startup".
@@ -174,6 +361,8 @@ DENG2_PIMPL(FS1)
 
     LumpIndex primaryIndex;     ///< Primary index of all files in the system.
     LumpIndex zipFileIndex;     ///< Type-specific index for ZipFiles.
+    LumpPathTrie zipPathTrie;   ///< Paths of the ZipFile index by segment (built when needed).
+    NativeDirectoryCache nativeDirs;
 
     LumpMappings lumpMappings;  ///< Virtual (file) path => Lump name mapping.
     PathMappings pathMappings;  ///< Virtual file-directory mapping.
@@ -252,6 +441,8 @@ DENG2_PIMPL(FS1)
     {
         primaryIndex.clear();
         zipFileIndex.clear();
+        zipPathTrie.clear();
+        nativeDirs.clear();
     }
 
     String findPath(de::Uri const &search)
@@ -510,6 +701,9 @@ void FS1::index(File1 &file)
         }
     }
 
+    d->zipPathTrie.clear();
+    d->nativeDirs.clear();
+
     // Add a handle to the loaded files list.
     FileHandle *hndl = FileHandle::fromFile(file);
     d->loadedFiles.push_back(hndl); hndl->setList(reinterpret_cast<de::FileList *>(&d->loadedFiles));
@@ -527,6 +721,8 @@ void FS1::deindex(File1 &file)
 
     d->zipFileIndex.pruneByFile(file);
     d->primaryIndex.pruneByFile(file);
+    d->zipPathTrie.clear();
+    d->nativeDirs.clear();
 
     d->loadedFiles.erase(found);
     d->loadedFilesCRC = 0;
@@ -810,9 +1006,16 @@ int FS1::findAllPaths(Path searchPattern, int flags, FS1::PathList &found)
     /*
      * Check the Zip directory.
      */
-    DENG2_FOR_EACH_CONST(LumpIndex::Lumps, i, d->zipFileIndex.allLumps())
+    LumpIndex::Lumps const &zipLumps = d->zipFileIndex.allLumps();
+    if (!d->zipPathTrie.isValid())
     {
-        File1 const &lump = **i;
+        d->zipPathTrie.build(zipLumps);
+    }
+    QList<int> candidates;
+    d->zipPathTrie.findCandidates(searchPattern, candidates);
+    foreach (int lumpIdx, candidates)
+    {
+        File1 const &lump = *zipLumps.at(lumpIdx);
         PathTree::Node const &node = lump.directoryNode();
 
         String filePath;
@@ -861,38 +1064,29 @@ int FS1::findAllPaths(Path searchPattern, int flags, FS1::PathList &found)
     {
         QByteArray searchDirectoryUtf8 = searchDirectory.toUtf8();
         PathList nativeFilePaths;
-        AutoStr *wildPath = AutoStr_NewStd();
-        Str_Reserve(wildPath, searchDirectory.length() + 2 + 16); // Conservative estimate.
+        AutoStr *nativeDir = AutoStr_NewStd();
+        Str_Reserve(nativeDir, searchDirectory.length() + 2 + 16); // Conservative estimate.
 
         for (int i = -1; i < (int)d->pathMappings.count(); ++i)
         {
-            Str_Clear(wildPath);
-            Str_Appendf(wildPath, "%s/", searchDirectoryUtf8.constData());
+            Str_Clear(nativeDir);
+            Str_Appendf(nativeDir, "%s/", searchDirectoryUtf8.constData());
 
             if (i > -1)
             {
                 // Possible mapping?
-                if (!applyPathMapping(wildPath, d->pathMappings[i])) continue;
+                if (!applyPathMapping(nativeDir, d->pathMappings[i])) continue;
             }
-            Str_AppendChar(wildPath, '*');
 
-            FindData fd;
-            if (!FindFile_FindFirst(&fd, Str_Text(wildPath)))
+            // The directory contents are cached.
+            foreach (NativeDirectoryCache::Entry const &entry,
+                     d->nativeDirs.entries(QString::fromUtf8(Str_Text(nativeDir))))
             {
-                // First path found.
-                do
-                {
-                    // Ignore relative directory symbolics.
-                    if (Str_Compare(&fd.name, ".") && Str_Compare(&fd.name, ".."))
-                    {
-                        String foundPath = searchDirectory / NativePath(Str_Text(&fd.name)).withSeparators('/');
-                        if (!matchFileName(foundPath, searchPattern)) continue;
+                String foundPath = searchDirectory / entry.name;
+                if (!matchFileName(foundPath, searchPattern)) continue;
 
-                        nativeFilePaths.push_back(PathListItem(foundPath, fd.attrib));
-                    }
-                } while (!FindFile_FindNext(&fd));
+                nativeFilePaths.push_back(PathListItem(foundPath, entry.attrib));
             }
-            FindFile_Finish(&fd);
         }
 
         // Sort the native file paths.
@@ -128,6 +128,32 @@ LumpIndex::Id1MapRecognizer::Id1MapRecognizer(LumpIndex const &lumpIndex, lumpnu
 
     if (d->lumps.isEmpty()) return;
 
+    // Nodes built by glBSP (and compatibles) follow the map data lumps, introduced by a
+    // marker lump named "GL_" + map id (or "GL_LEVEL", if the id is too long).
+    if (d->format != UniversalFormat && d->lastLump < numLumps)
+    {
+        File1 &marker = lumpIndex[d->lastLump];
+        String const markerName = marker.name().fileNameAndPathWithoutExtension();
+        if ((!markerName.compareWithoutCase("GL_" + d->id) ||
+             !markerName.compareWithoutCase("GL_LEVEL")) &&
+            !sourceFile.compareWithoutCase(marker.container().composePath()))
+        {
+            for (++d->lastLump; d->lastLump < numLumps; ++d->lastLump)
+            {
+                File1 &lump       = lumpIndex[d->lastLump];
+                DataType dataType = typeForLumpName(lump.name());
+
+                if (dataType < GLVertexData || dataType > GLPVSData)
+                    break;
+
+                if (sourceFile.compareWithoutCase(lump.container().composePath()))
+                    break;
+
+                d->lumps.insert(dataType, &lump);
+            }
+        }
+    }
+
     // At this point we know we've found something that could be map data.
     if (d->format == UnknownFormat)
     {
@@ -24,10 +24,12 @@
 
 #include "doomsday/DoomsdayApp"
 #include "doomsday/filesys/lumpcache.h"
+#include <de/App>
 #include <de/ByteOrder>
 #include <de/NativePath>
 #include <de/LogBuffer>
 #include <de/memoryzone.h>
+#include <QFile>
 #include <cstring> // memcpy
 
 namespace de {
@@ -178,7 +180,64 @@ DENG2_PIMPL_NOREF(Wad)
     LumpTree entries;                     ///< Directory structure and entry records for all lumps.
     QScopedPointer<LumpCache> dataCache;  ///< Data payload cache.
 
+    QFile mappedFile;
+    uint8_t *mapping = nullptr;           ///< Contents of the entire file.
+    dsize mappedSize = 0;
+
     Impl() : entries(PathTree::MultiLeaf) {}
+
+    ~Impl()
+    {
+        if (mapping)
+        {
+            mappedFile.unmap(mapping);
+        }
+    }
+
+    /**
+     * Maps the native file of @a hndl to memory, if possible.
+     */
+    void mapFile(FileHandle &hndl)
+    {
+        if (App::commandLine().has("-nowadmap")) return;
+
+        FILE *native = hndl.nativeFile();
+        if (!native) return;
+
+        if (!mappedFile.open(native, QIODevice::ReadOnly, QFile::DontCloseHandle))
+        {
+            return;
+        }
+        dsize const offset = hndl.baseOffset();
+        if (dsize(mappedFile.size()) > offset)
+        {
+            mappedSize = dsize(mappedFile.size()) - offset;
+#ifdef DENG2_QT_5_4_OR_NEWER
+            // Private mapping: pages are copied only if written to.
+            mapping = mappedFile.map(offset, mappedSize, QFile::MapPrivateOption);
+#else
+            mapping = mappedFile.map(offset, mappedSize);
+#endif
+        }
+        if (!mapping)
+        {
+            mappedSize = 0;
+            mappedFile.close();
+        }
+    }
+
+    /**
+     * Returns the data of a lump in the mapped file, or @c nullptr if the file
+     * is not mapped or the lump is outside the file.
+     */
+    uint8_t *mappedLump(LumpFile const &lumpFile) const
+    {
+        if (!mapping) return nullptr;
+        dsize const offset = lumpFile.info().baseOffset;
+        dsize const size   = lumpFile.info().size;
+        if (offset > mappedSize || size > mappedSize - offset) return nullptr;
+        return mapping + offset;
+    }
 };
 
 Wad::Wad(FileHandle &hndl, String path, FileInfo const &info, File1 *container)
@@ -220,6 +279,8 @@ Wad::Wad(FileHandle &hndl, String path, FileInfo const &info, File1 *container)
 
         catalogLump(*lumpFile);
     }
+
+    d->mapFile(*handle_);
 }
 
 Wad::~Wad()
@@ -233,6 +294,7 @@ void Wad::clearCachedLump(int lumpIndex, bool *retCleared)
 
     if (hasLump(lumpIndex))
     {
+        // Mapped lumps are never in the cache.
         if (!d->dataCache.isNull())
         {
             d->dataCache->remove(lumpIndex, retCleared);
@@ -264,6 +326,12 @@ uint8_t const *Wad::cacheLump(int lumpIndex)
             << (unsigned long) lumpFile.info().size
             << (lumpFile.info().isCompressed()? ", compressed" : ""));
 
+    // Mapped lumps need no caching.
+    if (uint8_t const *mapped = d->mappedLump(lumpFile))
+    {
+        return mapped;
+    }
+
     // Time to create the cache?
     if (d->dataCache.isNull())
     {
@@ -322,6 +390,21 @@ size_t Wad::readLump(int lumpIndex, uint8_t *buffer, size_t startOffset,
                         << startOffset
                         << length);
 
+    // The mapped file can be read without seeking.
+    if (uint8_t const *mapped = d->mappedLump(lumpFile))
+    {
+        // Like a file read, this is only limited by the end of the file.
+        size_t const available = d->mappedSize - lumpFile.info().baseOffset;
+        size_t readBytes = (startOffset < available? de::min(available - startOffset, length) : 0);
+        std::memcpy(buffer, mapped + startOffset, readBytes);
+
+        /// @todo Do not check the read length here.
+        if (readBytes < length)
+            throw Error("Wad::readLumpSection", QString("Only read %1 of %2 bytes of lump #%3").arg(readBytes).arg(length).arg(lumpIndex));
+
+        return readBytes;
+    }
+
     // Try to avoid a file system read by checking for a cached copy.
     if (tryCache)
     {
@@ -345,6 +428,11 @@ size_t Wad::readLump(int lumpIndex, uint8_t *buffer, size_t startOffset,
     return readBytes;
 }
 
+bool Wad::isMapped() const
+{
+    return d->mapping != nullptr;
+}
+
 uint Wad::calculateCRC()
 {
     uint crc = 0;
@@ -67,6 +67,11 @@ public:
      */
     bool isFromLocalHost() const;
 
+    /**
+     * Returns the user's socket, or @c nullptr if it has been taken.
+     */
+    de::Socket const *socket() const;
+
     /**
      * Relinquishes ownership of the user's socket.
      * @return Caller gets ownership of the returned socket.
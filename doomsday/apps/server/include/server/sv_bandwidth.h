@@ -0,0 +1,98 @@
+/** @file sv_bandwidth.h  Per-client link estimation and frame pacing.
+ * @ingroup server
+ *
+ * @authors Copyright © 2026 agent <agent@local>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#ifndef SERVER_BANDWIDTH_H
+#define SERVER_BANDWIDTH_H
+
+#include "dd_share.h"
+#include <de/libcore.h>
+
+#ifndef __cplusplus
+#  error "server/sv_bandwidth.h requires C++"
+#endif
+
+/**
+ * Estimated state of the connection to a client.
+ *
+ * Deltas are considered acknowledged as soon as they have been sent, so the
+ * estimates are based on how quickly the client's socket gets rid of the sent
+ * data, and on the round-trip times of ping probes.
+ */
+struct BandwidthEstimate
+{
+    de::ddouble rtt;            ///< Smoothed round-trip time (seconds); zero if unknown.
+    de::ddouble throughput;     ///< Smoothed delivery rate (bytes per second).
+    de::dsize   buffered;       ///< Bytes waiting to be written to the socket.
+    bool        congested;      ///< Data was left waiting in the socket.
+    de::dsize   frameBudget;    ///< Maximum size of a frame (bytes).
+    de::dint    frameInterval;  ///< Tics between frames.
+};
+
+/**
+ * Clears the estimates of a client. Called when a new client arrives.
+ */
+void Sv_ResetBandwidth(de::dint plrNum);
+
+/**
+ * Samples the state of the client's socket and updates the frame budget and
+ * interval. If the link is fast enough, the frame interval may be shorter than
+ * @c server-frame-interval.
+ *
+ * @return @c true, if a new frame may be sent to the client now. If the socket
+ * is still holding more than a frame's worth of data, the frame is skipped and
+ * the deltas remain in the pool (where newer deltas replace older ones).
+ */
+dd_bool Sv_CheckBandwidth(de::dint plrNum);
+
+/**
+ * Notifies the estimator that the latest frame of the client was limited by
+ * the frame budget.
+ */
+void Sv_BandwidthFrameFull(de::dint plrNum);
+
+/**
+ * Returns the current number of tics between frames for the client.
+ */
+de::dint Sv_GetFrameInterval(de::dint plrNum);
+
+/**
+ * Returns the current frame size budget of the client.
+ */
+de::dsize Sv_GetFrameBudget(de::dint plrNum);
+
+/**
+ * Uses the time measured for the handshake as the initial round-trip time.
+ *
+ * @param milliseconds  Time between sending the handshake and receiving the ack.
+ */
+void Sv_BandwidthHandshakeTime(de::dint plrNum, de::duint milliseconds);
+
+/**
+ * Checks if a returned ping was a probe sent by the estimator.
+ *
+ * @param time  Time stamp of the ping packet.
+ *
+ * @return @c true, if the ping was a probe. Otherwise it should be handled
+ * with Net_PingResponse().
+ */
+dd_bool Sv_BandwidthPingResponse(de::dint plrNum, de::duint32 time);
+
+BandwidthEstimate const &Sv_GetBandwidthEstimate(de::dint plrNum);
+
+#endif  // SERVER_BANDWIDTH_H
@@ -45,6 +45,9 @@ struct material_s;
 extern de::dint svMaxPlayers;
 extern de::dint allowFrames;    ///< Allow sending of frames.
 extern de::dint frameInterval;  ///< In tics.
+extern de::dint frameParallel;  ///< Assemble frames for clients concurrently.
+extern de::dint frameAdaptive;  ///< Adapt frame budgets and intervals to the links.
+extern de::dint svVisibility;   ///< Lower the priority of deltas the client can't see.
 extern de::dint netRemoteUser;  ///< The client who is currently logged in.
 extern char *netPassword;       ///< Remote login password.
 
@@ -88,8 +91,6 @@ de::dint Sv_GetNumPlayers();
 
 de::dint Sv_GetNumConnected();
 
-dd_bool Sv_CheckBandwidth(de::dint playerNumber);
-
 dd_bool Sv_CanTrustClientPos(de::dint plrNum);
 
 /**
@@ -219,6 +219,7 @@ typedef struct ownerinfo_s {
     angle_t         angle; // Angle can change rapidly => not very important
     float           speed;
     uint            ackThreshold; // Expected ack time in milliseconds
+    int             viewSector; // REJECT row of the owner's sector (-1 if unknown)
 } ownerinfo_t;
 
 /**
@@ -269,6 +270,7 @@ void            Sv_RatePool(pool_t* pool);
 delta_t*        Sv_PoolQueueExtract(pool_t* pool);
 void            Sv_AckDeltaSet(uint clientNumber, int set, byte resent);
 uint            Sv_CountUnackedDeltas(uint clientNumber);
+uint            Sv_CountQueuedDeltas(uint clientNumber);
 
 /**
  * Adds a new sound delta to the selected client pools. As the starting of a
@@ -295,6 +297,24 @@ void Sv_NewSoundDelta(int soundId, mobj_t const *emitter, Sector *sourceSector,
 
 #ifdef __cplusplus
 } // extern "C"
+
+/**
+ * Notes that a property of a map element has been changed, so the element will be
+ * compared against the world register when the next frame deltas are generated.
+ * Called by the property setters of sectors, planes, surfaces, lines and sides.
+ * Surfaces are attributed to their owning plane or side, and planes to their sector.
+ *
+ * @param element  Map element that was changed.
+ */
+void Sv_MapElementChanged(world::MapElement const &element);
+
+/**
+ * Notes that a mobj has been created, moved or has changed state, so it will be
+ * compared against the world register when the next frame deltas are generated.
+ *
+ * @param mob  Mobj that was changed.
+ */
+void Sv_MobjChanged(mobj_t const &mob);
 #endif
 
 #endif
@@ -0,0 +1,61 @@
+/** @file sv_visibility.h  Delta Pool Visibility.
+ * @ingroup server
+ *
+ * @authors Copyright © 2026 agent <agent@local>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#ifndef __DOOMSDAY_SERVER_POOL_VISIBILITY_H__
+#define __DOOMSDAY_SERVER_POOL_VISIBILITY_H__
+
+#include "sv_def.h"
+
+struct mobj_s;
+
+/**
+ * Prepare the potentially visible sets for the current map. The REJECT data of the
+ * map (if any) tells which sectors cannot be seen from each other. Called when the
+ * delta pools are initialized.
+ *
+ * Visibility is determined per sector: the BSP is only used for finding the sector
+ * of a pool owner or a map-object. If the map has no REJECT data, or the data is
+ * all zeros, everything is considered potentially visible.
+ */
+void            Sv_InitVisibility(void);
+
+void            Sv_ShutdownVisibility(void);
+
+/**
+ * Returns the index of the viewing sector of a pool owner standing at @a mob
+ * (i.e., the row of the REJECT matrix), or -1 if unknown.
+ */
+int             Sv_VisibilitySector(struct mobj_s const *mob);
+
+/**
+ * Determines whether anything in the sector @a sectorIndex might be visible from
+ * the viewing sector @a viewSector. When unsure, the answer is @c true.
+ *
+ * @param viewSector   Viewing sector of the pool owner (see Sv_VisibilitySector()).
+ * @param sectorIndex  Index of the sector in the map.
+ */
+dd_bool         Sv_IsSectorPotentiallyVisible(int viewSector, int sectorIndex);
+
+/**
+ * Determines whether the map-object @a mob might be visible from the viewing sector
+ * @a viewSector. When unsure, the answer is @c true.
+ */
+dd_bool         Sv_IsMobjPotentiallyVisible(int viewSector, struct mobj_s const *mob);
+
+#endif
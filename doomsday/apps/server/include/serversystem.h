@@ -23,6 +23,7 @@
 #include <de/System>
 #include <de/Id>
 #include <de/Error>
+#include <de/Record>
 #include "remoteuser.h"
 #include "dd_types.h"
 
@@ -94,6 +95,16 @@ public:
      */
     void printStatus();
 
+    /**
+     * Composes a record of the server's performance statistics: time spent running
+     * the server's ticks, and the network state of each connected client. This is
+     * sent in response to "Stats?" queries.
+     *
+     * The tick time maximum is the longest of the latest ticks (one second's worth
+     * when clients are connected), so reading it does not affect it.
+     */
+    de::Record statistics() const;
+
     void timeChanged(de::Clock const &);
 
 protected slots:
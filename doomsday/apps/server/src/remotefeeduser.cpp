@@ -19,6 +19,7 @@
 #include "remotefeeduser.h"
 
 #include <de/Async>
+#include <de/ByteArrayFile>
 #include <de/FileSystem>
 #include <de/Folder>
 #include <de/Message>
@@ -30,14 +31,84 @@ DENG2_PIMPL(RemoteFeedUser)
 {
     using QueryId = RemoteFeedQueryPacket::Id;
 
+    /**
+     * File contents being sent. Random-access files are streamed: each block is read
+     * from the source file when it is the transfer's turn to send.
+     *
+     * If the file changes during the transfer, the transfer restarts from the
+     * beginning. The client recognizes this from a block at offset zero. A file
+     * that no longer exists is sent as an empty file.
+     */
     struct Transfer
     {
         QueryId queryId;
-        Block data;
+        String path;
+        bool streamed = false;
+        Block data;             ///< Entire contents of a file that cannot be streamed.
+        duint64 fileSize = 0;
         duint64 position = 0;
+        Time modifiedAt;
 
         Transfer(QueryId id = 0) : queryId(id)
         {}
+
+        /// Prepares to send the current contents of the file.
+        void begin(File const *file)
+        {
+            streamed = false;
+            data.clear();
+            fileSize = 0;
+            if (!file) return;
+
+            modifiedAt = file->status().modifiedAt;
+            if (auto const *source = maybeAs<ByteArrayFile>(file->target()))
+            {
+                streamed = true;
+                fileSize = source->size();
+            }
+            else
+            {
+                *file >> data;
+                fileSize = data.size();
+            }
+        }
+
+        /// Ends the transfer by telling the client that the file has no contents.
+        void abort()
+        {
+            streamed = false;
+            data.clear();
+            fileSize = position = 0;
+        }
+
+        Block readBlock(dsize maxSize)
+        {
+            File const *file = nullptr;
+            ByteArrayFile const *source = nullptr;
+            if (streamed)
+            {
+                // The file is located again in case it has been changed in the meantime.
+                file   = FS::tryLocate<File const>(path);
+                source = (file? maybeAs<ByteArrayFile>(file->target()) : nullptr);
+                if (!source || source->size() != fileSize ||
+                    file->status().modifiedAt != modifiedAt)
+                {
+                    LOG_NET_WARNING("%s changed during transfer, sending it again") << path;
+                    begin(file);
+                    position = 0;
+                    if (!streamed) source = nullptr;
+                }
+            }
+
+            dsize const count = dsize(de::min(duint64(maxSize), fileSize - position));
+            if (!source)
+            {
+                return data.mid(dsize(position), count);
+            }
+            Block block(count);
+            source->get(position, block.data(), count);
+            return block;
+        }
     };
 
     std::unique_ptr<Socket> socket;
@@ -112,36 +183,44 @@ DENG2_PIMPL(RemoteFeedUser)
         {
             if (socket->bytesBuffered() > 0) return; // Too soon.
 
-            std::unique_ptr<RemoteFeedFileContentsPacket> response;
-
-            // Send the next block of the first file in the transfer queue.
+            // Send the next block of the first file in the transfer queue. Concurrent
+            // transfers take turns, so a large file does not hold up the others.
+            Transfer xfer;
             {
                 DENG2_GUARD(transfers);
-
                 if (transfers.value.isEmpty()) return;
+                xfer = transfers.value.takeFirst();
+            }
 
-                response.reset(new RemoteFeedFileContentsPacket);
-
-                dsize const blockSize = 128 * 1024;
-                auto &xfer = transfers.value.front();
-
-                response->setId(xfer.queryId);
-                response->setFileSize(xfer.data.size());
-                response->setStartOffset(xfer.position);
-                response->setData(xfer.data.mid(xfer.position, blockSize));
-
-                xfer.position += response->data().size();
-                if (xfer.position >= xfer.data.size())
-                {
-                    // That was all.
-                    transfers.value.pop_front();
-                }
+            // The file is read without holding the lock.
+            dsize const blockSize = 128 * 1024;
+            Block block;
+            try
+            {
+                block = xfer.readBlock(blockSize);
             }
+            catch (Error const &er)
+            {
+                LOG_NET_ERROR("Failed to read %s for transfer to %s: %s")
+                        << xfer.path << socket->peerAddress().asText() << er.asText();
+                xfer.abort();
+                block.clear();
+            }
+
+            RemoteFeedFileContentsPacket response;
+            response.setId(xfer.queryId);
+            response.setFileSize(xfer.fileSize);
+            response.setStartOffset(xfer.position);
+            response.setData(block);
 
-            if (response)
+            xfer.position += block.size();
+            if (xfer.position < xfer.fileSize)
             {
-                socket->sendPacket(*response);
+                DENG2_GUARD(transfers);
+                transfers.value.append(xfer);
             }
+
+            socket->sendPacket(response);
         }
         catch (Error const &er)
         {
@@ -179,17 +258,28 @@ DENG2_PIMPL(RemoteFeedUser)
 
             case RemoteFeedQueryPacket::FileContents: {
                 Transfer xfer(query.id());
-                if (auto const *file = FS::tryLocate<File const>(query.path()))
+                xfer.path = query.path();
+                auto const *file = FS::tryLocate<File const>(query.path());
+                if (!file)
                 {
-                    *file >> xfer.data;
+                    LOG_NET_WARNING("%s not found!") << query.path();
                 }
-                else
+                xfer.begin(file);
+                // Resume from the requested offset, unless the file is not the one
+                // whose earlier contents the client has.
+                xfer.position = de::min(query.startOffset(), xfer.fileSize);
+                if (xfer.position && file &&
+                    ((query.resumeMetaId() && query.resumeMetaId() != file->metaId()) ||
+                     (query.resumeFileSize() && query.resumeFileSize() != xfer.fileSize)))
                 {
-                    LOG_NET_WARNING("%s not found!") << query.path();
+                    LOG_NET_MSG("%s has changed since the interrupted transfer, "
+                                "sending it again") << query.path();
+                    xfer.position = 0;
                 }
-                LOG_NET_MSG("New file transfer: %s size:%i")
+                LOG_NET_MSG("New file transfer: %s size:%i offset:%i")
                         << query.path()
-                        << xfer.data.size();
+                        << xfer.fileSize
+                        << xfer.position;
                 DENG2_GUARD(transfers);
                 transfers.value.push_back(xfer);
                 break; }
@@ -26,7 +26,6 @@
 #include "world/map.h"
 
 #include <de/data/json.h>
-#include <de/memory.h>
 #include <de/Message>
 #include <de/ByteRefArray>
 #include <de/shell/Protocol>
@@ -107,6 +106,23 @@ DENG2_PIMPL(RemoteUser)
         }
     }
 
+    /**
+     * Checks if the remote agent is allowed to use the shell.
+     *
+     * @param supplied  SHA-1 hash of the password, if one was included in the
+     *                  request. Password is not required for connections from
+     *                  the local computer, unless one is included.
+     */
+    bool isAuthorized(QByteArray const &supplied) const
+    {
+        if (supplied.isEmpty())
+        {
+            return !strlen(netPassword) || isFromLocal;
+        }
+        QByteArray pwd(netPassword, strlen(netPassword));
+        return supplied == QCryptographicHash::hash(pwd, QCryptographicHash::Sha1);
+    }
+
     /**
      * Validate and process the command, which has been sent by a remote agent.
      * If the command is invalid, the node is immediately closed.
@@ -140,6 +156,22 @@ DENG2_PIMPL(RemoteUser)
         {
             self() << Block("Pong");
         }
+        else if (length >= 6 && command.startsWith("Stats?"))
+        {
+            // Performance statistics, e.g., for load testing tools. These identify
+            // the players, so the shell password is required.
+            if (!isAuthorized(command.mid(6)))
+            {
+                if (length == 6)
+                {
+                    self() << ByteRefArray("Psw?", 4);
+                    return true;
+                }
+                self().deleteLater();
+                return false;
+            }
+            self() << Block("Stats\n" + composeJSON(App_ServerSystem().statistics()));
+        }
         else if (command == "MapOutline?")
         {
             shell::MapOutlinePacket packet;
@@ -159,27 +191,17 @@ DENG2_PIMPL(RemoteUser)
         }
         else if (length >= 5 && command.startsWith("Shell"))
         {
-            if (length == 5)
+            if (!isAuthorized(command.mid(5)))
             {
-                // Password is not required for connections from the local computer.
-                if (strlen(netPassword) > 0 && !isFromLocal)
+                if (length == 5)
                 {
                     // Need to ask for a password, too.
                     self() << ByteRefArray("Psw?", 4);
                     return true;
                 }
-            }
-            else if (length > 5)
-            {
-                // A password was included.
-                QByteArray supplied = command.mid(5);
-                QByteArray pwd(netPassword, strlen(netPassword));
-                if (supplied != QCryptographicHash::hash(pwd, QCryptographicHash::Sha1))
-                {
-                    // Wrong!
-                    self().deleteLater();
-                    return false;
-                }
+                // Wrong!
+                self().deleteLater();
+                return false;
             }
 
             // This node will switch to shell mode: ownership of the socket is
@@ -187,14 +209,24 @@ DENG2_PIMPL(RemoteUser)
             App_ServerSystem().convertToShellUser(thisPublic);
             return false;
         }
-        else if (length >= 10 && command.startsWith("Join ") && command[9] == ' ')
+        else if (command.startsWith("Join"))
         {
-            protocolVersion = command.mid(5, 4).toInt(0, 16);
+            // Options may be appended to the command: "Join+stream (version) (name)".
+            int const paramsAt = command.indexOf(' ') + 1;
+            QList<QByteArray> const options = command.mid(4, paramsAt - 5).split('+');
+            if (paramsAt < 5 || length < paramsAt + 5 || command[paramsAt + 4] != ' ')
+            {
+                LOG_NET_WARNING("Received an invalid join request from %s") << id;
+                self().deleteLater();
+                return false;
+            }
+
+            protocolVersion = command.mid(paramsAt, 4).toInt(0, 16);
 
             // Read the client's name and convert the network node into an actual
             // client. Here we also decide if the client's protocol is compatible
             // with ours.
-            name = String::fromUtf8(command.mid(10));
+            name = String::fromUtf8(command.mid(paramsAt + 5));
 
             if (App_ServerSystem().isUserAllowedToJoin(self()))
             {
@@ -203,6 +235,12 @@ DENG2_PIMPL(RemoteUser)
                 // Successful! Send a reply.
                 self() << ByteRefArray("Enter", 5);
 
+                if (options.contains("stream"))
+                {
+                    // The rest of the messages are sent using a compression stream.
+                    socket->enableStreamCompression();
+                }
+
                 // Inform the higher levels of this occurence.
                 netevent_t netEvent;
                 netEvent.type = NE_CLIENT_ENTRY;
@@ -249,6 +287,11 @@ String RemoteUser::name() const
     return d->name;
 }
 
+Socket const *RemoteUser::socket() const
+{
+    return d->socket;
+}
+
 Socket *RemoteUser::takeSocket()
 {
     Socket *sock = d->socket;
@@ -287,16 +330,8 @@ void RemoteUser::handleIncomingPackets()
             /// be handled immediately.
 
             // Post the data into the queue.
-            netmessage_t *msg = (netmessage_t *) M_Calloc(sizeof(netmessage_t));
-
-            msg->sender = d->id;
-            msg->data = new byte[packet->size()];
-            memcpy(msg->data, packet->data(), packet->size());
-            msg->size = packet->size();
-            msg->handle = msg->data; // needs delete[]
-
             // The message queue will handle the message from now on.
-            N_PostMessage(msg);
+            N_PostMessage(N_NewMessage(d->id, packet->data(), packet->size()));
             break; }
 
         default:
@@ -0,0 +1,267 @@
+/** @file sv_bandwidth.cpp  Per-client link estimation and frame pacing.
+ *
+ * @authors Copyright © 2026 agent <agent@local>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#include "de_base.h"
+#include "server/sv_bandwidth.h"
+#include "server/sv_def.h"
+#include "network/net_main.h"
+#include "network/net_msg.h"
+#include "world/p_players.h"
+#include "serversystem.h"
+#include "remoteuser.h"
+
+#include <de/Socket>
+#include <de/timer.h>
+
+using namespace de;
+
+// Frame size used before anything is known about the link, and when the
+// adaptive mode is disabled.
+#define DEFAULT_FRAME_BUDGET    2320 // bytes
+
+// Frame budget is never reduced below this.
+#define MINIMUM_FRAME_BUDGET    1800 // bytes
+
+#define MAXIMUM_FRAME_BUDGET    64000 // bytes
+
+// Budget increase after a frame that was limited by the budget.
+#define FRAME_BUDGET_STEP       (MINIMUM_FRAME_BUDGET / 2)
+
+// Minimum duration of a throughput sample.
+#define SAMPLE_SECONDS          .1
+
+// Consecutive samples without congestion before the interval is shortened.
+#define RECOVERY_SAMPLES        10
+
+// Maximum number of tics added to the frame interval of a congested client.
+#define MAX_EXTRA_INTERVAL      4
+
+// Clients with shorter round-trip times are sent a frame every tic.
+#define FAST_LINK_RTT           .02 // seconds
+
+#define PROBE_INTERVAL          2.0 // seconds
+#define PROBE_TIMEOUT           10.0
+
+dint frameAdaptive = 1;  ///< Adapt frame budgets and intervals to the links.
+
+namespace {
+
+struct LinkState
+{
+    BandwidthEstimate est;
+    duint64 sentBytes;      ///< Socket's sent byte counter at the last sample.
+    ddouble sampledAt;      ///< Time of the last sample (zero if none).
+    dint extraInterval;     ///< Tics added to the interval due to congestion.
+    dint clearSamples;      ///< Consecutive samples without congestion.
+    duint32 probeSentAt;    ///< Time stamp of the outstanding probe (zero if none).
+    ddouble nextProbeAt;
+};
+
+LinkState links[DDMAXPLAYERS];
+
+} // namespace
+
+static Socket const *clientSocket(dint plrNum)
+{
+    auto const &plr = *DD_Player(plrNum);
+    if (!plr.remoteUserId) return nullptr;
+    return App_ServerSystem().user(plr.remoteUserId).socket();
+}
+
+static void addRttSample(LinkState &link, ddouble seconds)
+{
+    if (link.est.rtt > 0)
+    {
+        link.est.rtt = link.est.rtt * .875 + seconds * .125;
+    }
+    else
+    {
+        link.est.rtt = seconds;
+    }
+}
+
+static void sendProbe(dint plrNum, LinkState &link, ddouble now)
+{
+    link.nextProbeAt = now + PROBE_INTERVAL;
+
+    if (link.probeSentAt)
+    {
+        // Wait for the previous probe to come back, unless it's lost.
+        if (Timer_RealMilliseconds() - link.probeSentAt < PROBE_TIMEOUT * 1000)
+            return;
+    }
+
+    // Don't interfere with the "ping" command.
+    if (DD_Player(plrNum)->pinger().sent) return;
+
+    link.probeSentAt = Timer_RealMilliseconds();
+
+    // The client returns pings that it did not send.
+    Msg_Begin(PKT_PING);
+    Writer_WriteUInt32(::msgWriter, link.probeSentAt);
+    Msg_End();
+    Net_SendBuffer(plrNum, 0);
+}
+
+/**
+ * Compares the amount of data that left the socket during the sample to the
+ * amount that was sent. If data remained waiting in the socket throughout the
+ * sample, the link could not keep up and the budget is reduced.
+ */
+static void sampleLink(LinkState &link, dsize buffered, duint64 sentBytes, ddouble now)
+{
+    BandwidthEstimate &est = link.est;
+
+    if (link.sampledAt <= 0)
+    {
+        link.sampledAt = now;
+        link.sentBytes = sentBytes;
+        est.buffered   = buffered;
+        return;
+    }
+
+    ddouble const elapsed = now - link.sampledAt;
+    if (elapsed < SAMPLE_SECONDS) return;
+
+    dint64 const delivered = dint64(est.buffered) + dint64(sentBytes - link.sentBytes)
+                           - dint64(buffered);
+    ddouble const rate = de::max(dint64(0), delivered) / elapsed;
+
+    est.throughput = (est.throughput > 0? est.throughput * .75 + rate * .25 : rate);
+    est.congested  = (buffered > 0 && est.buffered > 0);
+
+    if (est.congested)
+    {
+        // Multiplicative decrease: at most what the link delivered during one frame.
+        ddouble const frameSeconds = de::max(1, est.frameInterval) / ddouble(TICSPERSEC);
+        est.frameBudget = de::clamp(dsize(MINIMUM_FRAME_BUDGET),
+                                    de::min(est.frameBudget / 2, dsize(est.throughput * frameSeconds)),
+                                    dsize(MAXIMUM_FRAME_BUDGET));
+        link.clearSamples = 0;
+        if (link.extraInterval < MAX_EXTRA_INTERVAL)
+        {
+            link.extraInterval++;
+        }
+    }
+    else if (link.extraInterval > 0 && ++link.clearSamples >= RECOVERY_SAMPLES)
+    {
+        link.extraInterval--;
+        link.clearSamples = 0;
+    }
+
+    link.sampledAt = now;
+    link.sentBytes = sentBytes;
+    est.buffered   = buffered;
+}
+
+void Sv_ResetBandwidth(dint plrNum)
+{
+    DENG2_ASSERT(plrNum >= 0 && plrNum < DDMAXPLAYERS);
+
+    LinkState &link = links[plrNum];
+    de::zap(link);
+    link.est.frameBudget   = DEFAULT_FRAME_BUDGET;
+    link.est.frameInterval = ::frameInterval;
+}
+
+dd_bool Sv_CheckBandwidth(dint plrNum)
+{
+    DENG2_ASSERT(plrNum >= 0 && plrNum < DDMAXPLAYERS);
+
+    LinkState &link = links[plrNum];
+    Socket const *socket = clientSocket(plrNum);
+    if (!socket)
+    {
+        // Not a remote client (e.g., recording a demo).
+        return true;
+    }
+
+    ddouble const now = Timer_RealSeconds();
+    dsize const buffered = socket->bytesBuffered();
+    sampleLink(link, buffered, socket->compressionStats().sentCompressedBytes, now);
+
+    if (now >= link.nextProbeAt)
+    {
+        sendProbe(plrNum, link, now);
+    }
+
+    BandwidthEstimate &est = link.est;
+    if (!::frameAdaptive)
+    {
+        est.frameInterval = ::frameInterval;
+        return true;
+    }
+
+    // Fast links get a frame every tic.
+    bool const fast = (!link.extraInterval && !est.congested &&
+                       est.rtt > 0 && est.rtt < FAST_LINK_RTT);
+    est.frameInterval = (fast? 0 : ::frameInterval) + link.extraInterval;
+
+    // Deltas wait in the pool while the socket still holds more than a frame.
+    return buffered <= est.frameBudget;
+}
+
+void Sv_BandwidthFrameFull(dint plrNum)
+{
+    // Note: This may be called concurrently for different clients.
+    BandwidthEstimate &est = links[plrNum].est;
+    if (!est.congested)
+    {
+        // Additive increase.
+        est.frameBudget = de::min(est.frameBudget + FRAME_BUDGET_STEP,
+                                  dsize(MAXIMUM_FRAME_BUDGET));
+    }
+}
+
+dint Sv_GetFrameInterval(dint plrNum)
+{
+    DENG2_ASSERT(plrNum >= 0 && plrNum < DDMAXPLAYERS);
+    if (!::frameAdaptive) return ::frameInterval;
+    return links[plrNum].est.frameInterval;
+}
+
+dsize Sv_GetFrameBudget(dint plrNum)
+{
+    DENG2_ASSERT(plrNum >= 0 && plrNum < DDMAXPLAYERS);
+    if (!::frameAdaptive) return DEFAULT_FRAME_BUDGET;
+    return links[plrNum].est.frameBudget;
+}
+
+void Sv_BandwidthHandshakeTime(dint plrNum, duint milliseconds)
+{
+    DENG2_ASSERT(plrNum >= 0 && plrNum < DDMAXPLAYERS);
+    addRttSample(links[plrNum], milliseconds / 1000.0);
+}
+
+dd_bool Sv_BandwidthPingResponse(dint plrNum, duint32 time)
+{
+    DENG2_ASSERT(plrNum >= 0 && plrNum < DDMAXPLAYERS);
+
+    LinkState &link = links[plrNum];
+    if (!link.probeSentAt || time != link.probeSentAt) return false;
+
+    addRttSample(link, (Timer_RealMilliseconds() - time) / 1000.0);
+    link.probeSentAt = 0;
+    return true;
+}
+
+BandwidthEstimate const &Sv_GetBandwidthEstimate(dint plrNum)
+{
+    DENG2_ASSERT(plrNum >= 0 && plrNum < DDMAXPLAYERS);
+    return links[plrNum].est;
+}
@@ -22,27 +22,21 @@
 #include "def_main.h"
 #include "sys_system.h"
 #include "network/net_main.h"
+#include "network/net_msg.h"
+#include "server/sv_bandwidth.h"
 #include "server/sv_pool.h"
 #include "world/p_players.h"
 
 #include <de/LogBuffer>
+#include <de/TaskGroup>
+#include <QVector>
 #include <cmath>
 
 using namespace de;
 
-// Hitting the maximum packet size allows checks for raising BWR.
-#define BWR_ADJUST_TICS     (TICSPERSEC / 2)
-
-// The minimum frame size is used when bandwidth rating is zero (poorest
-// possible connection).
-#define MINIMUM_FRAME_SIZE  1800 // bytes
-
 // The first frame should contain as much information as possible.
 #define MAX_FIRST_FRAME_SIZE    64000
 
-// The frame size is calculated by multiplying the bandwidth rating
-// (max 100) with this factor (+min).
-#define FRAME_SIZE_FACTOR   13
 #define FIXED8_8(x)         (((x)*256) >> 16)
 #define FIXED10_6(x)        (((x)*64) >> 16)
 #define CLAMPED_CHAR(x)     ((x)>127? 127 : (x)<-128? -128 : (x))
@@ -50,10 +44,12 @@ using namespace de;
 // If movement is faster than this, we'll adjust the place of the point.
 #define MOM_FAST_LIMIT      (127)
 
-void Sv_SendFrame(dint playerNumber);
+static Writer1 *Sv_AssembleFrame(dint playerNumber);
+static void Sv_SendFrame(dint playerNumber, Writer1 *frame);
 
 dint allowFrames;
 dint frameInterval = 1;  ///< Skip every second frame by default (17.5fps)
+dint frameParallel = 1;  ///< Assemble the frames of multiple clients concurrently.
 
 #ifdef DENG2_DEBUG
 static dint byteCounts[256];
@@ -100,6 +96,9 @@ void Sv_TransmitFrame()
     // How many players currently in the game?
     dint const numInGame = Sv_GetNumPlayers();
 
+    // Players who will be sent a frame.
+    QVector<dint> targets;
+
     dint pCount = 0;
     for (dint i = 0; i < DDMAXPLAYERS; ++i)
     {
@@ -111,15 +110,18 @@ void Sv_TransmitFrame()
             continue;
         }
 
+        // The interval depends on the client's link.
+        dint const interval = Sv_GetFrameInterval(i);
+
         // When the interval is greater than zero, this causes the frames
         // to be sent at different times for each player.
         pCount++;
         dint cTime = SECONDS_TO_TICKS(::gameTime);
-        if (::frameInterval > 0 && numInGame > 1)
+        if (interval > 0 && numInGame > 1)
         {
-            cTime += (pCount * ::frameInterval) / numInGame;
+            cTime += (pCount * interval) / numInGame;
         }
-        if (cTime <= plr.lastTransmit + ::frameInterval)
+        if (cTime <= plr.lastTransmit + interval)
         {
             // Still too early to send.
             continue;
@@ -133,7 +135,12 @@ void Sv_TransmitFrame()
             // decrease back to zero.
             //::clients[i].updateCount--;
 
-            Sv_SendFrame(i);
+            // Does the send queue allow us to send this packet?
+            // Link estimates are updated during the check.
+            if (Sv_CheckBandwidth(i))
+            {
+                targets << i;
+            }
         }
         else
         {
@@ -141,6 +148,34 @@ void Sv_TransmitFrame()
                              ::lastTransmitTic << i << plr.ready);
         }
     }
+
+    // Each client has its own delta pool, so the frames can be assembled
+    // independently of each other.
+    QVector<Writer1 *> frames(targets.size());
+    if (::frameParallel && targets.size() > 1)
+    {
+        Writer1 **frame = frames.data();
+        parallelFor(0, targets.size(), [frame, &targets] (dint begin, dint end)
+        {
+            for (dint k = begin; k < end; ++k)
+            {
+                frame[k] = Sv_AssembleFrame(targets.at(k));
+            }
+        }, 1);
+    }
+    else
+    {
+        for (dint k = 0; k < targets.size(); ++k)
+        {
+            frames[k] = Sv_AssembleFrame(targets.at(k));
+        }
+    }
+
+    // The frames are sent in the main thread.
+    for (dint k = 0; k < targets.size(); ++k)
+    {
+        Sv_SendFrame(targets.at(k), frames.at(k));
+    }
 }
 
 /**
@@ -164,9 +199,9 @@ void Sv_Shutdown()
 }
 
 /**
- * The delta is written to the message buffer.
+ * The delta is written using @a writer.
  */
-void Sv_WriteMobjDelta(const void* deltaPtr)
+void Sv_WriteMobjDelta(Writer1 *writer, void const *deltaPtr)
 {
     auto const *delta  = reinterpret_cast<mobjdelta_t const *>(deltaPtr);
     dt_mobj_t const *d = &delta->mo;
@@ -238,13 +273,13 @@ void Sv_WriteMobjDelta(const void* deltaPtr)
     DENG2_ASSERT((df & 0xffff) != 0);    // don't write empty deltas
 
     // First the mobj ID number and flags.
-    Writer_WriteUInt16(::msgWriter, delta->delta.id);
-    Writer_WriteUInt16(::msgWriter, df & 0xffff);
+    Writer_WriteUInt16(writer, delta->delta.id);
+    Writer_WriteUInt16(writer, df & 0xffff);
 
     // More flags?
     if (df & MDF_MORE_FLAGS)
     {
-        Writer_WriteByte(::msgWriter, moreFlags);
+        Writer_WriteByte(writer, moreFlags);
     }
 
     // Coordinates with three bytes.
@@ -252,128 +287,128 @@ void Sv_WriteMobjDelta(const void* deltaPtr)
     {
         fixed_t vx = FLT2FIX(d->origin[VX]);
 
-        Writer_WriteInt16(::msgWriter, vx >> FRACBITS);
-        Writer_WriteByte(::msgWriter, vx >> 8);
+        Writer_WriteInt16(writer, vx >> FRACBITS);
+        Writer_WriteByte(writer, vx >> 8);
     }
     if (df & MDF_ORIGIN_Y)
     {
         fixed_t vy = FLT2FIX(d->origin[VY]);
 
-        Writer_WriteInt16(::msgWriter, vy >> FRACBITS);
-        Writer_WriteByte(::msgWriter, vy >> 8);
+        Writer_WriteInt16(writer, vy >> FRACBITS);
+        Writer_WriteByte(writer, vy >> 8);
     }
 
     if (df & MDF_ORIGIN_Z)
     {
         fixed_t vz = FLT2FIX(d->origin[VZ]);
-        Writer_WriteInt16(::msgWriter, vz >> FRACBITS);
-        Writer_WriteByte(::msgWriter, vz >> 8);
+        Writer_WriteInt16(writer, vz >> FRACBITS);
+        Writer_WriteByte(writer, vz >> 8);
 
-        Writer_WriteFloat(::msgWriter, d->floorZ);
-        Writer_WriteFloat(::msgWriter, d->ceilingZ);
+        Writer_WriteFloat(writer, d->floorZ);
+        Writer_WriteFloat(writer, d->ceilingZ);
     }
 
     // Momentum using 8.8 fixed point.
     if (df & MDF_MOM_X)
     {
         fixed_t mx = FLT2FIX(d->mom[MX]);
-        Writer_WriteInt16(::msgWriter, moreFlags & MDFE_FAST_MOM ? FIXED10_6(mx) : FIXED8_8(mx));
+        Writer_WriteInt16(writer, moreFlags & MDFE_FAST_MOM ? FIXED10_6(mx) : FIXED8_8(mx));
     }
 
     if (df & MDF_MOM_Y)
     {
         fixed_t my = FLT2FIX(d->mom[MY]);
-        Writer_WriteInt16(::msgWriter, moreFlags & MDFE_FAST_MOM ? FIXED10_6(my) : FIXED8_8(my));
+        Writer_WriteInt16(writer, moreFlags & MDFE_FAST_MOM ? FIXED10_6(my) : FIXED8_8(my));
     }
 
     if (df & MDF_MOM_Z)
     {
         fixed_t mz = FLT2FIX(d->mom[MZ]);
-        Writer_WriteInt16(::msgWriter, moreFlags & MDFE_FAST_MOM ? FIXED10_6(mz) : FIXED8_8(mz));
+        Writer_WriteInt16(writer, moreFlags & MDFE_FAST_MOM ? FIXED10_6(mz) : FIXED8_8(mz));
     }
 
     // Angles with 16-bit accuracy.
     if (df & MDF_ANGLE)
-        Writer_WriteInt16(::msgWriter, d->angle >> 16);
+        Writer_WriteInt16(writer, d->angle >> 16);
 
     if (df & MDF_SELECTOR)
-        Writer_WritePackedUInt16(::msgWriter, d->selector);
+        Writer_WritePackedUInt16(writer, d->selector);
     if (df & MDF_SELSPEC)
-        Writer_WriteByte(::msgWriter, d->selector >> 24);
+        Writer_WriteByte(writer, d->selector >> 24);
 
     if (df & MDF_STATE)
     {
         DENG2_ASSERT(d->state != 0);
-        Writer_WritePackedUInt16(::msgWriter, ::runtimeDefs.states.indexOf(d->state));
+        Writer_WritePackedUInt16(writer, ::runtimeDefs.states.indexOf(d->state));
     }
 
     if (df & MDF_FLAGS)
     {
-        Writer_WriteUInt32(::msgWriter, d->ddFlags & DDMF_PACK_MASK);
-        Writer_WriteUInt32(::msgWriter, d->flags);
-        Writer_WriteUInt32(::msgWriter, d->flags2);
-        Writer_WriteUInt32(::msgWriter, d->flags3);
+        Writer_WriteUInt32(writer, d->ddFlags & DDMF_PACK_MASK);
+        Writer_WriteUInt32(writer, d->flags);
+        Writer_WriteUInt32(writer, d->flags2);
+        Writer_WriteUInt32(writer, d->flags3);
     }
 
     if (df & MDF_HEALTH)
-        Writer_WriteInt32(::msgWriter, d->health);
+        Writer_WriteInt32(writer, d->health);
 
     if (df & MDF_RADIUS)
-        Writer_WriteFloat(::msgWriter, d->radius);
+        Writer_WriteFloat(writer, d->radius);
 
     if (df & MDF_HEIGHT)
-        Writer_WriteFloat(::msgWriter, d->height);
+        Writer_WriteFloat(writer, d->height);
 
     if (df & MDF_FLOORCLIP)
-        Writer_WriteFloat(::msgWriter, d->floorClip);
+        Writer_WriteFloat(writer, d->floorClip);
 
     if (df & MDFC_TRANSLUCENCY)
-        Writer_WriteByte(::msgWriter, d->translucency);
+        Writer_WriteByte(writer, d->translucency);
 
     if (df & MDFC_FADETARGET)
-        Writer_WriteByte(::msgWriter, byte( d->visTarget + 1 ));
+        Writer_WriteByte(writer, byte( d->visTarget + 1 ));
 
     if (df & MDFC_TYPE)
-        Writer_WriteInt32(::msgWriter, d->type);
+        Writer_WriteInt32(writer, d->type);
 }
 
 /**
- * The delta is written to the message buffer.
+ * The delta is written using @a writer.
  */
-void Sv_WritePlayerDelta(void const *deltaPtr)
+void Sv_WritePlayerDelta(Writer1 *writer, void const *deltaPtr)
 {
     auto const *delta    = reinterpret_cast<playerdelta_t const *>(deltaPtr);
     dt_player_t const *d = &delta->player;
     dint df              = delta->delta.flags;
 
     // First the player number. Upper three bits contain flags.
-    Writer_WriteByte(::msgWriter, delta->delta.id | (df >> 8));
+    Writer_WriteByte(writer, delta->delta.id | (df >> 8));
 
     // Flags. What elements are included in the delta?
-    Writer_WriteByte(::msgWriter, df & 0xff);
+    Writer_WriteByte(writer, df & 0xff);
 
     if (df & PDF_MOBJ)
-        Writer_WriteUInt16(::msgWriter, d->mobj);
+        Writer_WriteUInt16(writer, d->mobj);
     if (df & PDF_FORWARDMOVE)
-        Writer_WriteByte(::msgWriter, d->forwardMove);
+        Writer_WriteByte(writer, d->forwardMove);
     if (df & PDF_SIDEMOVE)
-        Writer_WriteByte(::msgWriter, d->sideMove);
+        Writer_WriteByte(writer, d->sideMove);
     /*if (df & PDF_ANGLE)
-        Writer_WriteByte(::msgWriter, d->angle >> 24);*/
+        Writer_WriteByte(writer, d->angle >> 24);*/
     if (df & PDF_TURNDELTA)
-        Writer_WriteByte(::msgWriter, (d->turnDelta * 16) >> 24);
+        Writer_WriteByte(writer, (d->turnDelta * 16) >> 24);
     if (df & PDF_FRICTION)
-        Writer_WriteByte(::msgWriter, FLT2FIX(d->friction) >> 8);
+        Writer_WriteByte(writer, FLT2FIX(d->friction) >> 8);
     if (df & PDF_EXTRALIGHT)
     {
         // Three bits is enough for fixedcolormap.
         dint const cmap = de::clamp(0, d->fixedColorMap, 7);
         // Write the five upper bytes of extraLight.
-        Writer_WriteByte(::msgWriter, cmap | (d->extraLight & 0xf8));
+        Writer_WriteByte(writer, cmap | (d->extraLight & 0xf8));
     }
     if (df & PDF_FILTER)
     {
-        Writer_WriteUInt32(::msgWriter, d->filter);
+        Writer_WriteUInt32(writer, d->filter);
         LOGDEV_NET_XVERBOSE_DEBUGONLY("Sv_WritePlayerDelta: Plr %i, filter %08x", delta->delta.id << d->filter);
     }
     if (df & PDF_PSPRITES)       // Only set if there's something to write.
@@ -384,38 +419,38 @@ void Sv_WritePlayerDelta(void const *deltaPtr)
             dint const flags       = df >> (16 + i * 8);
 
             // First the flags.
-            Writer_WriteByte(::msgWriter, flags);
+            Writer_WriteByte(writer, flags);
             if (flags & PSDF_STATEPTR)
             {
-                Writer_WritePackedUInt16(::msgWriter, psp.statePtr ? (::runtimeDefs.states.indexOf(psp.statePtr) + 1) : 0);
+                Writer_WritePackedUInt16(writer, psp.statePtr ? (::runtimeDefs.states.indexOf(psp.statePtr) + 1) : 0);
             }
             /*if (flags & PSDF_LIGHT)
             {
                 dint const light = de::clamp(0, psp.light * 255, 255);
-                Writer_WriteByte(::msgWriter, light);
+                Writer_WriteByte(writer, light);
             }*/
             if (flags & PSDF_ALPHA)
             {
                 dint const alpha = de::clamp(0.f, psp.alpha * 255, 255.f);
-                Writer_WriteByte(::msgWriter, alpha);
+                Writer_WriteByte(writer, alpha);
             }
             if (flags & PSDF_STATE)
             {
-                Writer_WriteByte(::msgWriter, psp.state);
+                Writer_WriteByte(writer, psp.state);
             }
             if (flags & PSDF_OFFSET)
             {
-                Writer_WriteByte(::msgWriter, CLAMPED_CHAR(psp.offset[VX] / 2));
-                Writer_WriteByte(::msgWriter, CLAMPED_CHAR(psp.offset[VY] / 2));
+                Writer_WriteByte(writer, CLAMPED_CHAR(psp.offset[VX] / 2));
+                Writer_WriteByte(writer, CLAMPED_CHAR(psp.offset[VY] / 2));
             }
         }
     }
 }
 
 /**
- * The delta is written to the message buffer.
+ * The delta is written using @a writer.
  */
-void Sv_WriteSectorDelta(void const *deltaPtr)
+void Sv_WriteSectorDelta(Writer1 *writer, void const *deltaPtr)
 {
     auto const *delta    = reinterpret_cast<sectordelta_t const *>(deltaPtr);
     dt_sector_t const *d = &delta->sector;
@@ -447,123 +482,123 @@ void Sv_WriteSectorDelta(void const *deltaPtr)
     }
 
     // Sector number first.
-    Writer_WriteUInt16(::msgWriter, delta->delta.id);
+    Writer_WriteUInt16(writer, delta->delta.id);
 
     // Flags.
-    Writer_WritePackedUInt32(::msgWriter, df);
+    Writer_WritePackedUInt32(writer, df);
 
     if (df & SDF_FLOOR_MATERIAL)
-        Writer_WritePackedUInt16(::msgWriter, Sv_IdForMaterial(d->planes[PLN_FLOOR].surface.material));
+        Writer_WritePackedUInt16(writer, Sv_IdForMaterial(d->planes[PLN_FLOOR].surface.material));
     if (df & SDF_CEILING_MATERIAL)
-        Writer_WritePackedUInt16(::msgWriter, Sv_IdForMaterial(d->planes[PLN_CEILING].surface.material));
+        Writer_WritePackedUInt16(writer, Sv_IdForMaterial(d->planes[PLN_CEILING].surface.material));
     if (df & SDF_LIGHT)
     {
         // Must fit into a byte.
         auto lightlevel = dint( 255.0f * d->lightLevel );
         lightlevel = (lightlevel < 0 ? 0 : lightlevel > 255 ? 255 : lightlevel);
 
-        Writer_WriteByte(::msgWriter, byte( lightlevel ));
+        Writer_WriteByte(writer, byte( lightlevel ));
     }
     if (df & SDF_FLOOR_HEIGHT)
     {
-        Writer_WriteInt16(::msgWriter, FLT2FIX(d->planes[PLN_FLOOR].height) >> 16);
+        Writer_WriteInt16(writer, FLT2FIX(d->planes[PLN_FLOOR].height) >> 16);
     }
     if (df & SDF_CEILING_HEIGHT)
     {
         LOGDEV_NET_XVERBOSE_DEBUGONLY("Sv_WriteSectorDelta: (%i) Absolute ceiling height=%f",
                                      delta->delta.id << d->planes[PLN_CEILING].height);
 
-        Writer_WriteInt16(::msgWriter, FLT2FIX(d->planes[PLN_CEILING].height) >> 16);
+        Writer_WriteInt16(writer, FLT2FIX(d->planes[PLN_CEILING].height) >> 16);
     }
     if (df & SDF_FLOOR_TARGET)
-        Writer_WriteInt16(::msgWriter, FLT2FIX(d->planes[PLN_FLOOR].target) >> 16);
+        Writer_WriteInt16(writer, FLT2FIX(d->planes[PLN_FLOOR].target) >> 16);
     if (df & SDF_FLOOR_SPEED)    // 7.1/4.4 fixed-point
-        Writer_WriteByte(::msgWriter, floorSpd);
+        Writer_WriteByte(writer, floorSpd);
     if (df & SDF_CEILING_TARGET)
-        Writer_WriteInt16(::msgWriter, FLT2FIX(d->planes[PLN_CEILING].target) >> 16);
+        Writer_WriteInt16(writer, FLT2FIX(d->planes[PLN_CEILING].target) >> 16);
     if (df & SDF_CEILING_SPEED)  // 7.1/4.4 fixed-point
-        Writer_WriteByte(::msgWriter, ceilSpd);
+        Writer_WriteByte(writer, ceilSpd);
     if (df & SDF_COLOR_RED)
-        Writer_WriteByte(::msgWriter, byte( 255 * d->rgb[0] ));
+        Writer_WriteByte(writer, byte( 255 * d->rgb[0] ));
     if (df & SDF_COLOR_GREEN)
-        Writer_WriteByte(::msgWriter, byte( 255 * d->rgb[1] ));
+        Writer_WriteByte(writer, byte( 255 * d->rgb[1] ));
     if (df & SDF_COLOR_BLUE)
-        Writer_WriteByte(::msgWriter, byte( 255 * d->rgb[2] ));
+        Writer_WriteByte(writer, byte( 255 * d->rgb[2] ));
 
     if (df & SDF_FLOOR_COLOR_RED)
-        Writer_WriteByte(::msgWriter, byte( 255 * d->planes[PLN_FLOOR].surface.rgba[0] ));
+        Writer_WriteByte(writer, byte( 255 * d->planes[PLN_FLOOR].surface.rgba[0] ));
     if (df & SDF_FLOOR_COLOR_GREEN)
-        Writer_WriteByte(::msgWriter, byte( 255 * d->planes[PLN_FLOOR].surface.rgba[1] ));
+        Writer_WriteByte(writer, byte( 255 * d->planes[PLN_FLOOR].surface.rgba[1] ));
     if (df & SDF_FLOOR_COLOR_BLUE)
-        Writer_WriteByte(::msgWriter, byte( 255 * d->planes[PLN_FLOOR].surface.rgba[2] ));
+        Writer_WriteByte(writer, byte( 255 * d->planes[PLN_FLOOR].surface.rgba[2] ));
 
     if (df & SDF_CEIL_COLOR_RED)
-        Writer_WriteByte(::msgWriter, byte( 255 * d->planes[PLN_CEILING].surface.rgba[0] ));
+        Writer_WriteByte(writer, byte( 255 * d->planes[PLN_CEILING].surface.rgba[0] ));
     if (df & SDF_CEIL_COLOR_GREEN)
-        Writer_WriteByte(::msgWriter, byte( 255 * d->planes[PLN_CEILING].surface.rgba[1] ));
+        Writer_WriteByte(writer, byte( 255 * d->planes[PLN_CEILING].surface.rgba[1] ));
     if (df & SDF_CEIL_COLOR_BLUE)
-        Writer_WriteByte(::msgWriter, byte( 255 * d->planes[PLN_CEILING].surface.rgba[2] ));
+        Writer_WriteByte(writer, byte( 255 * d->planes[PLN_CEILING].surface.rgba[2] ));
 }
 
 /**
- * The delta is written to the message buffer.
+ * The delta is written using @a writer.
  */
-void Sv_WriteSideDelta(void const *deltaPtr)
+void Sv_WriteSideDelta(Writer1 *writer, void const *deltaPtr)
 {
     auto const *delta  = (sidedelta_t const *) deltaPtr;
     dt_side_t const *d = &delta->side;
     dint            df = delta->delta.flags;
 
     // Side number first.
-    Writer_WriteUInt16(::msgWriter, delta->delta.id);
+    Writer_WriteUInt16(writer, delta->delta.id);
 
     // Flags.
-    Writer_WritePackedUInt32(::msgWriter, df);
+    Writer_WritePackedUInt32(writer, df);
 
     if (df & SIDF_TOP_MATERIAL)
-        Writer_WritePackedUInt16(::msgWriter, Sv_IdForMaterial(d->top.material));
+        Writer_WritePackedUInt16(writer, Sv_IdForMaterial(d->top.material));
     if (df & SIDF_MID_MATERIAL)
-        Writer_WritePackedUInt16(::msgWriter, Sv_IdForMaterial(d->middle.material));
+        Writer_WritePackedUInt16(writer, Sv_IdForMaterial(d->middle.material));
     if (df & SIDF_BOTTOM_MATERIAL)
-        Writer_WritePackedUInt16(::msgWriter, Sv_IdForMaterial(d->bottom.material));
+        Writer_WritePackedUInt16(writer, Sv_IdForMaterial(d->bottom.material));
 
     if (df & SIDF_LINE_FLAGS)
-        Writer_WriteByte(::msgWriter, d->lineFlags);
+        Writer_WriteByte(writer, d->lineFlags);
 
     if (df & SIDF_TOP_COLOR_RED)
-        Writer_WriteByte(::msgWriter, byte( 255 * d->top.rgba[0] ));
+        Writer_WriteByte(writer, byte( 255 * d->top.rgba[0] ));
     if (df & SIDF_TOP_COLOR_GREEN)
-        Writer_WriteByte(::msgWriter, byte( 255 * d->top.rgba[1] ));
+        Writer_WriteByte(writer, byte( 255 * d->top.rgba[1] ));
     if (df & SIDF_TOP_COLOR_BLUE)
-        Writer_WriteByte(::msgWriter, byte( 255 * d->top.rgba[2] ));
+        Writer_WriteByte(writer, byte( 255 * d->top.rgba[2] ));
 
     if (df & SIDF_MID_COLOR_RED)
-        Writer_WriteByte(::msgWriter, byte( 255 * d->middle.rgba[0] ));
+        Writer_WriteByte(writer, byte( 255 * d->middle.rgba[0] ));
     if (df & SIDF_MID_COLOR_GREEN)
-        Writer_WriteByte(::msgWriter, byte( 255 * d->middle.rgba[1] ));
+        Writer_WriteByte(writer, byte( 255 * d->middle.rgba[1] ));
     if (df & SIDF_MID_COLOR_BLUE)
-        Writer_WriteByte(::msgWriter, byte( 255 * d->middle.rgba[2] ));
+        Writer_WriteByte(writer, byte( 255 * d->middle.rgba[2] ));
     if (df & SIDF_MID_COLOR_ALPHA)
-        Writer_WriteByte(::msgWriter, byte( 255 * d->middle.rgba[3] ));
+        Writer_WriteByte(writer, byte( 255 * d->middle.rgba[3] ));
 
     if (df & SIDF_BOTTOM_COLOR_RED)
-        Writer_WriteByte(::msgWriter, byte( 255 * d->bottom.rgba[0] ));
+        Writer_WriteByte(writer, byte( 255 * d->bottom.rgba[0] ));
     if (df & SIDF_BOTTOM_COLOR_GREEN)
-        Writer_WriteByte(::msgWriter, byte( 255 * d->bottom.rgba[1] ));
+        Writer_WriteByte(writer, byte( 255 * d->bottom.rgba[1] ));
     if (df & SIDF_BOTTOM_COLOR_BLUE)
-        Writer_WriteByte(::msgWriter, byte( 255 * d->bottom.rgba[2] ));
+        Writer_WriteByte(writer, byte( 255 * d->bottom.rgba[2] ));
 
     if (df & SIDF_MID_BLENDMODE)
-        Writer_WriteInt32(::msgWriter, d->middle.blendMode);
+        Writer_WriteInt32(writer, d->middle.blendMode);
 
     if (df & SIDF_FLAGS)
-        Writer_WriteByte(::msgWriter, d->flags);
+        Writer_WriteByte(writer, d->flags);
 }
 
 /**
- * The delta is written to the message buffer.
+ * The delta is written using @a writer.
  */
-void Sv_WritePolyDelta(void const *deltaPtr)
+void Sv_WritePolyDelta(Writer1 *writer, void const *deltaPtr)
 {
     auto const  *delta = (polydelta_t const *) deltaPtr;
     dt_poly_t const *d = &delta->po;
@@ -577,36 +612,36 @@ void Sv_WritePolyDelta(void const *deltaPtr)
     }
 
     // Poly number first.
-    Writer_WritePackedUInt16(::msgWriter, delta->delta.id);
+    Writer_WritePackedUInt16(writer, delta->delta.id);
 
     // Flags.
-    Writer_WriteByte(::msgWriter, df & 0xff);
+    Writer_WriteByte(writer, df & 0xff);
 
     if (df & PODF_DEST_X)
-        Writer_WriteFloat(::msgWriter, d->dest[VX]);
+        Writer_WriteFloat(writer, d->dest[VX]);
     if (df & PODF_DEST_Y)
-        Writer_WriteFloat(::msgWriter, d->dest[VY]);
+        Writer_WriteFloat(writer, d->dest[VY]);
     if (df & PODF_SPEED)
-        Writer_WriteFloat(::msgWriter, d->speed);
+        Writer_WriteFloat(writer, d->speed);
     if (df & PODF_DEST_ANGLE)
-        Writer_WriteInt16(::msgWriter, d->destAngle >> 16);
+        Writer_WriteInt16(writer, d->destAngle >> 16);
     if (df & PODF_ANGSPEED)
-        Writer_WriteInt16(::msgWriter, d->angleSpeed >> 16);
+        Writer_WriteInt16(writer, d->angleSpeed >> 16);
 }
 
 /**
- * The delta is written to the message buffer.
+ * The delta is written using @a writer.
  */
-void Sv_WriteSoundDelta(void const *deltaPtr)
+void Sv_WriteSoundDelta(Writer1 *writer, void const *deltaPtr)
 {
     auto const *delta = (sounddelta_t const *) deltaPtr;
     dint           df = delta->delta.flags;
 
     // This is either the sound ID, emitter ID or sector index.
-    Writer_WriteUInt16(::msgWriter, delta->delta.id);
+    Writer_WriteUInt16(writer, delta->delta.id);
 
     // First the flags byte.
-    Writer_WriteByte(::msgWriter, df & 0xff);
+    Writer_WriteByte(writer, df & 0xff);
 
     switch (delta->delta.type)
     {
@@ -615,7 +650,7 @@ void Sv_WriteSoundDelta(void const *deltaPtr)
     case DT_SIDE_SOUND:
     case DT_POLY_SOUND:
         // The sound ID.
-        Writer_WriteUInt16(::msgWriter, delta->sound);
+        Writer_WriteUInt16(writer, delta->sound);
         break;
 
     default: break;
@@ -627,16 +662,16 @@ void Sv_WriteSoundDelta(void const *deltaPtr)
         if (delta->volume > 1)
         {
             // Very loud indeed.
-            Writer_WriteByte(::msgWriter, 255);
+            Writer_WriteByte(writer, 255);
         }
         else if (delta->volume <= 0)
         {
             // Silence.
-            Writer_WriteByte(::msgWriter, 0);
+            Writer_WriteByte(writer, 0);
         }
         else
         {
-            Writer_WriteByte(::msgWriter, delta->volume * 127 + 0.5f);
+            Writer_WriteByte(writer, delta->volume * 127 + 0.5f);
         }
     }
 }
@@ -644,7 +679,7 @@ void Sv_WriteSoundDelta(void const *deltaPtr)
 /**
  * Write the type and possibly the set number (for Unacked deltas).
  */
-void Sv_WriteDeltaHeader(byte type, delta_t const *delta)
+void Sv_WriteDeltaHeader(Writer1 *writer, byte type, delta_t const *delta)
 {
 #ifdef DENG2_DEBUG
     if (type >= NUM_DELTA_TYPES)
@@ -663,7 +698,7 @@ void Sv_WriteDeltaHeader(byte type, delta_t const *delta)
         type |= DT_RESENT;
     }
 
-    Writer_WriteByte(::msgWriter, type);
+    Writer_WriteByte(writer, type);
 
     // Include the set number?
     if (type & DT_RESENT)
@@ -672,26 +707,26 @@ void Sv_WriteDeltaHeader(byte type, delta_t const *delta)
         // received the set this delta belongs to, it means the delta has
         // already been received. This is needed in the situation where the
         // ack is lost or delayed.
-        Writer_WriteByte(::msgWriter, delta->set);
+        Writer_WriteByte(writer, delta->set);
 
         // Also send the unique ID of this delta. If the client has already
         // received a delta with this ID, the delta is discarded. This is
         // needed in the situation where the set is lost.
-        Writer_WriteByte(::msgWriter, delta->resend);
+        Writer_WriteByte(writer, delta->resend);
     }
 }
 
 /**
- * The delta is written to the message buffer.
+ * The delta is written using @a writer.
  */
-void Sv_WriteDelta(delta_t const *delta)
+void Sv_WriteDelta(Writer1 *writer, delta_t const *delta)
 {
     DENG2_ASSERT(delta);
 
 #ifdef _NETDEBUG
     // Extra length field in debug builds.
-    dint const lengthOffset = Msg_Offset();
-    Msg_WriteLong(0);
+    size_t const lengthOffset = Writer_Size(writer);
+    Writer_WriteInt32(writer, 0);
 #endif
 
     // Null mobj deltas are special.
@@ -700,8 +735,8 @@ void Sv_WriteDelta(delta_t const *delta)
         if (delta->flags & MDFC_NULL)
         {
             // This'll be the entire delta. No more data is needed.
-            Sv_WriteDeltaHeader(DT_NULL_MOBJ, delta);
-            Writer_WriteUInt16(::msgWriter, delta->id);
+            Sv_WriteDeltaHeader(writer, DT_NULL_MOBJ, delta);
+            Writer_WriteUInt16(writer, delta->id);
 #ifdef _NETDEBUG
             goto writeDeltaLength;
 #else
@@ -711,24 +746,24 @@ void Sv_WriteDelta(delta_t const *delta)
     }
 
     // First the type of the delta.
-    Sv_WriteDeltaHeader(delta->type, delta);
+    Sv_WriteDeltaHeader(writer, delta->type, delta);
 
     switch (delta->type)
     {
     //case DT_LUMP:   Sv_WriteLumpDelta(delta);   break;
 
-    case DT_MOBJ:   Sv_WriteMobjDelta(delta);   break;
-    case DT_PLAYER: Sv_WritePlayerDelta(delta); break;
-    case DT_SECTOR: Sv_WriteSectorDelta(delta); break;
-    case DT_SIDE:   Sv_WriteSideDelta(delta);   break;
-    case DT_POLY:   Sv_WritePolyDelta(delta);   break;
+    case DT_MOBJ:   Sv_WriteMobjDelta(writer, delta);   break;
+    case DT_PLAYER: Sv_WritePlayerDelta(writer, delta); break;
+    case DT_SECTOR: Sv_WriteSectorDelta(writer, delta); break;
+    case DT_SIDE:   Sv_WriteSideDelta(writer, delta);   break;
+    case DT_POLY:   Sv_WritePolyDelta(writer, delta);   break;
 
     case DT_SOUND:
     case DT_MOBJ_SOUND:
     case DT_SECTOR_SOUND:
     case DT_SIDE_SOUND:
     case DT_POLY_SOUND:
-        Sv_WriteSoundDelta(delta);
+        Sv_WriteSoundDelta(writer, delta);
         break;
 
     default: App_Error("Sv_WriteDelta: Unknown delta type %i.\n", delta->type);
@@ -737,22 +772,21 @@ void Sv_WriteDelta(delta_t const *delta)
 #ifdef _NETDEBUG
 writeDeltaLength:
     // Update the length of the delta.
-    dint endOffset = Msg_Offset();
-    Msg_SetOffset(lengthOffset);
-    Msg_WriteLong(endOffset - lengthOffset);
-    Msg_SetOffset(endOffset);
+    size_t const endOffset = Writer_Size(writer);
+    Writer_SetPos(writer, lengthOffset);
+    Writer_WriteInt32(writer, dint32(endOffset - lengthOffset));
+    Writer_SetPos(writer, endOffset);
 #endif
 }
 
 /**
  * Returns an estimate for the maximum frame size appropriate for the client.
- * The bandwidth rating is updated whenever a frame is sent.
+ * The estimate is updated whenever a frame is sent (see Sv_CheckBandwidth()).
  */
 dsize Sv_GetMaxFrameSize(dint playerNumber)
 {
-    DENG2_UNUSED(playerNumber);
     DENG2_ASSERT(playerNumber >= 0 && playerNumber < DDMAXPLAYERS);
-    dsize size = MINIMUM_FRAME_SIZE + FRAME_SIZE_FACTOR * 40 /* BWR_DEFAULT */;
+    dsize size = Sv_GetFrameBudget(playerNumber);
 
     // What about the communications medium?
     if (size > PROTOCOL_MAX_DATAGRAM_SIZE)
@@ -775,28 +809,24 @@ byte Sv_GetNewResendID(pool_t *pool)
 }
 
 /**
- * Send a sv_frame packet to the specified player. The amount of data sent
- * depends on the player's bandwidth rating.
+ * Compose a sv_frame packet for the specified player. The amount of data included
+ * depends on the estimated bandwidth of the player's link.
+ *
+ * Only the delta pool of the player is modified, so frames for different players
+ * can be assembled concurrently.
+ *
+ * @return  Writer containing the frame message. Send it with Sv_SendFrame().
  */
-void Sv_SendFrame(dint plrNum)
+static Writer1 *Sv_AssembleFrame(dint plrNum)
 {
     pool_t *pool = Sv_GetPool(plrNum);
-
-    // Does the send queue allow us to send this packet?
-    // Bandwidth rating is updated during the check.
-    if (!Sv_CheckBandwidth(plrNum))
-    {
-        // We cannot send anything at this time. This will only happen if
-        // the send queue has too many packets waiting to be sent.
-        return;
-    }
+    DENG2_ASSERT(pool);
 
     // The priority queue of the client needs to be rebuilt before
     // a new frame can be sent.
     Sv_RatePool(pool);
 
     // This will be a new set.
-    DENG2_ASSERT(pool);
     pool->setDealer++;
 
     // Determine the maximum size of the frame packet.
@@ -809,16 +839,16 @@ void Sv_SendFrame(dint plrNum)
 
     // If this is the first frame after a map change, use the special
     // first frame packet type.
-    Msg_Begin(pool->isFirst ? PSV_FIRST_FRAME2 : PSV_FRAME2);
+    Writer1 *writer = Msg_NewWriter(pool->isFirst ? PSV_FIRST_FRAME2 : PSV_FRAME2);
 
     // First send the gameTime of this frame.
-    Writer_WriteFloat(::msgWriter, ::gameTime);
+    Writer_WriteFloat(writer, ::gameTime);
 
     // Keep writing until the maximum size is reached.
     delta_t *delta;
     size_t lastStart;
     while ((delta = Sv_PoolQueueExtract(pool)) != nullptr &&
-          (lastStart = Writer_Size(::msgWriter)) < maxFrameSize)
+          (lastStart = Writer_Size(writer)) < maxFrameSize)
     {
         byte const oldResend = pool->resendDealer;
 
@@ -830,21 +860,19 @@ void Sv_SendFrame(dint plrNum)
             delta->resend = Sv_GetNewResendID(pool);
         }
 
-        Sv_WriteDelta(delta);
+        Sv_WriteDelta(writer, delta);
 
         // Did we go over the limit?
-        if (Writer_Size(::msgWriter) > maxFrameSize)
+        if (Writer_Size(writer) > maxFrameSize)
         {
-            /*
-            // Time to see if BWR needs to be adjusted.
-            if (::clients[plrNum].bwrAdjustTime <= 0)
+            // The budget may be too small for the link.
+            if (!pool->isFirst)
             {
-                ::clients[plrNum].bwrAdjustTime = BWR_ADJUST_TICS;
+                Sv_BandwidthFrameFull(plrNum);
             }
-            */
 
             // Cancel the last delta.
-            Writer_SetPos(::msgWriter, lastStart);
+            Writer_SetPos(writer, lastStart);
 
             // Restore the resend dealer.
             if (oldResend)
@@ -864,7 +892,19 @@ void Sv_SendFrame(dint plrNum)
         }
     }
 
-    Msg_End();
+    return writer;
+}
+
+/**
+ * Send a sv_frame packet assembled with Sv_AssembleFrame() to the specified player.
+ *
+ * @param frame  Frame message. The writer is deleted.
+ */
+static void Sv_SendFrame(dint plrNum, Writer1 *frame)
+{
+    pool_t *pool = Sv_GetPool(plrNum);
+
+    Msg_EndWriter(frame);
 
     Net_SendBuffer(plrNum, 0);
 
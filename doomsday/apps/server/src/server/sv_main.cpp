@@ -46,6 +46,7 @@
 #include "api_server.h"
 #include "serversystem.h"
 #include "server/sv_def.h"
+#include "server/sv_bandwidth.h"
 #include "server/sv_pool.h"
 
 using namespace de;
@@ -556,6 +557,7 @@ void Sv_GetPackets(void)
                 sender->shakePing = Timer_RealMilliseconds() - sender->shakePing;
                 LOG_NET_MSG("Client %i ping at handshake: %i ms")
                         << netconsole << sender->shakePing;
+                Sv_BandwidthHandshakeTime(netconsole, sender->shakePing);
             }
             break;
 
@@ -574,9 +576,14 @@ void Sv_GetPackets(void)
                         ddpl->fixCounter.mom);
             break; }
 
-        case PKT_PING:
+        case PKT_PING: {
+            // Pings sent by the link estimator are handled separately.
+            size_t const pos = Reader_Pos(msgReader);
+            if (Sv_BandwidthPingResponse(netBuffer.player, Reader_ReadUInt32(msgReader)))
+                break;
+            Reader_SetPos(msgReader, pos);
             Net_PingResponse();
-            break;
+            break; }
 
         case PCL_HELLO:
         case PCL_HELLO2:
@@ -631,6 +638,7 @@ dd_bool Sv_PlayerArrives(unsigned int nodeID, char const *name)
             plr->remoteUserId = nodeID;
             plr->lastTransmit = -1;
             plr->ready = false;
+            Sv_ResetBandwidth(i);
             plr->viewConsole = i;
             strncpy(plr->name, name, PLAYERNAMELEN);
 
@@ -839,6 +847,7 @@ void Sv_StartNetGame(void)
         plr->lastTransmit = -1;
         plr->ready = false;
         plr->enterTime = 0;
+        Sv_ResetBandwidth(i);
         plr->fov = 90;
         plr->viewConsole = -1;
         de::zap(plr->name);
@@ -1054,57 +1063,6 @@ int Sv_GetNumConnected(void)
     return count;
 }
 
-/**
- * The bandwidth rating is updated according to the status of the
- * player's send queue. Returns true if a new packet may be sent.
- *
- * @todo This functionality needs to be restored: servers can't simply output
- * an arbitrary amount of data to clients with no regard to the available
- * bandwidth.
- */
-dd_bool Sv_CheckBandwidth(int /*playerNumber*/)
-{
-    return true;
-    /*
-    client_t           *client = &clients[playerNumber];
-    uint                qSize = N_GetSendQueueSize(playerNumber);
-    uint                limit = 400;
-
-    return true;
-
-    // If there are too many messages in the queue, the player's bandwidth
-    // is overrated.
-    if (qSize > limit)
-    {
-        // Drop quickly to allow the send queue to clear out sooner.
-        client->bandwidthRating -= 10;
-    }
-
-    // If the send queue is practically empty, we can use more bandwidth.
-    // (Providing we have BWR adjust time.)
-    if (qSize < limit / 20 && client->bwrAdjustTime > 0)
-    {
-        client->bandwidthRating++;
-
-        // Increase BWR only once during the adjust time.
-        client->bwrAdjustTime = 0;
-    }
-
-    // Do not go past the boundaries, though.
-    if (client->bandwidthRating < 0)
-    {
-        client->bandwidthRating = 0;
-    }
-    if (client->bandwidthRating > MAX_BANDWIDTH_RATING)
-    {
-        client->bandwidthRating = MAX_BANDWIDTH_RATING;
-    }
-
-    // New messages will not be sent if there's too much already.
-    return qSize <= 10 * limit;
-    */
-}
-
 /**
  * Reads a PKT_COORDS packet from the message buffer. We trust the
  * client's position and change ours to match it. The client better not
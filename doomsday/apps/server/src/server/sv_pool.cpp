@@ -23,8 +23,12 @@
 
 #include "de_base.h"
 #include "server/sv_pool.h"
+#include "server/sv_visibility.h"
 
 #include <cmath>
+#include <QBitArray>
+#include <QSet>
+#include <QVector>
 #include <de/mathutil.h>
 #include <de/timer.h>
 #include <de/vector1.h>
@@ -36,6 +40,7 @@
 #include "world/p_object.h"
 #include "world/p_players.h"
 #include "world/thinkers.h"
+#include "Line"
 #include "Sector"
 
 using namespace de;
@@ -48,6 +53,9 @@ using namespace de;
 // Maximum difference in plane height where the absolute height doesn't need to be sent.
 #define PLANE_SKIP_LIMIT            ( 40 )
 
+// Score multiplier for deltas the pool owner is unable to see.
+#define HIDDEN_DELTA_SCORE_FACTOR   ( .05f )
+
 struct reg_mobj_t
 {
     reg_mobj_t *next;  ///< In the register hash.
@@ -91,6 +99,42 @@ cregister_t initialRegister;
 
 static dfloat deltaBaseScores[NUM_DELTA_TYPES];
 
+/**
+ * Map elements of one type that have changed since the world register was last
+ * updated. Changes are noted by the setters of the elements' properties, so only
+ * these elements need to be compared against the register.
+ */
+struct DirtySet
+{
+    QBitArray marked;
+    QVector<dint> indices;  ///< In the order they were marked.
+
+    void reset(dint count)
+    {
+        marked.fill(false, count);
+        indices.clear();
+    }
+
+    void mark(dint index)
+    {
+        if (index < 0 || index >= marked.size() || marked.testBit(index)) return;
+        marked.setBit(index);
+        indices.append(index);
+    }
+
+    void clear()
+    {
+        for (dint index : indices) marked.clearBit(index);
+        indices.clear();
+    }
+};
+
+static DirtySet dirtySectors;
+static DirtySet dirtySides;
+
+/// Mobjs moved, created or changed state since the world register was last updated.
+static QSet<thid_t> dirtyMobjs;
+
 // Keep this zeroed out. Used if the register doesn't have data for
 // the mobj being compared.
 static ThinkerT<dt_mobj_t> dummyZeroMobj;
@@ -154,6 +198,13 @@ void Sv_InitPools()
     Sv_RegisterWorld(&::worldRegister, false);
     Sv_RegisterWorld(&::initialRegister, true);
 
+    // Nothing has changed yet.
+    ::dirtySectors.reset(worldSys().map().sectorCount());
+    ::dirtySides  .reset(worldSys().map().sideCount());
+    ::dirtyMobjs.clear();
+
+    Sv_InitVisibility();
+
     // How much time did we spend?
     LOG_MAP_VERBOSE("World registered in %.2f seconds") << startedAt.since();
 }
@@ -163,7 +214,7 @@ void Sv_InitPools()
  */
 void Sv_ShutdownPools()
 {
-    // Nothing to do.
+    Sv_ShutdownVisibility();
 }
 
 /**
@@ -911,6 +962,49 @@ dd_bool Sv_RegisterComparePoly(cregister_t *reg, dint number, polydelta_t *d)
     return !Sv_IsVoidDelta(d);
 }
 
+void Sv_MapElementChanged(world::MapElement const &element)
+{
+    world::MapElement const *elem = &element;
+
+    // Surfaces are attributed to their plane or line side, planes to their sector.
+    if (elem->type() == DMU_SURFACE && elem->hasParent()) elem = &elem->parent();
+    if (elem->type() == DMU_PLANE && elem->hasParent())
+    {
+        elem = &elem->parent();
+
+        // Mobjs in the sector are moved with its planes without being relinked.
+        for (mobj_t *mo = elem->as<Sector>().firstMobj(); mo; mo = mo->sNext)
+        {
+            Sv_MobjChanged(*mo);
+        }
+    }
+
+    switch (elem->type())
+    {
+    case DMU_SECTOR:
+        ::dirtySectors.mark(elem->indexInMap());
+        break;
+
+    case DMU_SIDE:
+        ::dirtySides.mark(elem->indexInMap());
+        break;
+
+    case DMU_LINE: {
+        // Line flags are included in the side deltas.
+        Line const &line = elem->as<Line>();
+        ::dirtySides.mark(line.front().indexInMap());
+        ::dirtySides.mark(line.back ().indexInMap());
+        break; }
+
+    default: break;
+    }
+}
+
+void Sv_MobjChanged(mobj_t const &mob)
+{
+    if (mob.thinker.id) ::dirtyMobjs.insert(mob.thinker.id);
+}
+
 /**
  * Returns @c true if the map-object can be excluded from delta processing.
  */
@@ -993,6 +1087,9 @@ void Sv_UpdateOwnerInfo(pool_t *pool)
     // Pointer to the owner's pool.
     info->pool = pool;
 
+    // Where is the owner looking from?
+    info->viewSector = Sv_VisibilitySector(plr->publicData().mo);
+
     if (plr->publicData().mo)
     {
         mobj_t *mob = plr->publicData().mo;
@@ -2091,34 +2188,100 @@ void Sv_NewNullDeltas(cregister_t *reg, dd_bool doUpdate, pool_t **targets)
     }
 }
 
+/**
+ * Compares a mobj against the register and adds the resulting delta to the pools.
+ */
+static void Sv_NewMobjDelta(cregister_t *reg, mobj_t const &mob, dd_bool doUpdate, pool_t **targets)
+{
+    // Some objects should not be processed.
+    if (Sv_IsMobjIgnored(mob)) return;
+
+    // Compare to produce a delta.
+    mobjdelta_t delta;
+    if (Sv_RegisterCompareMobj(reg, &mob, &delta))
+    {
+        Sv_AddDeltaToPools(&delta, targets);
+
+        if (doUpdate)
+        {
+            // This'll add a new register-mobj if it doesn't already exist.
+            Sv_RegisterMobj(&Sv_RegisterAddMobj(reg, mob.thinker.id)->mo, &mob);
+        }
+    }
+}
+
 /**
  * Mobj deltas are generated for all mobjs that have changed.
+ *
+ * When comparing against the world register, only the mobjs marked by
+ * Sv_MobjChanged() are compared, plus the player mobjs (whose angles are
+ * written directly from the player's commands). Mobjs are marked when created,
+ * linked, or when their state changes, and for as long as they keep moving.
+ * Fields that the game writes directly without any of these (for instance,
+ * health lost without a pain state) are sent with the mobj's next marked
+ * change.
  */
 void Sv_NewMobjDeltas(cregister_t *reg, dd_bool doUpdate, pool_t **targets)
 {
-    worldSys().map().thinkers().forAll(reinterpret_cast<thinkfunc_t>(gx.MobjThinker),
-                                       0x1 /*public*/, [&reg, &doUpdate, &targets] (thinker_t *th)
+    thinkfunc_t const mobjThinker = reinterpret_cast<thinkfunc_t>(gx.MobjThinker);
+    auto &thinkers = worldSys().map().thinkers();
+
+    // When comparing against an initial register, always compare all
+    // mobjs (since the comparing is only done once, not continuously).
+    if (reg->isInitial)
     {
-        auto &mob = *reinterpret_cast<mobj_t *>(th);
+        thinkers.forAll(mobjThinker, 0x1 /*public*/, [&reg, &doUpdate, &targets] (thinker_t *th)
+        {
+            Sv_NewMobjDelta(reg, *reinterpret_cast<mobj_t *>(th), doUpdate, targets);
+            return LoopContinue;
+        });
+        return;
+    }
+
+    QSet<thid_t> toCompare = ::dirtyMobjs;
+    if (doUpdate) ::dirtyMobjs.clear();
 
-        // Some objects should not be processed.
-        if (!Sv_IsMobjIgnored(mob))
+    for (dint i = 0; i < DDMAXPLAYERS; ++i)
+    {
+        if (mobj_t const *mo = DD_Player(i)->publicData().mo)
         {
-            // Compare to produce a delta.
-            mobjdelta_t delta;
-            if (Sv_RegisterCompareMobj(reg, &mob, &delta))
-            {
-                Sv_AddDeltaToPools(&delta, targets);
+            toCompare.insert(mo->thinker.id);
+        }
+    }
 
-                if (doUpdate)
-                {
-                    // This'll add a new register-mobj if it doesn't already exist.
-                    Sv_RegisterMobj(&Sv_RegisterAddMobj(reg, mob.thinker.id)->mo, &mob);
-                }
-            }
+    for (thid_t id : toCompare)
+    {
+        mobj_t const *mob = thinkers.mobjById(id);
+        if (!mob || mob->thinker.function != mobjThinker) continue;
+
+        Sv_NewMobjDelta(reg, *mob, doUpdate, targets);
+
+        // Moving mobjs may change without being relinked (e.g., when falling),
+        // so they are compared again next frame.
+        if (doUpdate && (!fequal(mob->mom[0], 0) || !fequal(mob->mom[1], 0) ||
+                         !fequal(mob->mom[2], 0)))
+        {
+            Sv_MobjChanged(*mob);
+        }
+    }
+
+#ifdef DENG2_DEBUG
+    // Cross-check the change tracking. Any mobjs that changed without being marked
+    // are marked now, so they will be sent next frame.
+    thinkers.forAll(mobjThinker, 0x1 /*public*/, [&reg, &toCompare] (thinker_t *th)
+    {
+        auto const &mob = *reinterpret_cast<mobj_t *>(th);
+        mobjdelta_t check;
+        if (!toCompare.contains(mob.thinker.id) && !Sv_IsMobjIgnored(mob) &&
+            Sv_RegisterCompareMobj(reg, &mob, &check))
+        {
+            LOGDEV_NET_WARNING("Mobj %i changed without being marked (delta flags: %x)")
+                << mob.thinker.id << check.delta.flags;
+            Sv_MobjChanged(mob);
         }
         return LoopContinue;
     });
+#endif
 }
 
 /**
@@ -2203,59 +2366,86 @@ void Sv_NewPlayerDeltas(cregister_t* reg, dd_bool doUpdate, pool_t** targets)
 }
 
 /**
- * Sector deltas are generated for changed sectors.
+ * Generates deltas for the elements marked in @a dirty, or for all elements when
+ * comparing against an initial register (the comparing is only done once, not
+ * continuously). Debug builds cross-check the change tracking by comparing all
+ * the other elements, too; any that have changed are marked, so they will be sent
+ * next frame.
  */
-void Sv_NewSectorDeltas(cregister_t *reg, dd_bool doUpdate, pool_t **targets)
+template <typename DeltaType, typename CompareFunc>
+static void Sv_NewDirtyElementDeltas(cregister_t *reg, dd_bool doUpdate, pool_t **targets,
+                                     DirtySet &dirty, dint count, char const *typeName,
+                                     CompareFunc compare)
 {
-    sectordelta_t delta;
+    DeltaType delta;
 
-    for (int i = 0; i < worldSys().map().sectorCount(); ++i)
+    if (reg->isInitial)
     {
-        if (Sv_RegisterCompareSector(reg, i, &delta, doUpdate))
+        for (dint i = 0; i < count; ++i)
         {
-            Sv_AddDeltaToPools(&delta, targets);
+            if (compare(reg, i, &delta, doUpdate))
+            {
+                Sv_AddDeltaToPools(&delta, targets);
+            }
         }
+        return;
     }
-}
 
-/**
- * Side deltas are generated for changed sides (and line flags).
- * Changes in sides (textures) are so rare that all sides need not be
- * checked on every tic.
- */
-void Sv_NewSideDeltas(cregister_t *reg, dd_bool doUpdate, pool_t **targets)
-{
-    static uint numShifts = 2, shift = 0;
+    QVector<dint> const toCompare = dirty.indices;
+    if (doUpdate) dirty.clear();
 
-    /// @todo fixme: Do not assume the current map.
-    world::Map &map = worldSys().map();
-
-    // When comparing against an initial register, always compare all
-    // sides (since the comparing is only done once, not continuously).
-    uint start, end;
-    if (reg->isInitial)
+    for (dint i : toCompare)
     {
-        start = 0;
-        end = map.sideCount();
-    }
-    else
-    {
-        // Because there are so many sides in a typical map, the number
-        // of compared sides soon accumulates to millions. To reduce the
-        // load, we'll check only a portion of all sides for a frame.
-        start = shift * map.sideCount() / numShifts;
-        end = ++shift * map.sideCount() / numShifts;
-        shift %= numShifts;
+        if (compare(reg, i, &delta, doUpdate))
+        {
+            Sv_AddDeltaToPools(&delta, targets);
+        }
     }
 
-    sidedelta_t delta;
-    for (uint i = start; i < end; ++i)
+#ifdef DENG2_DEBUG
+    QBitArray wasCompared(count);
+    for (dint i : toCompare) wasCompared.setBit(i);
+
+    for (dint i = 0; i < count; ++i)
     {
-        if (Sv_RegisterCompareSide(reg, i, &delta, doUpdate))
+        DeltaType check;
+        if (!wasCompared.testBit(i) && compare(reg, i, &check, false))
         {
-            Sv_AddDeltaToPools(&delta, targets);
+            LOGDEV_NET_WARNING("%s %i changed without being marked") << typeName << i;
+            dirty.mark(i);
         }
     }
+#else
+    DENG2_UNUSED(typeName);
+#endif
+}
+
+/**
+ * Sector deltas are generated for changed sectors. Only the sectors marked by
+ * Sv_MapElementChanged() are compared: plane heights, targets and speeds, plane
+ * surfaces, and the sector's lighting all have setters that mark the sector.
+ */
+void Sv_NewSectorDeltas(cregister_t *reg, dd_bool doUpdate, pool_t **targets)
+{
+    /// @todo fixme: Do not assume the current map.
+    Sv_NewDirtyElementDeltas<sectordelta_t>(reg, doUpdate, targets, ::dirtySectors,
+                                            worldSys().map().sectorCount(), "Sector",
+                                            Sv_RegisterCompareSector);
+}
+
+/**
+ * Side deltas are generated for changed sides (and line flags). Only the sides
+ * marked by Sv_MapElementChanged() are compared.
+ */
+void Sv_NewSideDeltas(cregister_t *reg, dd_bool doUpdate, pool_t **targets)
+{
+    /// @todo fixme: Do not assume the current map.
+    Sv_NewDirtyElementDeltas<sidedelta_t>(reg, doUpdate, targets, ::dirtySides,
+                                          worldSys().map().sideCount(), "Side",
+                                          [] (cregister_t *r, dint i, sidedelta_t *d, byte update)
+    {
+        return Sv_RegisterCompareSide(r, duint(i), d, update);
+    });
 }
 
 /**
@@ -2635,6 +2825,23 @@ dd_bool Sv_IsPostponedDelta(void* deltaPtr, ownerinfo_t* info)
     return false;
 }
 
+/**
+ * Determines whether the entity of the delta might be visible to the owner of the
+ * pool. Sounds are always considered visible.
+ */
+dd_bool Sv_IsPotentiallyVisibleDelta(delta_t const *delta, ownerinfo_t const *info)
+{
+    if (delta->type == DT_MOBJ)
+    {
+        return Sv_IsMobjPotentiallyVisible(info->viewSector, &((mobjdelta_t const *) delta)->mo);
+    }
+    if (delta->type == DT_SECTOR)
+    {
+        return Sv_IsSectorPotentiallyVisible(info->viewSector, delta->id);
+    }
+    return true;
+}
+
 /**
  * Calculate a priority score for the delta. A higher score indicates
  * greater importance.
@@ -2679,6 +2886,11 @@ dd_bool Sv_RateDelta(void* deltaPtr, ownerinfo_t* info)
     // Deltas become more important with age (milliseconds).
     score *= 1 + age / (ageScoreDouble * 1000.0f);
 
+    // Things that can't be seen are not that important. They will be sent
+    // when there is room in the frame.
+    if (!Sv_IsPotentiallyVisibleDelta(delta, info))
+        score *= HIDDEN_DELTA_SCORE_FACTOR;
+
     /// @todo Consider viewpoint speed and angle.
 
     // Priority bonuses based on the contents of the delta.
@@ -2857,3 +3069,21 @@ uint Sv_CountUnackedDeltas(uint clientNumber)
     }
     return count;
 }
+
+/**
+ * Debugging metric: number of deltas waiting in the client's pool, whether or not
+ * they have already been sent.
+ */
+uint Sv_CountQueuedDeltas(uint clientNumber)
+{
+    pool_t *pool = Sv_GetPool(clientNumber);
+    uint count = 0;
+    for (int i = 0; i < POOL_HASH_SIZE; ++i)
+    {
+        for (delta_t *delta = pool->hash[i].first; delta; delta = delta->next)
+        {
+            ++count;
+        }
+    }
+    return count;
+}
@@ -0,0 +1,139 @@
+/** @file sv_visibility.cpp  Delta Pool Visibility.
+ *
+ * @authors Copyright © 2026 agent <agent@local>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#include "de_base.h"
+#include "server/sv_visibility.h"
+
+#include <de/Block>
+#include <de/Log>
+#include <doomsday/filesys/file.h>
+#include <doomsday/filesys/lumpindex.h>
+
+#include "world/clientserverworld.h"
+#include "world/map.h"
+#include "world/p_object.h"
+#include "BspLeaf"
+#include "Sector"
+
+using namespace de;
+
+dint svVisibility = 1;  ///< Use REJECT data to lower the priority of unseen deltas.
+
+/// The REJECT matrix has one bit for each pair of (archived) sectors. A set bit means
+/// the sectors cannot be seen from each other.
+static Block rejectMatrix;
+static dint rejectSectorCount;
+
+void Sv_InitVisibility()
+{
+    LOG_AS("Sv_InitVisibility");
+
+    Sv_ShutdownVisibility();
+
+    world::Map &map = worldSys().map();
+    if (!map.hasManifest()) return;
+
+    File1 *lump = map.manifest().recognizer().lumps().value(Id1MapRecognizer::RejectData);
+    if (!lump || !lump->size())
+    {
+        LOG_NET_VERBOSE("Map has no REJECT data; deltas are prioritized by distance only");
+        return;
+    }
+
+    Block data(lump->size());
+    lump->read(data.data(), true /*try the cache*/);
+
+    // Node builders often write an all-zero matrix in place of real data. It claims
+    // that every sector can see every other one, so nothing would ever be lowered
+    // in priority; the per-delta lookups are skipped altogether instead.
+    if (data.count('\0') == data.size())
+    {
+        LOG_NET_VERBOSE("REJECT data of the map is all zeros; deltas are prioritized by "
+                        "distance only");
+        return;
+    }
+
+    // The matrix is indexed using the original sector indices.
+    dint sectorCount = 0;
+    map.forAllSectors([&sectorCount] (Sector &sector)
+    {
+        sectorCount = de::max(sectorCount, sector.indexInArchive() + 1);
+        return LoopContinue;
+    });
+
+    if (dsize(data.size()) * 8 < dsize(sectorCount) * dsize(sectorCount))
+    {
+        // Missing bits are treated as visible.
+        LOG_NET_VERBOSE("REJECT data is incomplete (%i bytes for %i sectors)")
+                << data.size() << sectorCount;
+    }
+
+    rejectMatrix      = data;
+    rejectSectorCount = sectorCount;
+
+    LOG_NET_VERBOSE("Using REJECT data of %i sectors for delta visibility") << sectorCount;
+}
+
+void Sv_ShutdownVisibility()
+{
+    rejectMatrix.clear();
+    rejectSectorCount = 0;
+}
+
+/**
+ * Returns @c true if the (archived) sectors @a from and @a to cannot be seen from
+ * each other according to the REJECT matrix.
+ */
+static bool Sv_IsRejected(dint from, dint to)
+{
+    if (from < 0 || to < 0 || from >= rejectSectorCount || to >= rejectSectorCount)
+    {
+        return false;
+    }
+    dsize const bit = dsize(from) * dsize(rejectSectorCount) + dsize(to);
+    if (bit / 8 >= dsize(rejectMatrix.size()))
+    {
+        return false;
+    }
+    return (rejectMatrix.at(dint(bit / 8)) & (1 << (bit % 8))) != 0;
+}
+
+dint Sv_VisibilitySector(mobj_t const *mob)
+{
+    if (!::svVisibility || rejectMatrix.isEmpty()) return -1;
+    if (!mob || !Mobj_IsLinked(*mob)) return -1;
+
+    Sector const *sector = Mobj_BspLeafAtOrigin(*mob).sectorPtr();
+    return sector? sector->indexInArchive() : -1;
+}
+
+dd_bool Sv_IsSectorPotentiallyVisible(dint viewSector, dint sectorIndex)
+{
+    if (viewSector < 0) return true;
+
+    Sector const &sector = worldSys().map().sector(sectorIndex);
+    return !Sv_IsRejected(viewSector, sector.indexInArchive());
+}
+
+dd_bool Sv_IsMobjPotentiallyVisible(dint viewSector, mobj_t const *mob)
+{
+    if (viewSector < 0 || !mob || !Mobj_IsLinked(*mob)) return true;
+
+    Sector const *sector = Mobj_BspLeafAtOrigin(*mob).sectorPtr();
+    return !sector || !Sv_IsRejected(viewSector, sector->indexInArchive());
+}
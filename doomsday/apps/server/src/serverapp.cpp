@@ -245,7 +245,7 @@ void ServerApp::initialize()
     }
 #endif
 
-    if (!CommandLine_Exists("-stdout"))
+    if (!CommandLine_Exists("-stdout") && !CommandLine_Exists("-timedemo"))
     {
         // In server mode, stay quiet on the standard outputs.
         LogBuffer::get().enableStandardOutput(false);
@@ -317,6 +317,7 @@ shell::ServerInfo ServerApp::currentServerInfo() // static
     {
         flags |= shell::ServerInfo::AllowJoin;
     }
+    flags |= shell::ServerInfo::StreamCompression;
     info.setFlags(flags);
 
     // Identifier of the current map.
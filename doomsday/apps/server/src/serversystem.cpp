@@ -22,12 +22,16 @@
 #include <de/c_wrapper.h>
 #include <de/timer.h>
 #include <de/Address>
+#include <de/ArrayValue>
 #include <de/Beacon>
 #include <de/ByteRefArray>
 #include <de/Garbage>
 #include <de/ListenSocket>
+#include <de/RecordValue>
 #include <de/TextApp>
 
+#include <QElapsedTimer>
+
 #include "api_console.h"
 
 #include "serverapp.h"
@@ -36,7 +40,9 @@
 #include "remotefeeduser.h"
 
 #include "server/sv_def.h"
+#include "server/sv_bandwidth.h"
 #include "server/sv_frame.h"
+#include "server/sv_pool.h"
 
 #include "network/net_main.h"
 #include "network/net_buf.h"
@@ -55,6 +61,10 @@ using namespace de;
 char *nptIPAddress = (char *) ""; ///< Public domain for clients to connect to (cvar).
 int   nptIPPort    = 0; ///< Server TCP port (cvar).
 
+/// Number of latest ticks over which the maximum tick time is reported
+/// (one second when clients are connected).
+static int const TICK_TIME_WINDOW = 35;
+
 static de::duint16 Server_ListenPort()
 {
     return (!nptIPPort ? DEFAULT_TCP_PORT : nptIPPort);
@@ -74,6 +84,12 @@ DENG2_PIMPL(ServerSystem)
     ShellUsers shellUsers;
     Users remoteFeedUsers;
 
+    // Time spent running the server's ticks (nanoseconds).
+    QElapsedTimer tickTimer;
+    duint64 tickCount = 0;
+    dint64 tickTimeTotal = 0;
+    dint64 recentTickTimes[TICK_TIME_WINDOW] {}; ///< Indexed by tick count (modulo).
+
     Impl(Public *i) : Base(i) {}
     ~Impl() { deinit(); }
 
@@ -208,6 +224,30 @@ DENG2_PIMPL(ServerSystem)
                         << (Timer_RealSeconds() - plr->enterTime);
             }
         }
+        for (int i = 1; i < DDMAXPLAYERS; ++i)
+        {
+            player_t *plr = DD_Player(i);
+            if (!plr->remoteUserId) continue;
+
+            if (Socket const *socket = users[plr->remoteUserId]->socket())
+            {
+                LOG_NET_MSG("%2i compression%s: %s")
+                        << i
+                        << (socket->isStreamCompressionEnabled()? " (stream)" : "")
+                        << socket->compressionStats().asText();
+            }
+
+            BandwidthEstimate const &link = Sv_GetBandwidthEstimate(i);
+            LOG_NET_MSG("%2i link: RTT %i ms, %.1f KB/s%s, %i bytes buffered, "
+                        "frame budget %i bytes, interval %i tics")
+                    << i
+                    << int(link.rtt * 1000)
+                    << link.throughput / 1000
+                    << (link.congested? " (congested)" : "")
+                    << link.buffered
+                    << link.frameBudget
+                    << link.frameInterval;
+        }
         if (first)
         {
             LOG_MSG("No clients connected");
@@ -315,6 +355,8 @@ void ServerSystem::timeChanged(Clock const &clock)
     // Adjust loop rate depending on whether users are connected.
     DENG2_TEXT_APP->loop().setRate(userCount()? 35 : 3);
 
+    d->tickTimer.start();
+
     Loop_RunTics();
 
     // Update clients at regular intervals.
@@ -326,6 +368,11 @@ void ServerSystem::timeChanged(Clock const &clock)
     /// them right away.
     Sv_GetPackets();
 
+    dint64 const tickTime = d->tickTimer.nsecsElapsed();
+    d->recentTickTimes[d->tickCount % TICK_TIME_WINDOW] = tickTime;
+    d->tickCount++;
+    d->tickTimeTotal += tickTime;
+
     /// @todo Kick unjoined nodes who are silent for too long.
 }
 
@@ -366,6 +413,51 @@ void ServerSystem::printStatus()
     d->printStatus();
 }
 
+Record ServerSystem::statistics() const
+{
+    dint64 tickTimeMax = 0;
+    for (dint64 tickTime : d->recentTickTimes)
+    {
+        tickTimeMax = de::max(tickTimeMax, tickTime);
+    }
+
+    Record stats;
+    stats.set("tickCount", d->tickCount);
+    stats.set("tickTime", d->tickTimeTotal / 1.0e9);
+    stats.set("tickTimeMax", tickTimeMax / 1.0e9);
+    stats.set("gameTime", ::gameTime);
+
+    ArrayValue &clients = stats.addArray("clients").value<ArrayValue>();
+    for (int i = 1; i < DDMAXPLAYERS; ++i)
+    {
+        player_t *plr = DD_Player(i);
+        if (!plr->remoteUserId || !d->users.contains(plr->remoteUserId)) continue;
+
+        Socket const *socket = d->users[plr->remoteUserId]->socket();
+        Socket::CompressionStats const comp =
+                (socket? socket->compressionStats() : Socket::CompressionStats());
+
+        Record *client = new Record;
+        client->set("console", i);
+        client->set("name", plr->name);
+        client->set("ready", plr->ready);
+        client->set("sentBytes", comp.sentCompressedBytes);
+        client->set("sentPayloadBytes", comp.sentPayloadBytes);
+        client->set("maxFrameSize", Sv_GetMaxFrameSize(i));
+        client->set("unackedDeltas", Sv_CountUnackedDeltas(i));
+        client->set("queuedDeltas", Sv_CountQueuedDeltas(i));
+
+        BandwidthEstimate const &link = Sv_GetBandwidthEstimate(i);
+        client->set("rtt", link.rtt);
+        client->set("throughput", link.throughput);
+        client->set("buffered", link.buffered);
+        client->set("congested", link.congested);
+        client->set("frameInterval", link.frameInterval);
+        clients.add(new RecordValue(client, RecordValue::OwnsRecord));
+    }
+    return stats;
+}
+
 ServerSystem &App_ServerSystem()
 {
     return ServerApp::serverSystem();
@@ -44,6 +44,14 @@ if (DENG_FAKE_MEMORY_ZONE)
     add_definitions (-DLIBDENG_FAKE_MEMORY_ZONE=1)
 endif ()
 
+option (DENG_ZONE_CALL_SITES
+    "(Debug) Record the source location of memory zone allocations for profiling"
+    OFF
+)
+if (DENG_ZONE_CALL_SITES)
+    add_definitions (-DLIBDENG_ZONE_CALL_SITES=1)
+endif ()
+
 option (DENG_ENABLE_COUNTED_TRACING
     "(Debug) Keep track of where de::Counted objects are allocated"
     OFF
@@ -0,0 +1,148 @@
+/** @file taskgroup.h  Group of fine-grained concurrent tasks.
+ *
+ * @authors Copyright © 2026 agent <agent@local>
+ *
+ * @par License
+ * LGPL: http://www.gnu.org/licenses/lgpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details. You should have received a copy of
+ * the GNU Lesser General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#ifndef LIBDENG2_TASKGROUP_H
+#define LIBDENG2_TASKGROUP_H
+
+#include "../libcore.h"
+#include "../math.h"
+#include <QVector>
+#include <functional>
+
+namespace de {
+
+/**
+ * Group of concurrent tasks that are waited for together. @ingroup concurrency
+ *
+ * TaskGroup is meant for fine-grained fork/join parallelism. The tasks are plain
+ * functions that are run by the engine's shared worker threads (the same ones that
+ * run TaskPool tasks). A task started in a worker thread is queued to that worker,
+ * and idle workers steal queued tasks from each other.
+ *
+ * Unlike TaskPool::waitForDone(), wait() does not just block: queued tasks of the
+ * group are executed in the waiting thread until all of them are finished. Tasks of
+ * the group may start more tasks in the same group.
+ *
+ * If a task throws a de::Error, the first such error is rethrown by wait() after all
+ * the tasks have finished. The destructor only logs it.
+ */
+class DENG2_PUBLIC TaskGroup
+{
+public:
+    typedef std::function<void ()> Function;
+
+public:
+    TaskGroup();
+
+    /**
+     * Waits until all the tasks of the group have finished.
+     */
+    ~TaskGroup();
+
+    /**
+     * Starts a new task in the group.
+     *
+     * @param func  Function to call.
+     */
+    void start(Function func);
+
+    /**
+     * Returns when all the started tasks have finished. Meanwhile, queued tasks of
+     * the group are executed in the calling thread.
+     *
+     * If any of the tasks threw a de::Error, the first one is rethrown here.
+     */
+    void wait();
+
+    /**
+     * Determines if all the started tasks have finished.
+     */
+    bool isDone() const;
+
+    /**
+     * Returns the number of worker threads.
+     */
+    static int workerCount();
+
+private:
+    DENG2_PRIVATE(d)
+};
+
+/**
+ * Calls @a func concurrently for subranges of [@a begin, @a end) and returns when all
+ * of them have been processed. The range is split recursively, so idle workers can
+ * steal the larger pieces. A de::Error thrown by @a func is rethrown to the caller.
+ *
+ * @param begin      Start of the range.
+ * @param end        End of the range (exclusive).
+ * @param func       Called with the start and end of each subrange.
+ * @param grainSize  Maximum size of a subrange. If zero, a size is chosen based on
+ *                   the number of worker threads.
+ */
+DENG2_PUBLIC void parallelFor(int begin, int end, std::function<void (int, int)> const &func,
+                              int grainSize = 0);
+
+/**
+ * Default subrange size for parallelFor() when dividing @a count elements.
+ */
+DENG2_PUBLIC int parallelGrainSize(int count);
+
+/**
+ * Maps subranges of [@a begin, @a end) concurrently to values, and reduces them to
+ * a single value. The subranges are reduced in order, so @a reduce does not need to
+ * be commutative.
+ *
+ * @param begin      Start of the range.
+ * @param end        End of the range (exclusive).
+ * @param identity   Initial value of the reduction.
+ * @param map        Called with the start and end of each subrange; returns a Type.
+ * @param reduce     Combines two Type values.
+ * @param grainSize  Maximum size of a subrange (zero for automatic).
+ */
+template <typename Type, typename MapFunc, typename ReduceFunc>
+Type parallelReduce(int begin, int end, Type const &identity, MapFunc map, ReduceFunc reduce,
+                    int grainSize = 0)
+{
+    int const count = end - begin;
+    if (count <= 0) return identity;
+
+    int const grain  = (grainSize > 0? grainSize : parallelGrainSize(count));
+    int const chunks = (count + grain - 1) / grain;
+
+    QVector<Type> partial(chunks, identity);
+    Type *partialAt = partial.data();
+    parallelFor(0, chunks, [&] (int first, int last)
+    {
+        for (int i = first; i < last; ++i)
+        {
+            int const chunkBegin = begin + i * grain;
+            partialAt[i] = map(chunkBegin, de::min(chunkBegin + grain, end));
+        }
+    }, 1);
+
+    Type result = identity;
+    for (Type const &value : partial)
+    {
+        result = reduce(result, value);
+    }
+    return result;
+}
+
+} // namespace de
+
+#endif // LIBDENG2_TASKGROUP_H
@@ -0,0 +1,74 @@
+/** @file binarylogsink.h  Log sink that writes entries in a compact binary format.
+ *
+ * @authors Copyright © 2026 agent <agent@local>
+ *
+ * @par License
+ * LGPL: http://www.gnu.org/licenses/lgpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details. You should have received a copy of
+ * the GNU Lesser General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small> 
+ */
+
+#ifndef LIBDENG2_BINARYLOGSINK_H
+#define LIBDENG2_BINARYLOGSINK_H
+
+#include "../LogSink"
+#include "../File"
+#include "../Block"
+
+#include <QHash>
+#include <functional>
+
+namespace de {
+
+/**
+ * Log sink that writes entries to a File in a compact binary format.
+ * @ingroup core
+ *
+ * Entries are not formatted when they are flushed. Instead, the format string and
+ * section of an entry are written only once and then referred to by number, and the
+ * arguments are stored as raw values. Use readEntries() to convert the log back to
+ * entries, for example to print them as text.
+ */
+class DENG2_PUBLIC BinaryLogSink : public LogSink
+{
+public:
+    /// The data is not a valid binary log. @ingroup errors
+    DENG2_ERROR(FormatError);
+
+public:
+    BinaryLogSink(File &outputFile);
+
+    LogSink &operator << (LogEntry const &entry);
+    LogSink &operator << (String const &plainText);
+
+    void flush();
+
+    /**
+     * Reads the entries of a binary log.
+     *
+     * @param log   Contents of a log written by BinaryLogSink.
+     * @param func  Called for each entry, in order.
+     */
+    static void readEntries(IByteArray const &log,
+                            std::function<void (LogEntry const &)> func);
+
+private:
+    duint32 stringId(QHash<String, duint32> &ids, String const &text, dbyte defineRecord);
+
+    File &_file;
+    Block _buffer;
+    QHash<String, duint32> _formats;
+    QHash<String, duint32> _sections;
+};
+
+} // namespace de
+
+#endif // LIBDENG2_BINARYLOGSINK_H
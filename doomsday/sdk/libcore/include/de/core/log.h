@@ -607,6 +607,9 @@ public:
 
     String const &format() const { return _format; }
 
+    /// Returns the arguments of the entry's format string.
+    Args const &args() const { return _args; }
+
     /**
      * Converts the log entry to a string.
      *
@@ -35,8 +35,14 @@ class LogSink;
  * Central buffer for log entries.
  *
  * Log entries may be created in any thread, and they get collected into a
- * central LogBuffer. The buffer is flushed whenever a new entry triggers the
- * flush condition, which means flushing may occur in any thread.
+ * central LogBuffer. New entries are first placed in a bounded lock-free queue,
+ * so adding an entry does not block other threads. When flushing is enabled, a
+ * background thread periodically moves the queued entries to the buffer and
+ * writes them to the sinks.
+ *
+ * If the queue fills up faster than it is flushed, verbose entries are dropped
+ * (see droppedEntryCount()) and other entries are stored by the adding thread
+ * itself (see stallCount()).
  *
  * The application owns an instance of LogBuffer.
  *
@@ -144,7 +150,8 @@ public:
     void enableStandardOutput(bool yes = true);
 
     /**
-     * Enables or disables flushing of log messages.
+     * Enables or disables flushing of log messages. Enabling flushing starts the
+     * background flushing thread.
      *
      * @param yes  @c true or @c false.
      */
@@ -179,7 +186,8 @@ public:
     /**
      * Adds a new sink where log entries will be flushed. There can be any
      * number of sinks in use. The sink must not be deleted while it is
-     * being used in the log buffer.
+     * being used in the log buffer. The sink is written to in the background
+     * flushing thread; see LogSink for what this requires of the sink.
      *
      * @param sink  Log sink. Caller retains ownership.
      */
@@ -192,6 +200,18 @@ public:
      */
     void removeSink(LogSink &sink);
 
+    /**
+     * Returns the number of verbose entries that have been discarded because the
+     * queue of new entries was full.
+     */
+    duint64 droppedEntryCount() const;
+
+    /**
+     * Returns the number of times a thread had to store its new entry in the
+     * buffer itself because the queue of new entries was full.
+     */
+    duint64 stallCount() const;
+
 public:
     /**
      * Sets the application's global log buffer. This is available to all.
@@ -29,7 +29,11 @@ namespace de {
  * Sink where log entries are flushed from the LogBuffer.
  * @ingroup core
  *
- * LogSinks are flushed only from one thread at a time.
+ * LogSinks are flushed only from one thread at a time. However, LogBuffer flushes
+ * its sinks in a background thread, so a sink must not access anything owned by
+ * the main thread (e.g., widgets or the game world) in operator<<() or flush().
+ * A sink that needs to do so should collect what it needs and use
+ * Loop::mainCall() to finish the job in the main thread.
  */
 class DENG2_PUBLIC LogSink
 {
@@ -103,7 +107,8 @@ public:
     virtual LogSink &operator << (String const &plainText) = 0;
 
     /**
-     * Flushes buffered output.
+     * Flushes buffered output. Called in the log flushing thread after a batch
+     * of entries has been output to the sink.
      */
     virtual void flush() = 0;
 
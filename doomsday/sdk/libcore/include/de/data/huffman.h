@@ -30,21 +30,69 @@
 namespace de {
 namespace codec {
 
+/**
+ * Returns the maximum size of @a size bytes of data when Huffman-coded.
+ */
+DENG2_PUBLIC dsize huffmanEncodedSizeMax(dsize size);
+
+/**
+ * Returns the maximum size of Huffman-coded data of @a codedSize bytes when decoded.
+ */
+DENG2_PUBLIC dsize huffmanDecodedSizeMax(dsize codedSize);
+
+/**
+ * Encodes data using Huffman codes.
+ *
+ * @param data     Data to encode.
+ * @param size     Size of the data.
+ * @param encoded  Output buffer. Must have room for huffmanEncodedSizeMax(size) bytes.
+ *
+ * @return Size of the encoded data.
+ */
+DENG2_PUBLIC dsize huffmanEncode(dbyte const *data, dsize size, dbyte *encoded);
+
+/**
+ * Decodes a Huffman-coded message. The codes are decoded several bits at a time
+ * using a lookup table.
+ *
+ * @param codedData    Huffman-coded data.
+ * @param codedSize    Size of the coded data.
+ * @param decoded      Output buffer. Decoding stops if it becomes full;
+ *                     huffmanDecodedSizeMax(codedSize) bytes is always enough.
+ * @param decodedSize  Size of the output buffer.
+ *
+ * @return Size of the decoded data.
+ */
+DENG2_PUBLIC dsize huffmanDecode(dbyte const *codedData, dsize codedSize,
+                                 dbyte *decoded, dsize decodedSize);
+
 /**
  * Encodes the data using Huffman codes.
  * @param data  Block of data to encode.
  *
  * @return Encoded block of bits.
  */
-Block huffmanEncode(Block const &data);
+DENG2_PUBLIC Block huffmanEncode(Block const &data);
 
 /**
- * Decodes the coded message using the Huffman tree.
+ * Decodes the Huffman-coded message.
  * @param codedData  Block of Huffman-coded data.
  *
  * @return Decoded block of data.
  */
-Block huffmanDecode(Block const &codedData);
+DENG2_PUBLIC Block huffmanDecode(Block const &codedData);
+
+/**
+ * Encodes one bit at a time. Produces the same output as huffmanEncode(); only
+ * meant for verification and benchmarking.
+ */
+DENG2_PUBLIC Block huffmanEncodeTree(Block const &data);
+
+/**
+ * Decodes by walking the Huffman tree one bit at a time. Produces the same output
+ * as huffmanDecode(); only meant for verification and benchmarking.
+ */
+DENG2_PUBLIC Block huffmanDecodeTree(Block const &codedData);
 
 } // namespace codec
 } // namespace de
@@ -26,6 +26,7 @@
 #include "../PointerSet"
 
 #include <QSet>
+#include <atomic>
 
 /**
  * Macro that forms the name of an observer interface.
@@ -173,6 +174,93 @@ private:
     LockableT<PointerSetT<IAudience>> _memberOf;
 };
 
+/**
+ * Copy-on-write snapshots of the members of an audience. Snapshots can be iterated
+ * without locking the audience. @ingroup data
+ *
+ * A snapshot is made when a notification finds that the members have changed since
+ * the previous one. Snapshots are not modified except that removed members are
+ * cleared from them, so that ongoing notifications will skip them. Old snapshots are
+ * deleted when nobody is reading any of the snapshots.
+ */
+class DENG2_PUBLIC ObserverSnapshots
+{
+public:
+    struct Snapshot
+    {
+        int count;
+        std::atomic<PointerSet::Pointer> *members; ///< Cleared members are @c nullptr.
+    };
+
+public:
+    ObserverSnapshots();
+
+    /**
+     * Begins reading the current snapshot. Must be paired with endReading().
+     *
+     * @param members  Members of the audience. Used if a new snapshot is needed.
+     * @param lock     Audience lock. Locked only while a new snapshot is made.
+     */
+    Snapshot const *beginReading(PointerSet const &members, Lockable const &lock) const;
+
+    void endReading() const;
+
+    /**
+     * Discards the current snapshot because the members have changed. The audience
+     * must be locked by the caller.
+     *
+     * @param removed  Member that was removed. It is cleared from the existing
+     *                 snapshots.
+     */
+    void invalidate(PointerSet::Pointer removed = nullptr);
+
+private:
+    DENG2_PRIVATE(d)
+};
+
+/**
+ * Notification statistics of an audience type. @ingroup data
+ *
+ * Collecting the statistics is disabled by default. When enabled, each notification
+ * of an audience updates the counters of the audience's observer interface.
+ */
+class DENG2_PUBLIC AudienceStats
+{
+public:
+    AudienceStats(char const *typeName);
+    ~AudienceStats();
+
+    inline void count(dint calls) {
+        _notifications.fetch_add(1, std::memory_order_relaxed);
+        _calls.fetch_add(duint64(calls), std::memory_order_relaxed);
+    }
+
+    static inline bool isEnabled() {
+        return _enabled.load(std::memory_order_relaxed);
+    }
+
+    static void setEnabled(bool enabled);
+
+    /**
+     * Resets the counters of all audience types to zero.
+     */
+    static void reset();
+
+    /**
+     * Prints the most frequently notified audience types to the log.
+     *
+     * @param maxCount  Maximum number of audience types to print.
+     */
+    static void print(int maxCount);
+
+private:
+    char const *_typeName;
+    std::atomic<duint64> _notifications;
+    std::atomic<duint64> _calls;
+
+    static std::atomic_bool _enabled;
+};
+
 /**
  * Template for observer sets. The template type should be an interface
  * implemented by all the observers. The observer type must implement ObserverBase.
@@ -221,8 +309,8 @@ private:
  *
  * @par Thread-safety
  *
- * Observers and Observers::Loop lock the observer set separately for reading
- * and writing as appropriate.
+ * By default, Observers and Observers::Loop lock the observer set separately for
+ * reading and writing as appropriate. See setSynchronization() for the alternatives.
  */
 template <typename Type>
 class Observers : public Lockable, public IAudience
@@ -232,6 +320,20 @@ public:
     typedef typename Members::const_iterator const_iterator;
     typedef int size_type;
 
+    enum Synchronization
+    {
+        /// Membership changes and notifications lock the audience (default).
+        ThreadSafe,
+
+        /// Membership changes lock the audience, but notifications iterate a
+        /// copy-on-write snapshot of the members without locking. Members added
+        /// during a notification are notified next time.
+        ThreadSafeSnapshot,
+
+        /// Nothing is locked. The audience must only be used in one thread.
+        SingleThreaded
+    };
+
     /**
      * Iteration utility for observers. This should be used when
      * notifying observers, because it is safe against the observer removing
@@ -240,8 +342,20 @@ public:
     class Loop : public PointerSet::IIterationObserver {
     public:
         Loop(Observers const &observers) : _audience(&observers)
-                                         , _prevObserver(nullptr) {
-            DENG2_GUARD(_audience);
+                                         , _prevObserver(nullptr)
+                                         , _snapshots(nullptr)
+                                         , _snapshot(nullptr)
+                                         , _pos(-1)
+                                         , _calls(0) {
+            if (_audience->_sync == ThreadSafeSnapshot) {
+                static ObserverSnapshots::Snapshot const noMembers = { 0, nullptr };
+                _snapshots = _audience->_snapshots.load();
+                _snapshot  = (_snapshots? _snapshots->beginReading(members(), *_audience)
+                                        : &noMembers);
+                next();
+                return;
+            }
+            MemberGuard const guard(*_audience);
             if (members().flags() & PointerSet::AllowInsertionDuringIteration) {
                 _prevObserver = members().iterationObserver();
                 members().setIterationObserver(this);
@@ -251,16 +365,32 @@ public:
             next();
         }
         virtual ~Loop() {
-            DENG2_GUARD(_audience);
+            if (AudienceStats::isEnabled()) {
+                Observers::stats().count(_calls);
+            }
+            if (_snapshot) {
+                if (_snapshots) _snapshots->endReading();
+                return;
+            }
+            MemberGuard const guard(*_audience);
             members().setBeingIterated(false);
             if (members().flags() & PointerSet::AllowInsertionDuringIteration) {
                 members().setIterationObserver(_prevObserver);
             }
         }
         bool done() const {
+            if (_snapshot) return _pos >= _snapshot->count;
             return _current >= members().end();
         }
         void next() {
+            if (_snapshot) {
+                // Skip the members that have been removed.
+                while (++_pos < _snapshot->count) {
+                    _item = static_cast<Type *>(_snapshot->members[_pos].load());
+                    if (_item) break;
+                }
+                return;
+            }
             _current = _next;
             if (_current < members().begin()) {
                 _current = members().begin();
@@ -270,11 +400,9 @@ public:
                 ++_next;
             }
         }
-        const_iterator const &get() const {
-            return _current;
-        }
         Type *operator -> () const {
-            return *get();
+            ++_calls;
+            return _snapshot? _item : *_current;
         }
         Loop &operator ++ () {
             next();
@@ -296,6 +424,11 @@ public:
         }
         Observers const *_audience;
         PointerSet::IIterationObserver *_prevObserver;
+        ObserverSnapshots const *_snapshots;
+        ObserverSnapshots::Snapshot const *_snapshot;
+        int _pos;
+        mutable dint _calls;
+        Type *_item;
         const_iterator _current;
         const_iterator _next;
     };
@@ -311,26 +444,52 @@ public:
 
     virtual ~Observers() {
         _disassociateAllMembers();
+        MemberGuard const guard(*this);
+        delete _snapshots.load();
+    }
+
+    /**
+     * Sets how the audience is synchronized between threads. This should be set
+     * before the audience is used, e.g., by the constructor of the owner.
+     *
+     * @param sync  Synchronization mode.
+     */
+    void setSynchronization(Synchronization sync) {
         DENG2_GUARD(this);
+        DENG2_ASSERT(!_members.isBeingIterated());
+        _sync = sync;
+        if (sync == ThreadSafeSnapshot) {
+            if (!_snapshots.load() && !_members.isEmpty()) {
+                _snapshots = new ObserverSnapshots;
+            }
+        }
+        else {
+            delete _snapshots.exchange(nullptr);
+        }
+    }
+
+    Synchronization synchronization() const {
+        return _sync;
     }
 
     void clear() {
-        DENG2_GUARD(this);
+        MemberGuard const guard(*this);
         _disassociateAllMembers();
         _members.clear();
+        if (auto *snapshots = _snapshots.load()) snapshots->invalidate();
     }
 
     Observers<Type> &operator = (Observers<Type> const &other) {
         if (this == &other) return *this;
-        DENG2_GUARD(other);
-        DENG2_GUARD(this);
+        MemberGuard const otherGuard(other);
+        MemberGuard const guard(*this);
         _members = other._members;
+        _invalidateSnapshot();
         for (Type *observer : _members) {
             observer->addMemberOf(*this);
         }
         return *this;
     }
-
     /// Add an observer into the set. The set does not receive
     /// ownership of the observer instance.
     void add(Type *observer) {
@@ -384,7 +543,7 @@ public:
     }
 
     size_type size() const {
-        DENG2_GUARD(this);
+        MemberGuard const guard(*this);
         return _members.size();
     }
 
@@ -393,12 +552,12 @@ public:
     }
 
     bool contains(Type const *observer) const {
-        DENG2_GUARD(this);
+        MemberGuard const guard(*this);
         return _members.contains(const_cast<Type *>(observer));
     }
 
     bool contains(Type const &observer) const {
-        DENG2_GUARD(this);
+        MemberGuard const guard(*this);
         return _members.contains(const_cast<Type *>(&observer));
     }
 
@@ -410,7 +569,7 @@ public:
      * @param yes  @c true to allow additions, @c false to deny.
      */
     void setAdditionAllowedDuringIteration(bool yes) {
-        DENG2_GUARD(this);
+        MemberGuard const guard(*this);
         _members.setFlags(Members::AllowInsertionDuringIteration, yes);
     }
 
@@ -418,7 +577,29 @@ public:
     void addMember   (ObserverBase *member) { _add   (static_cast<Type *>(member)); }
     void removeMember(ObserverBase *member) { _remove(static_cast<Type *>(member)); }
 
+    /**
+     * Notification statistics of this audience type.
+     */
+    static AudienceStats &stats() {
+        static AudienceStats typeStats(DENG2_TYPE_NAME(Type));
+        return typeStats;
+    }
+
 private:
+    /// Locks the audience, unless it is single-threaded.
+    class MemberGuard {
+    public:
+        MemberGuard(Observers const &audience)
+            : _locked(audience._sync != SingleThreaded? &audience : nullptr) {
+            if (_locked) _locked->lock();
+        }
+        ~MemberGuard() {
+            if (_locked) _locked->unlock();
+        }
+    private:
+        Observers const *_locked;
+    };
+
     void _disassociateAllMembers() {
         for (Type *observer : _members) {
             observer->removeMemberOf(*this);
@@ -426,17 +607,31 @@ private:
     }
 
     void _add(Type *observer) {
-        DENG2_GUARD(this);
+        MemberGuard const guard(*this);
         DENG2_ASSERT(observer != 0);
         _members.insert(observer);
+        _invalidateSnapshot();
     }
 
     void _remove(Type *observer) {
-        DENG2_GUARD(this);
+        MemberGuard const guard(*this);
         _members.remove(observer);
+        if (auto *snapshots = _snapshots.load()) snapshots->invalidate(observer);
+    }
+
+    /// Snapshots are only needed once the audience has members.
+    void _invalidateSnapshot() {
+        if (auto *snapshots = _snapshots.load()) {
+            snapshots->invalidate();
+        }
+        else if (_sync == ThreadSafeSnapshot && !_members.isEmpty()) {
+            _snapshots = new ObserverSnapshots;
+        }
     }
 
     Members _members;
+    Synchronization _sync = ThreadSafe;
+    std::atomic<ObserverSnapshots *> _snapshots { nullptr }; ///< Only in the ThreadSafeSnapshot mode.
 };
 
 } // namespace de
@@ -28,6 +28,8 @@
 #include <QList>
 #include <QMultiHash>
 
+#include <cstddef>
+
 namespace de {
 
 /**
@@ -55,6 +57,11 @@ namespace de {
  * backward slashes, irrespective of the separator used at path insertion
  * time.
  *
+ * Nodes are allocated from an arena owned by the tree, and they are indexed
+ * by their parent and segment identifier so that inserting a path does not
+ * need to compare it against other nodes with the same name. A node remains
+ * at the same address until it is removed from the tree.
+ *
  * @par Thread-safety
  *
  * The methods of PathTree automatically lock the tree. Access to the data in
@@ -237,6 +244,13 @@ public:
 
         DENG2_CAST_METHODS()
 
+        /*
+         * Nodes constructed in PathTree::newNode() are allocated from the
+         * tree's node arena. Elsewhere these fall back to the global heap.
+         */
+        static void *operator new(std::size_t size);
+        static void operator delete(void *ptr, std::size_t size);
+
         friend class PathTree;
         friend struct PathTree::Impl;
 
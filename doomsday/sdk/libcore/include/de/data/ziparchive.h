@@ -24,12 +24,19 @@
 #include "../NativePath"
 #include "../filesys/IInterpreter"
 
+#include <QList>
+#include <functional>
+
 namespace de {
 
 /**
  * Archive whose serialization uses the ZIP file format.
  * @ingroup data
  *
+ * Entries are read directly from the source data without copying when possible:
+ * a source Block is used as-is, and a native file that is not writable is mapped
+ * to memory.
+ *
  * All the features of the ZIP format are not supported:
  * - Deflate is the only supported compression method.
  * - Multipart ZIP files are not supported.
@@ -38,6 +45,12 @@ namespace de {
  */
 class DENG2_PUBLIC ZipArchive : public Archive
 {
+public:
+    /**
+     * Receives a piece of an entry's contents. Returns @c false to stop.
+     */
+    typedef std::function<bool (IByteArray::Byte const *data, dsize size)> StreamFunc;
+
 public:
     /// The central directory of the ZIP archive cannot be located. Maybe it's not
     /// a ZIP archive after all? @ingroup errors
@@ -79,6 +92,27 @@ public:
 
     void operator >> (Writer &to) const;
 
+    /**
+     * Reads the contents of an entry piece by piece, without loading all of it into
+     * memory. Compressed entries are decompressed as the data is consumed.
+     *
+     * @param path       Path of the entry.
+     * @param consumer   Called with each piece of the contents, in order.
+     * @param pieceSize  Maximum size of a piece.
+     */
+    void streamEntry(Path const &path, StreamFunc const &consumer,
+                     dsize pieceSize = 64 * 1024) const;
+
+    /**
+     * Reads and decompresses several entries at once, so that entryBlock() can
+     * return them without delay. If the source data can be accessed concurrently
+     * (for instance, a native file), the entries are decompressed in worker threads.
+     * Entries that are already cached are skipped.
+     *
+     * @param paths  Paths of the entries.
+     */
+    void prefetch(QList<Path> const &paths) const;
+
 public:
     /**
      * Determines whether a File looks like it could be accessed using ZipArchive.
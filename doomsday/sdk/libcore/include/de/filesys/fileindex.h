@@ -21,9 +21,7 @@
 
 #include "../File"
 
-#include <map>
 #include <list>
-#include <utility>
 
 namespace de {
 
@@ -34,14 +32,24 @@ class Package;
 /**
  * Indexes files for quick access.
  *
+ * File and folder names are interned, and the files are looked up from a hash table
+ * by name. Each indexed file refers to a chain of interned parent folder names, so
+ * partial paths are matched by comparing name identifiers instead of composing and
+ * comparing path strings.
+ *
+ * @par Thread-safety
+ *
+ * Modifications of the index are serialized. Lookups do not wait for modifications
+ * to finish: they see the index as it was before or after each modification. The
+ * hash buckets are persistent lists whose links are never modified once published,
+ * so an ongoing lookup keeps using the list it started with. Adding a file takes
+ * constant time; removing one copies only the entries added after it.
+ *
  * @ingroup fs
  */
 class DENG2_PUBLIC FileIndex
 {
 public:
-    typedef std::multimap<String, File *> Index;
-    typedef std::pair<Index::iterator, Index::iterator> IndexRange;
-    typedef std::pair<Index::const_iterator, Index::const_iterator> ConstIndexRange;
     typedef std::list<File *> FoundFiles;
 
     class DENG2_PUBLIC IPredicate
@@ -141,14 +149,11 @@ public:
 
     void print() const;
 
+    /**
+     * Returns all the indexed files, sorted by name.
+     */
     QList<File *> files() const;
 
-protected:
-    // C++ iterator (not thread-safe):
-    typedef Index::const_iterator const_iterator;
-    Index::const_iterator begin() const;
-    Index::const_iterator end() const;
-
 private:
     DENG2_PRIVATE(d)
 };
@@ -63,6 +63,9 @@ struct DENG2_PUBLIC Query
     QueryId id;
     String path;
     StringList packageIds;
+    duint64 startOffset = 0;    ///< Where the requested file contents begin.
+    Block resumeMetaId;         ///< Expected metaId of the file when resuming.
+    duint64 resumeFileSize = 0; ///< Expected size of the file when resuming.
 
     // Callbacks:
     Request<FileMetadata> fileMetadata;
@@ -74,7 +77,7 @@ struct DENG2_PUBLIC Query
 
 public:
     Query(Request<FileMetadata> req, String path);
-    Query(Request<FileContents> req, String path);
+    Query(Request<FileContents> req, String path, duint64 startOffset = 0);
     bool isValid() const;
     void cancel();
 };
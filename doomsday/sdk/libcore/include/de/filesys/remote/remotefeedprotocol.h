@@ -40,8 +40,26 @@ public:
     void setQuery(Query query);
     void setPath(String const &path);
 
+    /**
+     * Sets the offset in the file where the requested contents begin. This allows
+     * resuming an interrupted transfer.
+     */
+    void setStartOffset(duint64 offset);
+
+    /**
+     * Identifies the file whose earlier contents were received when resuming. If
+     * the file no longer matches, the contents are sent from the beginning.
+     *
+     * @param metaId    MetaId of the file.
+     * @param fileSize  Size of the file.
+     */
+    void setResumeValidator(Block const &metaId, duint64 fileSize);
+
     Query query() const;
     String path() const;
+    duint64 startOffset() const;
+    Block resumeMetaId() const;
+    duint64 resumeFileSize() const;
 
     // Implements ISerializable.
     void operator >> (Writer &to) const;
@@ -52,6 +70,9 @@ public:
 private:
     Query _query;
     String _path;
+    duint64 _startOffset = 0;
+    Block _resumeMetaId;
+    duint64 _resumeFileSize = 0;
 };
 
 /**
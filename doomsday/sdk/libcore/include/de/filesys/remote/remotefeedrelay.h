@@ -81,9 +81,26 @@ public:
                                         String folderPath,
                                         FileMetadata metadataReceived);
 
+    /**
+     * Requests the contents of a remote file. The contents are received in chunks.
+     *
+     * @param repository        Repository address.
+     * @param filePath          Path of the file in the repository.
+     * @param contentsReceived  Called with each received chunk of data.
+     * @param startOffset       Offset where to start receiving the contents. Earlier
+     *                          contents are not transferred, e.g., when resuming.
+     * @param metaId            When resuming, the metaId of the file whose earlier
+     *                          contents were received. If the file has changed since,
+     *                          the transfer starts over from the beginning.
+     * @param fileSize          When resuming, the size of the file whose earlier
+     *                          contents were received.
+     */
     Request<FileContents> fetchFileContents(String const &repository,
                                             String filePath,
-                                            FileContents contentsReceived);
+                                            FileContents contentsReceived,
+                                            duint64 startOffset = 0,
+                                            Block const &metaId = Block(),
+                                            duint64 fileSize = 0);
 
     QNetworkAccessManager &network();
 
@@ -47,7 +47,8 @@ public:
     Block  metaId()   const override;
 
     /**
-     * Initiates downloading of the file contents from the remote backend.
+     * Initiates downloading of the file contents from the remote backend. If an
+     * earlier download was cancelled, it is resumed where it left off.
      */
     void download() override;
 
@@ -23,6 +23,9 @@
 #include "../libcore.h"
 #include "../IByteArray"
 #include "../Address"
+#include "../Block"
+#include "../String"
+#include "../Time"
 #include "../Transmitter"
 
 #include <QTcpSocket>
@@ -75,6 +78,31 @@ public:
     };
     Q_DECLARE_FLAGS(HeaderFlags, HeaderFlag)
 
+    /**
+     * Compression statistics of a connection.
+     */
+    struct CompressionStats
+    {
+        duint64 sentPayloadBytes;       ///< Sent message payloads before compression.
+        duint64 sentCompressedBytes;    ///< Sent message payloads after compression.
+        duint64 streamPayloadBytes;     ///< Part of the sent payloads that used the stream.
+        TimeSpan compressTime;
+        duint64 receivedCompressedBytes;
+        duint64 receivedPayloadBytes;
+        TimeSpan decompressTime;
+
+        CompressionStats()
+            : sentPayloadBytes(0), sentCompressedBytes(0), streamPayloadBytes(0)
+            , receivedCompressedBytes(0), receivedPayloadBytes(0) {}
+
+        /// Size of the sent data relative to the uncompressed payloads.
+        ddouble sentRatio() const {
+            return sentPayloadBytes? ddouble(sentCompressedBytes) / sentPayloadBytes : 1.0;
+        }
+
+        String asText() const;
+    };
+
 public:
     Socket();
 
@@ -138,6 +166,38 @@ public:
      */
     void setRetainOrder(bool retainOrder);
 
+    /**
+     * Enables or disables stream compression of sent messages. In stream mode, messages
+     * are compressed with a deflate stream that persists for the lifetime of the
+     * connection. Each message ends in a sync flush, so it can be decoded as soon as it
+     * arrives, but the redundancy between consecutive messages is still exploited.
+     * Very small and very large messages are compressed individually as usual.
+     *
+     * Stream-compressed messages are always accepted when received, but older versions
+     * of the protocol do not understand them. Only enable this after the peer has agreed
+     * to it. The stream is reset when the socket is reopened.
+     *
+     * @param yes  @c true to enable stream compression.
+     */
+    void enableStreamCompression(bool yes = true);
+
+    bool isStreamCompressionEnabled() const;
+
+    /**
+     * Sets a preset dictionary for the compression streams in both directions. This is
+     * typically a sample of typical messages, which helps compressing the first
+     * messages of the stream. Both ends of the connection must use the same dictionary,
+     * and it must be set before any stream-compressed messages are sent or received.
+     *
+     * @param dictionary  Preset dictionary (at most 32 KB are used).
+     */
+    void setStreamDictionary(Block const &dictionary);
+
+    /**
+     * Returns the compression statistics of the connection.
+     */
+    CompressionStats compressionStats() const;
+
     // Implements Transmitter.
     /**
      * Sends the given data over the socket.  Copies the data into
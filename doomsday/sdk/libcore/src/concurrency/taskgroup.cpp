@@ -0,0 +1,123 @@
+/** @file taskgroup.cpp  Group of fine-grained concurrent tasks.
+ *
+ * @authors Copyright © 2026 agent <agent@local>
+ *
+ * @par License
+ * LGPL: http://www.gnu.org/licenses/lgpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details. You should have received a copy of
+ * the GNU Lesser General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#include "de/TaskGroup"
+#include "de/Log"
+#include "taskscheduler.h"
+
+namespace de {
+
+using internal::TaskScheduler;
+
+DENG2_PIMPL_NOREF(TaskGroup)
+{
+    internal::JobCounter counter;
+};
+
+TaskGroup::TaskGroup() : d(new Impl)
+{}
+
+TaskGroup::~TaskGroup()
+{
+    try
+    {
+        wait();
+    }
+    catch (Error const &er)
+    {
+        LOG_AS("TaskGroup");
+        LOG_WARNING("Aborted due to exception: ") << er.asText();
+    }
+}
+
+void TaskGroup::start(Function func)
+{
+    ++d->counter.pending;
+    TaskScheduler::get().submit(std::move(func), &d->counter, TaskPool::HighPriority);
+}
+
+void TaskGroup::wait()
+{
+    TaskScheduler::get().wait(d->counter);
+    d->counter.rethrowError();
+}
+
+bool TaskGroup::isDone() const
+{
+    return !d->counter.pending.load();
+}
+
+int TaskGroup::workerCount()
+{
+    return TaskScheduler::get().workerCount();
+}
+
+namespace internal {
+
+/**
+ * Splits a parallelFor range in halves until the pieces are small enough.
+ */
+struct RangeSplitter
+{
+    TaskGroup group;
+    std::function<void (int, int)> const &func;
+    int grainSize;
+
+    RangeSplitter(std::function<void (int, int)> const &f, int grain)
+        : func(f), grainSize(grain) {}
+
+    void process(int begin, int end)
+    {
+        // The second half is left for others while this thread continues with
+        // the first half.
+        while (end - begin > grainSize)
+        {
+            int const mid = begin + (end - begin) / 2;
+            RangeSplitter *self = this;
+            group.start([self, mid, end] () { self->process(mid, end); });
+            end = mid;
+        }
+        func(begin, end);
+    }
+};
+
+} // namespace internal
+
+void parallelFor(int begin, int end, std::function<void (int, int)> const &func, int grainSize)
+{
+    if (end <= begin) return;
+
+    int const grain = (grainSize > 0? grainSize : parallelGrainSize(end - begin));
+    if (end - begin <= grain)
+    {
+        // Not worth splitting.
+        func(begin, end);
+        return;
+    }
+
+    internal::RangeSplitter splitter(func, grain);
+    splitter.process(begin, end);
+    splitter.group.wait();
+}
+
+int parallelGrainSize(int count)
+{
+    return de::max(1, count / ((TaskGroup::workerCount() + 1) * 4));
+}
+
+} // namespace de
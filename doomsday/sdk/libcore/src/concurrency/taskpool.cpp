@@ -19,34 +19,24 @@
 #include "de/TaskPool"
 #include "de/Task"
 #include "de/Guard"
+#include "de/Log"
+#include "taskscheduler.h"
 
-#include <QThreadPool>
-#include <QSet>
 #include <de/Lockable>
 #include <de/Loop>
 #include <de/Waitable>
 
 namespace de {
 
-namespace internal
-{
-    class CallbackTask : public Task
-    {
-    public:
-        CallbackTask(TaskPool::TaskFunction func) : _func(func) {}
-        void runTask() override { _func(); }
-    private:
-        TaskPool::TaskFunction _func;
-    };
-}
+using internal::TaskScheduler;
 
 DENG2_PIMPL(TaskPool), public Lockable, public Waitable, public TaskPool::IPool
 {
     /// Private instance will be deleted when pool is empty.
     bool deleteWhenDone = false;
 
-    /// Set of running tasks.
-    QSet<Task *> tasks;
+    /// Number of started tasks that have not finished yet.
+    int taskCount = 0;
 
     Impl(Public *i) : Base(i)
     {
@@ -57,27 +47,25 @@ DENG2_PIMPL(TaskPool), public Lockable, public Waitable, public TaskPool::IPool
     ~Impl()
     {
         // The pool is always empty at this point because the destructor is not
-        // called until all the tasks have been finished and removed.
-        DENG2_ASSERT(tasks.isEmpty());
+        // called until all the tasks have been finished.
+        DENG2_ASSERT(!taskCount);
     }
 
-    void add(Task *t)
+    void add()
     {
         DENG2_GUARD(this);
-        t->_pool = this;
-        if (tasks.isEmpty())
+        if (!taskCount++)
         {
             wait(); // Semaphore now unavailable.
         }
-        tasks.insert(t);
     }
 
     /// Returns @c true, if the pool became empty as result of the remove.
-    bool remove(Task *t)
+    bool remove()
     {
         DENG2_GUARD(this);
-        tasks.remove(t);
-        if (tasks.isEmpty())
+        DENG2_ASSERT(taskCount > 0);
+        if (!--taskCount)
         {
             post();
             return true;
@@ -89,20 +77,29 @@ DENG2_PIMPL(TaskPool), public Lockable, public Waitable, public TaskPool::IPool
     {
         wait();
         DENG2_GUARD(this);
-        DENG2_ASSERT(tasks.isEmpty());
+        DENG2_ASSERT(!taskCount);
         post(); // When empty, the semaphore is available.
     }
 
     bool isEmpty() const
     {
         DENG2_GUARD(this);
-        return tasks.isEmpty();
+        return !taskCount;
+    }
+
+    void taskFinishedRunning(Task &) override
+    {
+        finishedRunning();
     }
 
-    void taskFinishedRunning(Task &task)
+    /**
+     * Called when one of the pool's tasks has finished. The private instance may be
+     * deleted during the call.
+     */
+    void finishedRunning()
     {
         lock();
-        if (remove(&task))
+        if (remove())
         {
             if (deleteWhenDone)
             {
@@ -151,13 +148,36 @@ TaskPool::~TaskPool()
 
 void TaskPool::start(Task *task, Priority priority)
 {
-    d->add(task);
-    QThreadPool::globalInstance()->start(task, int(priority));
+    d->add();
+    task->_pool = d;
+    TaskScheduler::get().submit([task] ()
+    {
+        bool const autoDelete = task->autoDelete();
+        task->run(); // reports to the pool when finished
+        if (autoDelete) delete task;
+    },
+    nullptr, priority);
 }
 
 void TaskPool::start(TaskFunction taskFunction, Priority priority)
 {
-    start(new internal::CallbackTask(taskFunction), priority);
+    d->add();
+    Impl *pool = d;
+    TaskScheduler::get().submit([pool, taskFunction] ()
+    {
+        try
+        {
+            taskFunction();
+        }
+        catch (Error const &er)
+        {
+            LOG_AS("Task");
+            LOG_WARNING("Aborted due to exception: ") << er.asText();
+        }
+        // The pool may be deleted during this call.
+        pool->finishedRunning();
+    },
+    nullptr, priority);
 }
 
 void TaskPool::waitForDone()
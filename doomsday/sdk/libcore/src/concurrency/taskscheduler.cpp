@@ -0,0 +1,392 @@
+/** @file taskscheduler.cpp  Work-stealing scheduler for concurrent tasks.
+ *
+ * @authors Copyright © 2026 agent <agent@local>
+ *
+ * @par License
+ * LGPL: http://www.gnu.org/licenses/lgpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details. You should have received a copy of
+ * the GNU Lesser General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#include "taskscheduler.h"
+#include "de/Log"
+#include "de/math.h"
+
+#include <QThread>
+#include <deque>
+#include <memory>
+#include <vector>
+
+namespace de {
+namespace internal {
+
+/// Index of the scheduler worker running in the current thread (-1 if none).
+static thread_local int schedulerWorkerIndex = -1;
+
+void JobCounter::notify()
+{
+    if (waiters.load() > 0)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        changed.notify_all();
+    }
+}
+
+void JobCounter::finished()
+{
+    // The mutex is locked even without waiters so that a waiting thread cannot
+    // destroy the counter while this is still being executed.
+    std::lock_guard<std::mutex> lock(mutex);
+    if (--pending == 0 || waiters.load() > 0)
+    {
+        changed.notify_all();
+    }
+}
+
+void JobCounter::failed(std::exception_ptr exception)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!error) error = exception;
+}
+
+void JobCounter::rethrowError()
+{
+    std::exception_ptr exception;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::swap(exception, error);
+    }
+    if (exception) std::rethrow_exception(exception);
+}
+
+namespace {
+
+struct Job
+{
+    TaskScheduler::Function func;
+    JobCounter *counter;
+
+    Job(TaskScheduler::Function f = TaskScheduler::Function(), JobCounter *c = nullptr)
+        : func(std::move(f)), counter(c) {}
+};
+
+/**
+ * Queue of jobs. The owning worker uses the back, others take from the front.
+ */
+struct JobQueue
+{
+    std::mutex mutex;
+    std::deque<Job> jobs;
+    std::atomic_int size { 0 };
+
+    void push(Job &&job)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.push_back(std::move(job));
+        ++size;
+    }
+
+    bool popBack(Job &job)
+    {
+        if (!size.load()) return false;
+        std::lock_guard<std::mutex> lock(mutex);
+        if (jobs.empty()) return false;
+        job = std::move(jobs.back());
+        jobs.pop_back();
+        --size;
+        return true;
+    }
+
+    bool popFront(Job &job)
+    {
+        if (!size.load()) return false;
+        std::lock_guard<std::mutex> lock(mutex);
+        if (jobs.empty()) return false;
+        job = std::move(jobs.front());
+        jobs.pop_front();
+        --size;
+        return true;
+    }
+
+    /// Takes the newest job that belongs to @a counter.
+    bool take(JobCounter const *counter, Job &job)
+    {
+        if (!size.load()) return false;
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto i = jobs.rbegin(); i != jobs.rend(); ++i)
+        {
+            if (i->counter == counter)
+            {
+                job = std::move(*i);
+                jobs.erase(std::next(i).base());
+                --size;
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+} // namespace
+
+DENG2_PIMPL_NOREF(TaskScheduler)
+{
+    class Worker : public QThread
+    {
+    public:
+        Worker(Impl &sched, int index) : _sched(sched), _index(index) {}
+
+        void run() override
+        {
+            schedulerWorkerIndex = _index;
+            _sched.workerLoop(_index);
+
+            // Worker threads are not reused after this.
+            Log::disposeThreadLog();
+        }
+
+    private:
+        Impl &_sched;
+        int _index;
+    };
+
+    QList<Worker *> workers;
+    std::vector<std::unique_ptr<JobQueue>> local; ///< One per worker.
+    JobQueue injected[3];                         ///< Jobs from other threads, per priority.
+
+    std::atomic_int  queuedCount { 0 };
+    std::atomic_int  sleeping    { 0 };
+    std::atomic_bool stopping    { false };
+    std::atomic_bool stopped     { false };
+    std::mutex sleepMutex;
+    std::condition_variable wakeUp;
+
+    Impl()
+    {
+        int const count = de::max(1, QThread::idealThreadCount());
+        for (int i = 0; i < count; ++i)
+        {
+            local.emplace_back(new JobQueue);
+        }
+        for (int i = 0; i < count; ++i)
+        {
+            workers << new Worker(*this, i);
+            workers.last()->start();
+        }
+    }
+
+    ~Impl()
+    {
+        stop();
+    }
+
+    void stop()
+    {
+        if (stopped.load()) return;
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            stopping = true;
+            wakeUp.notify_all();
+        }
+        for (Worker *worker : workers)
+        {
+            worker->wait();
+        }
+        stopped = true;
+
+        // Jobs queued while the last workers were exiting.
+        Job job;
+        while (takeJob(0, job))
+        {
+            runJob(job);
+        }
+    }
+
+    void push(Job &&job, TaskPool::Priority priority)
+    {
+        if (stopped.load())
+        {
+            // No one is left to execute queued jobs.
+            runJob(job);
+            return;
+        }
+
+        JobCounter *counter = job.counter;
+        if (counter) ++counter->queued;
+
+        int const index = schedulerWorkerIndex;
+        if (index >= 0 && index < int(local.size()))
+        {
+            local[index]->push(std::move(job));
+        }
+        else
+        {
+            injected[priority].push(std::move(job));
+        }
+        ++queuedCount;
+
+        if (sleeping.load() > 0)
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            wakeUp.notify_one();
+        }
+        if (counter)
+        {
+            // A waiting thread may now help. The counter is still valid because
+            // jobs are only added by the group's owner or by its unfinished jobs.
+            counter->notify();
+        }
+    }
+
+    void taken(Job &job)
+    {
+        --queuedCount;
+        if (job.counter) --job.counter->queued;
+    }
+
+    bool takeJob(int index, Job &job)
+    {
+        bool found = local[index]->popBack(job);
+        for (int pri = TaskPool::HighPriority; !found && pri >= TaskPool::LowPriority; --pri)
+        {
+            found = injected[pri].popFront(job);
+        }
+        // Steal the oldest job from another worker.
+        int const count = int(local.size());
+        for (int i = 1; !found && i < count; ++i)
+        {
+            found = local[(index + i) % count]->popFront(job);
+        }
+        if (found) taken(job);
+        return found;
+    }
+
+    bool takeOwnedJob(JobCounter const &counter, Job &job)
+    {
+        bool found = false;
+        int const index = schedulerWorkerIndex;
+        if (index >= 0 && index < int(local.size()))
+        {
+            found = local[index]->take(&counter, job);
+        }
+        for (int pri = TaskPool::HighPriority; !found && pri >= TaskPool::LowPriority; --pri)
+        {
+            found = injected[pri].take(&counter, job);
+        }
+        for (int i = 0; !found && i < int(local.size()); ++i)
+        {
+            if (i != index) found = local[i]->take(&counter, job);
+        }
+        if (found) taken(job);
+        return found;
+    }
+
+    static void runJob(Job &job)
+    {
+        {
+            TaskScheduler::Function func = std::move(job.func);
+            try
+            {
+                func();
+            }
+            catch (Error const &er)
+            {
+                if (job.counter)
+                {
+                    // The group's waiter decides what to do with the error.
+                    job.counter->failed(std::current_exception());
+                }
+                else
+                {
+                    LOG_AS("TaskScheduler");
+                    LOG_WARNING("Aborted due to exception: ") << er.asText();
+                }
+            }
+        }
+        if (job.counter) job.counter->finished();
+    }
+
+    void workerLoop(int index)
+    {
+        for (;;)
+        {
+            Job job;
+            if (takeJob(index, job))
+            {
+                runJob(job);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            if (stopping.load() && !queuedCount.load()) break;
+            ++sleeping;
+            wakeUp.wait(lock, [this] () {
+                return stopping.load() || queuedCount.load() > 0;
+            });
+            --sleeping;
+        }
+    }
+};
+
+TaskScheduler &TaskScheduler::get()
+{
+    static TaskScheduler scheduler;
+    return scheduler;
+}
+
+TaskScheduler::TaskScheduler() : d(new Impl)
+{}
+
+TaskScheduler::~TaskScheduler()
+{}
+
+void TaskScheduler::stop()
+{
+    d->stop();
+}
+
+int TaskScheduler::workerCount() const
+{
+    return d->workers.size();
+}
+
+void TaskScheduler::submit(Function func, JobCounter *counter, TaskPool::Priority priority)
+{
+    d->push(Job(std::move(func), counter), priority);
+}
+
+void TaskScheduler::wait(JobCounter &counter)
+{
+    while (counter.pending.load() > 0)
+    {
+        // Help by executing the counter's queued jobs.
+        Job job;
+        if (counter.queued.load() > 0 && d->takeOwnedJob(counter, job))
+        {
+            Impl::runJob(job);
+            continue;
+        }
+
+        // The remaining jobs are being executed elsewhere.
+        std::unique_lock<std::mutex> lock(counter.mutex);
+        ++counter.waiters;
+        counter.changed.wait(lock, [&counter] () {
+            return !counter.pending.load() || counter.queued.load() > 0;
+        });
+        --counter.waiters;
+    }
+
+    // Make sure the final finished() call has returned.
+    std::lock_guard<std::mutex> lock(counter.mutex);
+}
+
+} // namespace internal
+} // namespace de
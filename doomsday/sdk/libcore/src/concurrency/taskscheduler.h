@@ -0,0 +1,121 @@
+/** @file taskscheduler.h  Work-stealing scheduler for concurrent tasks.
+ *
+ * @authors Copyright © 2026 agent <agent@local>
+ *
+ * @par License
+ * LGPL: http://www.gnu.org/licenses/lgpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details. You should have received a copy of
+ * the GNU Lesser General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#ifndef LIBDENG2_TASKSCHEDULER_H
+#define LIBDENG2_TASKSCHEDULER_H
+
+#include "de/TaskPool"
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+
+namespace de {
+namespace internal {
+
+/**
+ * Keeps count of the unfinished jobs of a TaskGroup, and lets threads wait for them.
+ */
+struct JobCounter
+{
+    std::atomic_int pending { 0 };  ///< Started but not yet finished.
+    std::atomic_int queued  { 0 };  ///< Still waiting in a queue.
+    std::atomic_int waiters { 0 };
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::exception_ptr error;       ///< First error thrown by a job.
+
+    /// Wakes up the waiting threads, if there are any.
+    void notify();
+
+    /**
+     * Called when a job has thrown an exception. Only the first one is kept.
+     */
+    void failed(std::exception_ptr exception);
+
+    /**
+     * If a job has thrown an exception, it is rethrown and forgotten.
+     */
+    void rethrowError();
+
+    /**
+     * Called when a job has finished. The counter may be destroyed as soon as this
+     * returns, if this was the last job.
+     */
+    void finished();
+};
+
+/**
+ * Engine-owned pool of worker threads that executes TaskPool and TaskGroup jobs.
+ *
+ * Each worker has its own deque of jobs. Jobs started in a worker are pushed to the
+ * back of its deque, and the worker takes the newest job first. Idle workers steal
+ * the oldest jobs from the other deques. Jobs started in other threads are queued in
+ * shared queues, one per TaskPool::Priority.
+ */
+class TaskScheduler
+{
+public:
+    typedef std::function<void ()> Function;
+
+    static TaskScheduler &get();
+
+    TaskScheduler();
+
+    /**
+     * Stops the workers after all queued jobs have been executed.
+     */
+    ~TaskScheduler();
+
+    /**
+     * Executes all queued jobs and stops the worker threads. Jobs submitted after
+     * this are executed immediately in the calling thread. No other threads may
+     * submit jobs while this is in progress.
+     */
+    void stop();
+
+    int workerCount() const;
+
+    /**
+     * Queues a job. Exceptions thrown by the job are passed to @a counter, or logged
+     * if there is no counter.
+     *
+     * @param func      Job to execute.
+     * @param counter   Counter to update when the job is dequeued and finished.
+     *                  Can be @c nullptr.
+     * @param priority  Priority, if the job is not started in a worker thread.
+     */
+    void submit(Function func, JobCounter *counter,
+                TaskPool::Priority priority = TaskPool::LowPriority);
+
+    /**
+     * Executes queued jobs of @a counter in the calling thread, and otherwise waits,
+     * until all the jobs of the counter have finished.
+     */
+    void wait(JobCounter &counter);
+
+private:
+    DENG2_PRIVATE(d)
+};
+
+} // namespace internal
+} // namespace de
+
+#endif // LIBDENG2_TASKSCHEDULER_H
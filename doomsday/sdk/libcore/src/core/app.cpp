@@ -22,6 +22,7 @@
 #include "de/ArchiveFeed"
 #include "de/ArchiveFolder"
 #include "de/ArrayValue"
+#include "de/BinaryLogSink"
 #include "de/Block"
 #include "de/CommandLine"
 #include "de/Config"
@@ -51,6 +52,7 @@
 #include "de/Version"
 #include "de/Writer"
 #include "de/ZipArchive"
+#include "../src/concurrency/taskscheduler.h"
 
 #include <QDir>
 #include <QThread>
@@ -149,6 +151,9 @@ DENG2_PIMPL(App)
     /// Optional sink for warnings and errors (set with "-errors").
     std::unique_ptr<FileLogSink> errorSink;
 
+    /// Optional sink for all entries in binary format (set with "-binlog").
+    std::unique_ptr<BinaryLogSink> binarySink;
+
     Impl(Public *a, QStringList args)
         : Base(a)
         , appName("Doomsday Engine")
@@ -200,12 +205,19 @@ DENG2_PIMPL(App)
 
     ~Impl()
     {
+        // Let the remaining background tasks finish while everything still exists.
+        internal::TaskScheduler::get().stop();
+
         metaBank.reset();
 
         if (errorSink)
         {
             logBuffer.removeSink(*errorSink);
         }
+        if (binarySink)
+        {
+            logBuffer.removeSink(*binarySink);
+        }
 
         if (config)
         {
@@ -376,6 +388,16 @@ DENG2_PIMPL(App)
         }
     }
 
+    void checkForBinaryLogFile()
+    {
+        if (CommandLine::ArgWithParams arg = cmdLine.check("-binlog", 1))
+        {
+            File &log = self().rootFolder().replaceFile(Path("/home") / arg.params.at(0));
+            binarySink.reset(new BinaryLogSink(log));
+            logBuffer.addSink(*binarySink);
+        }
+    }
+
     ArchiveFolder &persistPackFolder()
     {
         return self().homeFolder().locate<ArchiveFolder>("persist.pack");
@@ -788,6 +810,7 @@ void App::initSubsystems(SubsystemInitFlags flags)
 
     // Check if a separate error output file is requested.
     d->checkForErrorDumpFile();
+    d->checkForBinaryLogFile();
 
     try
     {
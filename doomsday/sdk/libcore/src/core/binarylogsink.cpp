@@ -0,0 +1,188 @@
+/** @file binarylogsink.cpp  Log sink that writes entries in a compact binary format.
+ *
+ * @authors Copyright © 2026 agent <agent@local>
+ *
+ * @par License
+ * LGPL: http://www.gnu.org/licenses/lgpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details. You should have received a copy of
+ * the GNU Lesser General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small> 
+ */
+
+#include "de/BinaryLogSink"
+#include "de/Reader"
+#include "de/Writer"
+
+namespace de {
+
+static char const *BINARY_LOG_MAGIC = "DLOG";
+static duint32 const BINARY_LOG_VERSION = 1;
+
+/// Flush to the file when this much data has been buffered.
+static dsize const BINARY_LOG_BUFFER_SIZE = 64 * 1024;
+
+enum BinaryLogRecord
+{
+    RecordDefineFormat  = 'F',
+    RecordDefineSection = 'S',
+    RecordPlainText     = 'T',
+    RecordEntry         = 'E'
+};
+
+BinaryLogSink::BinaryLogSink(File &outputFile)
+    : _file(outputFile)
+{
+    Writer(_buffer).writeBytes(Block(BINARY_LOG_MAGIC)) << BINARY_LOG_VERSION;
+}
+
+duint32 BinaryLogSink::stringId(QHash<String, duint32> &ids, String const &text,
+                                dbyte defineRecord)
+{
+    auto found = ids.constFind(text);
+    if (found != ids.constEnd()) return found.value();
+
+    duint32 const id = duint32(ids.size());
+    ids.insert(text, id);
+
+    Block record;
+    Writer(record) << defineRecord << id << text;
+    _buffer += record;
+    return id;
+}
+
+LogSink &BinaryLogSink::operator << (LogEntry const &entry)
+{
+    duint32 const formatId  = stringId(_formats,  entry.format(),  RecordDefineFormat);
+    duint32 const sectionId = stringId(_sections, entry.section(), RecordDefineSection);
+
+    Block record;
+    Writer writer(record);
+    writer << dbyte(RecordEntry)
+           << entry.when()
+           << formatId
+           << sectionId
+           << duint32(entry.metadata())
+           << dbyte(entry.sectionDepth())
+           << duint32(entry.flags());
+    writer.writeObjects(entry.args());
+    _buffer += record;
+
+    if (_buffer.size() >= BINARY_LOG_BUFFER_SIZE)
+    {
+        flush();
+    }
+    return *this;
+}
+
+LogSink &BinaryLogSink::operator << (String const &plainText)
+{
+    Block record;
+    Writer(record) << dbyte(RecordPlainText) << plainText;
+    _buffer += record;
+    return *this;
+}
+
+void BinaryLogSink::flush()
+{
+    if (!_buffer.isEmpty())
+    {
+        _file << _buffer;
+        _buffer.clear();
+    }
+    _file.flush();
+}
+
+void BinaryLogSink::readEntries(IByteArray const &log,
+                                std::function<void (LogEntry const &)> func)
+{
+    Reader reader(log);
+
+    Block magic(4);
+    reader.readBytesFixedSize(magic);
+    duint32 version = 0;
+    reader >> version;
+    if (magic != BINARY_LOG_MAGIC || version > BINARY_LOG_VERSION)
+    {
+        throw FormatError("BinaryLogSink::readEntries", "Not a supported binary log");
+    }
+
+    QList<String> formats;
+    QList<String> sections;
+
+    auto lookup = [] (QList<String> const &strings, duint32 id) -> String const & {
+        if (id >= duint32(strings.size()))
+        {
+            throw FormatError("BinaryLogSink::readEntries",
+                              QString("Undefined string %1").arg(id));
+        }
+        return strings.at(int(id));
+    };
+
+    while (!reader.atEnd())
+    {
+        dbyte type;
+        reader >> type;
+
+        switch (type)
+        {
+        case RecordDefineFormat:
+        case RecordDefineSection: {
+            duint32 id;
+            String text;
+            reader >> id >> text;
+            QList<String> &strings = (type == RecordDefineFormat? formats : sections);
+            if (id != duint32(strings.size()))
+            {
+                throw FormatError("BinaryLogSink::readEntries",
+                                  QString("Unexpected string %1").arg(id));
+            }
+            strings.append(text);
+            break; }
+
+        case RecordPlainText: {
+            String text;
+            reader >> text;
+            func(LogEntry(LogEntry::Generic | LogEntry::Message, "", 0, text,
+                          LogEntry::Args()));
+            break; }
+
+        case RecordEntry: {
+            Time when;
+            duint32 formatId, sectionId, metadata, flags;
+            dbyte depth;
+            reader >> when >> formatId >> sectionId >> metadata >> depth >> flags;
+            LogEntry::Args args;
+            reader.readObjects<LogEntry::Arg>(args);
+
+            // Compose the regular serialization of the entry.
+            Block serialized;
+            Writer writer(serialized);
+            writer << when
+                   << lookup(sections, sectionId)
+                   << lookup(formats, formatId)
+                   << metadata
+                   << depth
+                   << flags;
+            writer.writeObjects(args);
+            qDeleteAll(args);
+
+            LogEntry entry;
+            Reader(serialized) >> entry;
+            func(entry);
+            break; }
+
+        default:
+            throw FormatError("BinaryLogSink::readEntries",
+                              QString("Unknown record type %1").arg(type));
+        }
+    }
+}
+
+} // namespace de
@@ -34,18 +34,143 @@
 #include <QCoreApplication>
 #include <QList>
 #include <QSet>
-#include <QTimer>
+#include <QThread>
 #include <QDebug>
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
 namespace de {
 
 TimeSpan const FLUSH_INTERVAL = .2; // seconds
 
+/// Number of unflushed entries that fit in the queue (power of two).
+static dsize const LOG_QUEUE_CAPACITY = 8192;
+
+namespace internal {
+
+/**
+ * Bounded lock-free queue of log entries. Any thread may add entries, but only one
+ * thread at a time may take them out.
+ */
+class LogEntryQueue
+{
+public:
+    LogEntryQueue(dsize capacity)
+        : _cells(new Cell[capacity])
+        , _mask(capacity - 1)
+    {
+        DENG2_ASSERT((capacity & _mask) == 0);
+        for (dsize i = 0; i < capacity; ++i)
+        {
+            _cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    dsize capacity() const { return _mask + 1; }
+
+    /// Approximate number of queued entries.
+    dsize size() const
+    {
+        return _head.load(std::memory_order_relaxed) - _tail.load(std::memory_order_relaxed);
+    }
+
+    /// Returns @c false if the queue is full.
+    bool push(LogEntry *entry)
+    {
+        dsize pos = _head.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            Cell &cell = _cells[pos & _mask];
+            dsize const seq = cell.sequence.load(std::memory_order_acquire);
+            if (seq == pos)
+            {
+                if (_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    cell.entry = entry;
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (seq < pos)
+            {
+                return false; // The cell hasn't been taken out yet.
+            }
+            else
+            {
+                pos = _head.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /// Returns @c nullptr if there are no (completely added) entries.
+    LogEntry *pop()
+    {
+        dsize const pos = _tail.load(std::memory_order_relaxed);
+        Cell &cell = _cells[pos & _mask];
+        if (cell.sequence.load(std::memory_order_acquire) != pos + 1)
+        {
+            return nullptr;
+        }
+        LogEntry *entry = cell.entry;
+        cell.sequence.store(pos + _mask + 1, std::memory_order_release);
+        _tail.store(pos + 1, std::memory_order_relaxed);
+        return entry;
+    }
+
+private:
+    struct Cell
+    {
+        std::atomic<dsize> sequence;
+        LogEntry *entry;
+    };
+    std::unique_ptr<Cell[]> _cells;
+    dsize _mask;
+    std::atomic<dsize> _head { 0 };
+    std::atomic<dsize> _tail { 0 };
+};
+
+} // namespace internal
+
 DENG2_PIMPL(LogBuffer)
 {
     typedef QList<LogEntry *> EntryList;
     typedef QSet<LogSink *> Sinks;
 
+    /**
+     * Background thread that periodically flushes the buffer.
+     */
+    class Flusher : public QThread
+    {
+    public:
+        Flusher(Impl &inst) : _d(inst) {}
+
+        void run() override
+        {
+            for (;;)
+            {
+                {
+                    std::unique_lock<std::mutex> lock(_d.flusherMutex);
+                    auto const interval = std::chrono::milliseconds(
+                                dint64(_d.flushInterval.asMilliSeconds()));
+                    _d.flusherWake.wait_for(lock, interval, [this] () {
+                        return _d.stopFlusher || _d.flushRequested.load();
+                    });
+                    if (_d.stopFlusher) break;
+                    _d.flushRequested = false;
+                }
+                _d.self().flush();
+            }
+            Log::disposeThreadLog();
+        }
+
+    private:
+        Impl &_d;
+    };
+
     SimpleLogFilter defaultFilter;
     IFilter const *entryFilter;
     dint maxEntryCount;
@@ -60,12 +185,23 @@ DENG2_PIMPL(LogBuffer)
     DebugLogSink outSink;
     DebugLogSink errSink;
 #endif
+    internal::LogEntryQueue queue; ///< Added entries waiting to be collected.
     EntryList entries;
     EntryList toBeFlushed;
     Time lastFlushedAt;
-    QTimer *autoFlushTimer;
     Sinks sinks;
 
+    std::unique_ptr<Flusher> flusher;
+    TimeSpan flushInterval;
+    std::mutex flusherMutex;
+    std::condition_variable flusherWake;
+    bool stopFlusher = false;
+    std::atomic_bool flushRequested { false };
+
+    std::atomic<duint64> droppedCount { 0 };
+    std::atomic<duint64> stallCount   { 0 };
+    duint64 reportedDropCount = 0;
+
     Impl(Public *i, duint maxEntryCount)
         : Base(i)
         , entryFilter(&defaultFilter)
@@ -81,8 +217,9 @@ DENG2_PIMPL(LogBuffer)
         , outSink(QtDebugMsg)
         , errSink(QtWarningMsg)
 #endif
+        , queue(LOG_QUEUE_CAPACITY)
         , lastFlushedAt(Time::invalidTime())
-        , autoFlushTimer(0)
+        , flushInterval(FLUSH_INTERVAL)
     {
         // Standard output enabled by default.
         outSink.setMode(LogSink::OnlyNormalEntries);
@@ -94,27 +231,81 @@ DENG2_PIMPL(LogBuffer)
 
     ~Impl()
     {
-        if (autoFlushTimer) autoFlushTimer->stop();
+        stopFlushing();
         delete fileLogSink;
+
+        // Entries added after the final flush.
+        while (LogEntry *entry = queue.pop()) delete entry;
+    }
+
+    void startFlushing()
+    {
+        if (flusher) return;
+
+        stopFlusher = false;
+        flusher.reset(new Flusher(*this));
+        flusher->start();
     }
 
-    void enableAutoFlush(bool yes)
+    void stopFlushing()
     {
-        DENG2_ASSERT(qApp);
-        if (yes)
+        if (!flusher) return;
         {
-            if (!autoFlushTimer->isActive())
-            {
-                // Every now and then the buffer will be flushed.
-                autoFlushTimer->start(int(FLUSH_INTERVAL.asMilliSeconds()));
-            }
+            std::lock_guard<std::mutex> lock(flusherMutex);
+            stopFlusher = true;
+            flusherWake.notify_one();
         }
-        else
+        flusher->wait();
+        flusher.reset();
+    }
+
+    void wakeFlusher()
+    {
+        if (flusher && !flushRequested.exchange(true))
         {
-            autoFlushTimer->stop();
+            std::lock_guard<std::mutex> lock(flusherMutex);
+            flusherWake.notify_one();
         }
     }
 
+    /// Verbose entries can be dropped when the flusher can't keep up.
+    static bool isDroppable(LogEntry const &entry)
+    {
+        return entry.level() <= LogEntry::Verbose &&
+               !(entry.metadata() & (LogEntry::Privileged | LogEntry::Interactive));
+    }
+
+    /**
+     * Moves the queued entries to the buffer. The buffer must be locked.
+     */
+    void collectEntries()
+    {
+        while (LogEntry *entry = queue.pop())
+        {
+            entries.push_back(entry);
+            toBeFlushed.push_back(entry);
+        }
+    }
+
+    /**
+     * Adds a warning about dropped entries. The buffer must be locked.
+     */
+    void noteDroppedEntries()
+    {
+        duint64 const dropped = droppedCount.load();
+        if (dropped == reportedDropCount) return;
+
+        LogEntry::Args args;
+        args << LogEntry::Arg::newFromPool(dropped - reportedDropCount);
+        reportedDropCount = dropped;
+
+        LogEntry *note = new LogEntry(LogEntry::Generic | LogEntry::Warning, "", 0,
+                                      "%i verbose log entries were dropped because the "
+                                      "log buffer was full", args);
+        entries.push_back(note);
+        toBeFlushed.push_back(note);
+    }
+
     void createFileLogSink(bool truncate)
     {
         if (!outputPath.isEmpty())
@@ -154,13 +345,12 @@ LogBuffer *LogBuffer::_appBuffer = nullptr;
 
 LogBuffer::LogBuffer(duint maxEntryCount)
     : d(new Impl(this, maxEntryCount))
-{
-    d->autoFlushTimer = new QTimer(this);
-    connect(d->autoFlushTimer, SIGNAL(timeout()), this, SLOT(flush()));
-}
+{}
 
 LogBuffer::~LogBuffer()
 {
+    d->stopFlushing();
+
     DENG2_GUARD(this);
 
     setOutputFile("");
@@ -176,22 +366,26 @@ void LogBuffer::clear()
     // Flush first, we don't want to miss any messages.
     flush();
 
+    d->collectEntries();
     DENG2_FOR_EACH(Impl::EntryList, i, d->entries)
     {
         delete *i;
     }
     d->entries.clear();
+    d->toBeFlushed.clear();
 }
 
 dsize LogBuffer::size() const
 {
     DENG2_GUARD(this);
+    d->collectEntries();
     return d->entries.size();
 }
 
 void LogBuffer::latestEntries(Entries &entries, int count) const
 {
     DENG2_GUARD(this);
+    d->collectEntries();
     entries.clear();
     for (int i = d->entries.size() - 1; i >= 0; --i)
     {
@@ -233,17 +427,41 @@ void LogBuffer::setMaxEntryCount(duint maxEntryCount)
 
 void LogBuffer::add(LogEntry *entry)
 {
-    DENG2_GUARD(this);
+    if (d->queue.push(entry))
+    {
+        if (d->queue.size() > d->queue.capacity() / 2)
+        {
+            // Don't wait for the interval to pass.
+            d->wakeFlusher();
+        }
+        return;
+    }
 
-    // We will not flush the new entry as it likely has not yet been given
-    // all its arguments.
-    if (d->lastFlushedAt.isValid() && d->lastFlushedAt.since() > FLUSH_INTERVAL)
+    // The queue is full, so the flusher is not keeping up.
+    if (d->flusher && Impl::isDroppable(*entry))
     {
-        flush();
+        ++d->droppedCount;
+        delete entry;
+        return;
     }
 
+    // The entry is stored by the adding thread instead.
+    ++d->stallCount;
+    DENG2_GUARD(this);
+    d->collectEntries();
     d->entries.push_back(entry);
     d->toBeFlushed.push_back(entry);
+    d->wakeFlusher();
+}
+
+duint64 LogBuffer::droppedEntryCount() const
+{
+    return d->droppedCount.load();
+}
+
+duint64 LogBuffer::stallCount() const
+{
+    return d->stallCount.load();
 }
 
 void LogBuffer::enableStandardOutput(bool yes)
@@ -259,14 +477,19 @@ void LogBuffer::enableStandardOutput(bool yes)
 void LogBuffer::enableFlushing(bool yes)
 {
     d->flushingEnabled = yes;
-    d->enableAutoFlush(true);
+    if (yes)
+    {
+        d->startFlushing();
+    }
 }
 
 void LogBuffer::setAutoFlushInterval(TimeSpan const &interval)
 {
+    {
+        std::lock_guard<std::mutex> lock(d->flusherMutex);
+        d->flushInterval = interval;
+    }
     enableFlushing();
-
-    d->autoFlushTimer->setInterval(interval.asMilliSeconds());
 }
 
 void LogBuffer::setOutputFile(String const &path, OutputChangeBehavior behavior)
@@ -308,6 +531,9 @@ void LogBuffer::flush()
 
     DENG2_GUARD(this);
 
+    d->collectEntries();
+    d->noteDroppedEntries();
+
     if (!d->toBeFlushed.isEmpty())
     {
         DENG2_FOR_EACH(Impl::EntryList, i, d->toBeFlushed)
@@ -26,6 +26,10 @@
 #include "de/App"
 #include "de/Log"
 #include "de/ByteRefArray"
+#include "de/math.h"
+
+#include <QtEndian>
+#include <cstring>
 
 // Heap relations.
 #define HEAP_PARENT(i)  (((i) + 1)/2 - 1)
@@ -128,6 +132,19 @@ struct HuffBuffer {
     dsize size;
 };
 
+/**
+ * Entry of the decoding lookup table, indexed with the next LOOKUP_BITS bits of
+ * the coded data.
+ */
+struct HuffLookup {
+    HuffNode const *node;     // Subtree to continue in, if the code is longer.
+    dbyte value;
+    dbyte length;             // Zero if the code is longer than LOOKUP_BITS.
+};
+
+// Number of bits decoded in one step using the lookup table.
+static int const LOOKUP_BITS = 11;
+
 struct Huffman
 {
     // The root of the Huffman tree.
@@ -136,12 +153,19 @@ struct Huffman
     // The lookup table for encoding.
     HuffCode huffCodes[256];
 
+    // The lookup table for decoding.
+    HuffLookup huffLookup[1 << LOOKUP_BITS];
+
+    duint minLength;
+    duint maxLength;
+
     /**
      * Builds the Huffman tree and initializes the code lookup.
      */
-    Huffman() : huffRoot(0)
+    Huffman() : huffRoot(0), minLength(32), maxLength(0)
     {
         zap(huffCodes);
+        zap(huffLookup);
 
         HuffQueue queue;
         HuffNode *node;
@@ -171,8 +195,9 @@ struct Huffman
         // The root is the last node left in the queue.
         huffRoot = Huff_QueueExtract(&queue);
 
-        // Fill in the code lookup table.
+        // Fill in the code lookup tables.
         Huff_BuildLookup(huffRoot, 0, 0);
+        Huff_BuildDecodeLookup();
 
 #if 0
         if (qApp->arguments().contains("-huffcodes"))
@@ -307,6 +332,8 @@ struct Huffman
             // This is a leaf.
             huffCodes[node->value].code = code;
             huffCodes[node->value].length = length;
+            minLength = de::min(minLength, length);
+            maxLength = de::max(maxLength, length);
             return;
         }
 
@@ -326,6 +353,42 @@ struct Huffman
         }
     }
 
+    /**
+     * Builds the table for decoding LOOKUP_BITS bits at a time. Codes are stored
+     * starting from the least significant bit, so all the table indices whose low
+     * bits match a code are mapped to that code.
+     */
+    void Huff_BuildDecodeLookup()
+    {
+        duint const mask = (1 << LOOKUP_BITS) - 1;
+        for (int i = 0; i < 256; ++i)
+        {
+            HuffCode const &hc = huffCodes[i];
+            if (hc.length > duint(LOOKUP_BITS)) continue;
+
+            for (duint high = 0; high < (1u << (LOOKUP_BITS - hc.length)); ++high)
+            {
+                HuffLookup &entry = huffLookup[(hc.code | (high << hc.length)) & mask];
+                entry.value  = dbyte(i);
+                entry.length = dbyte(hc.length);
+            }
+        }
+
+        // Longer codes continue from the node reached after LOOKUP_BITS bits.
+        for (duint index = 0; index <= mask; ++index)
+        {
+            HuffLookup &entry = huffLookup[index];
+            if (entry.length) continue;
+
+            HuffNode const *node = huffRoot;
+            for (int bit = 0; bit < LOOKUP_BITS; ++bit)
+            {
+                node = (index & (1 << bit))? node->right : node->left;
+            }
+            entry.node = node;
+        }
+    }
+
     /**
      * Checks if the encoding/decoding buffer can hold the given number of
      * bytes. If not, reallocates the buffer.
@@ -364,7 +427,10 @@ struct Huffman
         zapPtr(buffer);
     }
 
-    dbyte *encode(dbyte const *data, dsize size, dsize *encodedSize) const
+    /**
+     * Encodes one bit at a time into a newly allocated buffer.
+     */
+    dbyte *encodeBitwise(dbyte const *data, dsize size, dsize *encodedSize) const
     {
         HuffBuffer huffEnc;
         dsize i;
@@ -429,7 +495,11 @@ struct Huffman
         return huffEnc.data;
     }
 
-    dbyte *decode(dbyte const *data, dsize size, dsize *decodedSize) const
+    /**
+     * Decodes by walking the Huffman tree one bit at a time into a newly allocated
+     * buffer.
+     */
+    dbyte *decodeBitwise(dbyte const *data, dsize size, dsize *decodedSize) const
     {
         HuffBuffer huffDec;
         HuffNode *node;
@@ -496,17 +566,161 @@ struct Huffman
         }
         return huffDec.data;
     }
+
+    dsize encodedSizeMax(dsize size) const
+    {
+        return (3 + size * maxLength + 7) / 8;
+    }
+
+    dsize decodedSizeMax(dsize codedSize) const
+    {
+        if (!codedSize) return 0;
+        return (codedSize * 8 - 3) / minLength;
+    }
+
+    /**
+     * Encodes into @a out, which must have room for encodedSizeMax() bytes. The
+     * codes are collected in a 64-bit accumulator and written 32 bits at a time.
+     *
+     * @return Size of the encoded data.
+     */
+    dsize encode(dbyte const *data, dsize size, dbyte *out) const
+    {
+        dbyte *const begin = out;
+
+        // First three bits of the encoded data contain the number of bits (-1)
+        // in the last byte of the encoded data.
+        duint64 acc = 0;
+        int accBits = 3;
+
+        for (dsize i = 0; i < size; ++i)
+        {
+            HuffCode const &hc = huffCodes[data[i]];
+            acc |= duint64(hc.code) << accBits;
+            accBits += hc.length;
+            if (accBits >= 32)
+            {
+                qToLittleEndian(quint32(acc), out);
+                out += 4;
+                acc >>= 32;
+                accBits -= 32;
+            }
+        }
+
+        // Write the remaining bits.
+        int const lastByteBits = (accBits & 7? accBits & 7 : 8);
+        for (; accBits > 0; accBits -= 8)
+        {
+            *out++ = dbyte(acc);
+            acc >>= 8;
+        }
+        begin[0] = dbyte((begin[0] & ~7) | (lastByteBits - 1));
+        return dsize(out - begin);
+    }
+
+    /**
+     * Decodes into @a out using the lookup table. Decoding stops if @a out becomes
+     * full; decodedSizeMax() is always enough.
+     *
+     * @return Size of the decoded data.
+     */
+    dsize decode(dbyte const *data, dsize size, dbyte *out, dsize outSize) const
+    {
+        if (!data || size == 0) return 0;
+
+        dsize const totalBits = (size - 1) * 8 + (data[0] & 7) + 1;
+        duint const mask = (1 << LOOKUP_BITS) - 1;
+        dsize pos = 3;
+        dsize outBytes = 0;
+
+        while (pos < totalBits && outBytes < outSize)
+        {
+            // Peek at the next bits. Bits past the end are zero.
+            dsize const byte = pos / 8;
+            duint64 bits;
+            if (byte + 8 <= size)
+            {
+                bits = qFromLittleEndian<quint64>(data + byte);
+            }
+            else
+            {
+                bits = 0;
+                for (dsize k = 0; byte + k < size; ++k)
+                {
+                    bits |= duint64(data[byte + k]) << (8 * k);
+                }
+            }
+            bits >>= pos % 8;
+
+            HuffLookup const &entry = huffLookup[bits & mask];
+            if (entry.length)
+            {
+                if (pos + entry.length > totalBits) break; // Incomplete code.
+                out[outBytes++] = entry.value;
+                pos += entry.length;
+                continue;
+            }
+
+            // Continue bit by bit in the tree.
+            HuffNode const *node = entry.node;
+            dsize end = pos + LOOKUP_BITS;
+            while (node->left || node->right)
+            {
+                if (end >= totalBits) return outBytes; // Incomplete code.
+                node = (data[end / 8] & (1 << (end % 8)))? node->right : node->left;
+                ++end;
+            }
+            out[outBytes++] = node->value;
+            pos = end;
+        }
+        return outBytes;
+    }
 };
 
 } // namespace internal
 
 static internal::Huffman huff;
 
+dsize codec::huffmanEncodedSizeMax(dsize size)
+{
+    return huff.encodedSizeMax(size);
+}
+
+dsize codec::huffmanDecodedSizeMax(dsize codedSize)
+{
+    return huff.decodedSizeMax(codedSize);
+}
+
+dsize codec::huffmanEncode(dbyte const *data, dsize size, dbyte *encoded)
+{
+    return huff.encode(data, size, encoded);
+}
+
+dsize codec::huffmanDecode(dbyte const *codedData, dsize codedSize, dbyte *decoded,
+                           dsize decodedSize)
+{
+    return huff.decode(codedData, codedSize, decoded, decodedSize);
+}
+
 Block codec::huffmanEncode(Block const &data)
+{
+    Block result(huff.encodedSizeMax(data.size()));
+    result.resize(huff.encode(data.data(), data.size(), result.data()));
+    return result;
+}
+
+Block codec::huffmanDecode(Block const &codedData)
+{
+    Block result(huff.decodedSizeMax(codedData.size()));
+    result.resize(huff.decode(codedData.data(), codedData.size(), result.data(), result.size()));
+    return result;
+}
+
+Block codec::huffmanEncodeTree(Block const &data)
 {
     Block result;
     dsize size = 0;
-    dbyte *coded = huff.encode(data.data(), data.size(), &size);
+    dbyte *coded = huff.encodeBitwise(data.data(), data.size(), &size);
     if (coded)
     {
         result.copyFrom(ByteRefArray(coded, size), 0, size);
@@ -515,11 +729,11 @@ Block codec::huffmanEncode(Block const &data)
     return result;
 }
 
-Block codec::huffmanDecode(Block const &codedData)
+Block codec::huffmanDecodeTree(Block const &codedData)
 {
     Block result;
     dsize size = 0;
-    dbyte *decoded = huff.decode(codedData.data(), codedData.size(), &size);
+    dbyte *decoded = huff.decodeBitwise(codedData.data(), codedData.size(), &size);
     if (decoded)
     {
         result.copyFrom(ByteRefArray(decoded, size), 0, size);
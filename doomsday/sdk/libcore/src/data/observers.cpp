@@ -17,6 +17,18 @@
  */
 
 #include "de/Observers"
+#include "de/Log"
+
+#include <QMap>
+#include <algorithm>
+#include <mutex>
+#include <set>
+#include <vector>
+
+#ifdef __GNUC__
+#  include <cxxabi.h>
+#  include <cstdlib>
+#endif
 
 namespace de {
 
@@ -47,4 +59,227 @@ void ObserverBase::removeMemberOf(IAudience &observers)
     _memberOf.value.remove(&observers);
 }
 
+//---------------------------------------------------------------------------------------
+
+DENG2_PIMPL_NOREF(ObserverSnapshots)
+{
+    struct Data : public Snapshot
+    {
+        std::unique_ptr<std::atomic<PointerSet::Pointer>[]> storage;
+        Data *nextRetired = nullptr;
+
+        Data(PointerSet const &set) : storage(new std::atomic<PointerSet::Pointer>[set.size()])
+        {
+            count   = set.size();
+            members = storage.get();
+            int i = 0;
+            for (PointerSet::Pointer ptr : set)
+            {
+                members[i++].store(ptr, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    std::atomic<Data *> current { nullptr };
+    std::atomic_int readers { 0 };
+    Data *retired = nullptr; ///< Discarded snapshots that may still be read.
+
+    ~Impl()
+    {
+        DENG2_ASSERT(!readers.load());
+        delete current.load();
+        deleteRetired();
+    }
+
+    void deleteRetired()
+    {
+        while (retired)
+        {
+            Data *next = retired->nextRetired;
+            delete retired;
+            retired = next;
+        }
+    }
+
+    void retire(Data *data)
+    {
+        data->nextRetired = retired;
+        retired = data;
+    }
+
+    /// Retired snapshots can be deleted when there are no readers. New readers will
+    /// only see the current snapshot. The audience lock is held by the caller.
+    void collectGarbage()
+    {
+        if (!readers.load()) deleteRetired();
+    }
+};
+
+ObserverSnapshots::ObserverSnapshots() : d(new Impl)
+{}
+
+ObserverSnapshots::Snapshot const *
+ObserverSnapshots::beginReading(PointerSet const &members, Lockable const &lock) const
+{
+    ++d->readers;
+    Impl::Data *snapshot = d->current.load();
+    if (!snapshot)
+    {
+        // The members have changed, so a new snapshot is needed.
+        DENG2_GUARD(lock);
+        snapshot = d->current.load();
+        if (!snapshot)
+        {
+            snapshot = new Impl::Data(members);
+            d->current.store(snapshot);
+        }
+    }
+    return snapshot;
+}
+
+void ObserverSnapshots::endReading() const
+{
+    --d->readers;
+}
+
+void ObserverSnapshots::invalidate(PointerSet::Pointer removed)
+{
+    if (removed)
+    {
+        // Ongoing notifications must skip the removed member.
+        for (Impl::Data *data = d->retired; data; data = data->nextRetired)
+        {
+            for (int i = 0; i < data->count; ++i)
+            {
+                if (data->members[i].load() == removed) data->members[i].store(nullptr);
+            }
+        }
+    }
+    if (Impl::Data *old = d->current.exchange(nullptr))
+    {
+        if (removed)
+        {
+            for (int i = 0; i < old->count; ++i)
+            {
+                if (old->members[i].load() == removed) old->members[i].store(nullptr);
+            }
+        }
+        d->retire(old);
+    }
+    d->collectGarbage();
+}
+
+//---------------------------------------------------------------------------------------
+
+std::atomic_bool AudienceStats::_enabled { false };
+
+namespace internal {
+
+struct AudienceStatsRegistry
+{
+    std::mutex mutex;
+    std::set<AudienceStats *> all;
+
+    static AudienceStatsRegistry &get()
+    {
+        static AudienceStatsRegistry registry;
+        return registry;
+    }
+};
+
+static String audienceTypeName(char const *typeName)
+{
+#ifdef __GNUC__
+    int status = 0;
+    if (char *demangled = abi::__cxa_demangle(typeName, nullptr, nullptr, &status))
+    {
+        String const name = demangled;
+        free(demangled);
+        return name;
+    }
+#endif
+    return typeName;
+}
+
+} // namespace internal
+
+using internal::AudienceStatsRegistry;
+
+AudienceStats::AudienceStats(char const *typeName)
+    : _typeName(typeName)
+    , _notifications(0)
+    , _calls(0)
+{
+    auto &reg = AudienceStatsRegistry::get();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.all.insert(this);
+}
+
+AudienceStats::~AudienceStats()
+{
+    auto &reg = AudienceStatsRegistry::get();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.all.erase(this);
+}
+
+void AudienceStats::setEnabled(bool enabled)
+{
+    _enabled = enabled;
+}
+
+void AudienceStats::reset()
+{
+    auto &reg = AudienceStatsRegistry::get();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for (AudienceStats *stats : reg.all)
+    {
+        stats->_notifications = 0;
+        stats->_calls = 0;
+    }
+}
+
+void AudienceStats::print(int maxCount)
+{
+    struct Counts { duint64 notifications = 0; duint64 calls = 0; };
+
+    // The same audience type may be registered by several libraries.
+    QMap<String, Counts> byType;
+    {
+        auto &reg = AudienceStatsRegistry::get();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        for (AudienceStats const *stats : reg.all)
+        {
+            duint64 const count = stats->_notifications.load();
+            if (!count) continue;
+            Counts &counts = byType[internal::audienceTypeName(stats->_typeName)];
+            counts.notifications += count;
+            counts.calls         += stats->_calls.load();
+        }
+    }
+
+    std::vector<std::pair<String, Counts>> sorted;
+    for (auto i = byType.constBegin(); i != byType.constEnd(); ++i)
+    {
+        sorted.push_back(std::make_pair(i.key(), i.value()));
+    }
+    std::sort(sorted.begin(), sorted.end(), [] (std::pair<String, Counts> const &a,
+                                                std::pair<String, Counts> const &b) {
+        return a.second.notifications > b.second.notifications;
+    });
+
+    LOG_AS("AudienceStats");
+    if (!isEnabled())
+    {
+        LOG_MSG("Collecting audience statistics is disabled");
+    }
+    LOG_MSG(_E(b) "%i audience types notified:") << int(sorted.size());
+    for (int i = 0; i < int(sorted.size()) && i < maxCount; ++i)
+    {
+        LOG_MSG("%10i notifications %10i calls " _E(>) "%s")
+                << sorted[i].second.notifications
+                << sorted[i].second.calls
+                << sorted[i].first;
+    }
+}
+
 } // namespace de
@@ -24,11 +24,233 @@
 #include "de/Guard"
 
 #include <QDebug>
+#include <vector>
 
 namespace de {
 
 Path::hash_type const PathTree::no_hash = Path::hash_range;
 
+namespace internal {
+
+/**
+ * Allocator for the nodes of one tree. Nodes are carved from large pages in
+ * slots of a few fixed sizes, and released slots are reused by later nodes of
+ * the same size. Pages are freed only when no nodes remain, so a node never
+ * moves. The arena is not thread-safe; the tree is locked while its nodes are
+ * created and destroyed.
+ */
+class NodeArena
+{
+public:
+    NodeArena() : _pos(nullptr), _end(nullptr), _liveCount(0)
+    {
+        for (FreeSlot *&slot : _freeSlots) slot = nullptr;
+    }
+
+    ~NodeArena()
+    {
+        DENG2_ASSERT(_liveCount == 0);
+        releasePages();
+    }
+
+    void *allocate(std::size_t size)
+    {
+        int const sc = sizeClass(size);
+        if (sc < 0) return ::operator new(size);
+
+        ++_liveCount;
+        if (FreeSlot *slot = _freeSlots[sc])
+        {
+            _freeSlots[sc] = slot->next;
+            return slot;
+        }
+        std::size_t const slotSize = std::size_t(sc + 1) * GRANULARITY;
+        if (!_pos || _pos + slotSize > _end)
+        {
+            _pos = static_cast<char *>(::operator new(PAGE_BYTES));
+            _end = _pos + PAGE_BYTES;
+            _pages.push_back(_pos);
+        }
+        void *ptr = _pos;
+        _pos += slotSize;
+        return ptr;
+    }
+
+    void release(void *ptr, std::size_t size)
+    {
+        int const sc = sizeClass(size);
+        if (sc < 0)
+        {
+            ::operator delete(ptr);
+            return;
+        }
+        FreeSlot *slot = static_cast<FreeSlot *>(ptr);
+        slot->next = _freeSlots[sc];
+        _freeSlots[sc] = slot;
+
+        DENG2_ASSERT(_liveCount > 0);
+        if (--_liveCount == 0)
+        {
+            // All the nodes are gone (e.g., the tree was cleared).
+            releasePages();
+        }
+    }
+
+private:
+    struct FreeSlot { FreeSlot *next; };
+
+    static std::size_t const PAGE_BYTES  = 0x10000;
+    static std::size_t const GRANULARITY = 16;
+    static int const CLASS_COUNT         = 16; // largest slot is 256 bytes
+
+    static int sizeClass(std::size_t size)
+    {
+        int const sc = int((size + GRANULARITY - 1) / GRANULARITY) - 1;
+        return (sc < CLASS_COUNT? sc : -1);
+    }
+
+    void releasePages()
+    {
+        for (char *page : _pages) ::operator delete(page);
+        _pages.clear();
+        _pos = _end = nullptr;
+        for (FreeSlot *&slot : _freeSlots) slot = nullptr;
+    }
+
+    std::vector<char *> _pages;
+    char *_pos;
+    char *_end;
+    FreeSlot *_freeSlots[CLASS_COUNT];
+    int _liveCount;
+};
+
+/// Arena used for allocating nodes in the current thread.
+static thread_local NodeArena *currentArena = nullptr;
+
+/**
+ * Selects the arena for PathTree::Node allocations while the scope exists.
+ */
+struct NodeArenaScope
+{
+    NodeArena *previous;
+
+    NodeArenaScope(NodeArena *arena) : previous(currentArena) { currentArena = arena; }
+    ~NodeArenaScope() { currentArena = previous; }
+};
+
+/**
+ * Open-addressing hash table that finds a node by its parent and segment
+ * identifier. Linear probing is used, and removals shift the following
+ * entries back so that there is no need for tombstones.
+ */
+class NodeIndex
+{
+public:
+    NodeIndex() : _count(0) {}
+
+    void clear()
+    {
+        _slots.clear();
+        _count = 0;
+    }
+
+    PathTree::Node *find(PathTree::Node const *parent, PathTree::SegmentId segmentId) const
+    {
+        if (_slots.empty()) return nullptr;
+
+        duint32 const hash = hashKey(parent, segmentId);
+        for (std::size_t i = hash & mask(); _slots[i].node; i = (i + 1) & mask())
+        {
+            Slot const &slot = _slots[i];
+            if (slot.hash == hash && slot.segmentId == segmentId && &slot.node->parent() == parent)
+            {
+                return slot.node;
+            }
+        }
+        return nullptr;
+    }
+
+    void insert(PathTree::Node *parent, PathTree::SegmentId segmentId, PathTree::Node *node)
+    {
+        // Keep the load factor below 3/4.
+        if ((_count + 1) * 4 > _slots.size() * 3)
+        {
+            rehash(_slots.empty()? 64 : _slots.size() * 2);
+        }
+        Slot slot;
+        slot.node      = node;
+        slot.segmentId = segmentId;
+        slot.hash      = hashKey(parent, segmentId);
+        place(slot);
+        ++_count;
+    }
+
+    void remove(PathTree::Node *parent, PathTree::SegmentId segmentId, PathTree::Node *node)
+    {
+        if (_slots.empty()) return;
+
+        std::size_t hole = hashKey(parent, segmentId) & mask();
+        for (; _slots[hole].node != node; hole = (hole + 1) & mask())
+        {
+            if (!_slots[hole].node) return; // Not indexed.
+        }
+
+        // Move back the entries that would become unreachable.
+        for (std::size_t i = (hole + 1) & mask(); _slots[i].node; i = (i + 1) & mask())
+        {
+            std::size_t const home = _slots[i].hash & mask();
+            if (((i - home) & mask()) >= ((i - hole) & mask()))
+            {
+                _slots[hole] = _slots[i];
+                hole = i;
+            }
+        }
+        _slots[hole] = Slot();
+        --_count;
+    }
+
+private:
+    struct Slot
+    {
+        PathTree::Node *node = nullptr;
+        PathTree::SegmentId segmentId = 0;
+        duint32 hash = 0;
+    };
+
+    static duint32 hashKey(PathTree::Node const *parent, PathTree::SegmentId segmentId)
+    {
+        duint64 h = duint64(reinterpret_cast<quintptr>(parent)) * 0x9e3779b97f4a7c15ull + segmentId;
+        h ^= h >> 32;
+        h *= 0xd6e8feb86659fd93ull;
+        h ^= h >> 32;
+        return duint32(h);
+    }
+
+    std::size_t mask() const { return _slots.size() - 1; }
+
+    void place(Slot const &slot)
+    {
+        std::size_t i = slot.hash & mask();
+        while (_slots[i].node) i = (i + 1) & mask();
+        _slots[i] = slot;
+    }
+
+    void rehash(std::size_t size)
+    {
+        std::vector<Slot> old(size);
+        old.swap(_slots);
+        for (Slot const &slot : old)
+        {
+            if (slot.node) place(slot);
+        }
+    }
+
+    std::vector<Slot> _slots; // size is a power of two
+    std::size_t _count;
+};
+
+} // namespace internal
+
 struct PathTree::Impl
 {
     PathTree &self;
@@ -50,6 +272,14 @@ struct PathTree::Impl
     /// Path node hashes (leaves and branches).
     PathTree::NodeHash hash;
 
+    /// Memory for the nodes (excluding the root node).
+    internal::NodeArena arena;
+
+    /// Nodes indexed by parent and segment. Leaves are not included in
+    /// MultiLeaf trees, because new leaves are always created for them.
+    internal::NodeIndex branchIndex;
+    internal::NodeIndex leafIndex;
+
     Impl(PathTree &d, int _flags)
         : self(d), flags(_flags), size(0), numNodesOwned(0),
           rootNode(PathTree::NodeArgs(d, PathTree::Branch, 0))
@@ -62,8 +292,12 @@ struct PathTree::Impl
 
     void clear()
     {
+        internal::NodeArenaScope scope(&arena);
+
         clearPathHash(hash.leaves);
         clearPathHash(hash.branches);
+        branchIndex.clear();
+        leafIndex.clear();
         size = 0;
 
         DENG2_ASSERT(numNodesOwned == 0);
@@ -76,6 +310,24 @@ struct PathTree::Impl
         return internId;
     }
 
+    bool isIndexed(PathTree::NodeType nodeType) const
+    {
+        return nodeType == PathTree::Branch || !(flags & PathTree::MultiLeaf);
+    }
+
+    internal::NodeIndex &index(PathTree::NodeType nodeType)
+    {
+        return (nodeType == PathTree::Leaf? leafIndex : branchIndex);
+    }
+
+    void unindex(PathTree::Node &node)
+    {
+        if (isIndexed(node.type()))
+        {
+            index(node.type()).remove(&node.parent(), node.segmentId(), &node);
+        }
+    }
+
     /**
      * @return Tree node that matches the name and type and which has the
      * specified parent node.
@@ -87,19 +339,12 @@ struct PathTree::Impl
 
         // Have we already encountered this?
         PathTree::SegmentId segmentId = segments.isInterned(segment);
-        if (segmentId)
+        if (segmentId && isIndexed(nodeType))
         {
             // The name is known. Perhaps we have.
-            Path::hash_type hashKey = segments.userValue(segmentId);
-            for (PathTree::Nodes::const_iterator i = hash.find(hashKey);
-                i != hash.end() && i.key() == hashKey; ++i)
+            if (PathTree::Node *node = index(nodeType).find(parent, segmentId))
             {
-                PathTree::Node *node = *i;
-                if (parent    != &node->parent()) continue;
-                if (segmentId != node->segmentId()) continue;
-
-                if (nodeType == PathTree::Branch || !(flags & PathTree::MultiLeaf))
-                    return node;
+                return node;
             }
         }
 
@@ -119,10 +364,18 @@ struct PathTree::Impl
             hashKey = self.segmentHash(segmentId);
         }
 
-        PathTree::Node *node = self.newNode(PathTree::NodeArgs(self, nodeType, segmentId, parent));
+        PathTree::Node *node;
+        {
+            internal::NodeArenaScope scope(&arena);
+            node = self.newNode(PathTree::NodeArgs(self, nodeType, segmentId, parent));
+        }
 
         // Insert the new node into the hash.
         const_cast<Nodes &>(hash).insert(hashKey, node);
+        if (isIndexed(nodeType))
+        {
+            index(nodeType).insert(parent, segmentId, node);
+        }
 
         numNodesOwned++;
 
@@ -169,6 +422,7 @@ struct PathTree::Impl
                 // This is the leaf node we're looking for.
                 if (compFlags.testFlag(RelinquishMatching))
                 {
+                    unindex(*node);
                     node->parent().removeChild(*node);
                     hash.erase(i);
                     numNodesOwned--;
@@ -226,6 +480,8 @@ struct PathTree::Impl
 
 PathTree::PathTree(Flags flags)
 {
+    // The root node is not allocated from any arena.
+    internal::NodeArenaScope scope(nullptr);
     d = new Impl(*this, flags);
 }
 
@@ -233,6 +489,7 @@ PathTree::~PathTree()
 {
     DENG2_GUARD(this);
 
+    internal::NodeArenaScope scope(nullptr);
     delete d;
 }
 
@@ -258,7 +515,9 @@ bool PathTree::remove(Path const &path, ComparisonFlags flags)
     {
         // One less unique path in the tree.
         d->size--;
-        delete node;        
+
+        internal::NodeArenaScope scope(&d->arena);
+        delete node;
         return true;
     }
     return false;
@@ -362,6 +621,25 @@ PathTree::Node *PathTree::newNode(NodeArgs const &args)
     return new Node(args);
 }
 
+void *PathTree::Node::operator new(std::size_t size)
+{
+    if (internal::currentArena)
+    {
+        return internal::currentArena->allocate(size);
+    }
+    return ::operator new(size);
+}
+
+void PathTree::Node::operator delete(void *ptr, std::size_t size)
+{
+    if (internal::currentArena)
+    {
+        internal::currentArena->release(ptr, size);
+        return;
+    }
+    ::operator delete(ptr);
+}
+
 PathTree::Nodes const &PathTree::nodes(NodeType type) const
 {
     DENG2_GUARD(this);
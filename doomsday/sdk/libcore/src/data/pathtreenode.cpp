@@ -55,6 +55,17 @@ DENG2_PIMPL_NOREF(PathTree::Node)
     {
         segmentText = &tree.segmentName(segmentId);
     }
+
+    // The private instance is allocated along with the node.
+    static void *operator new(std::size_t size)
+    {
+        return PathTree::Node::operator new(size);
+    }
+
+    static void operator delete(void *ptr, std::size_t size)
+    {
+        PathTree::Node::operator delete(ptr, size);
+    }
 };
 
 PathTree::Node::Node(PathTree::NodeArgs const &args) : d(nullptr)
@@ -43,20 +43,32 @@ DENG2_PIMPL_NOREF(Variable)
     /// Mode flags.
     Flags flags;
 
-    Impl() : value(0) {}
+    Impl() : value(0)
+    {
+        initAudiences();
+    }
 
     Impl(Impl const &other)
         : de::IPrivate()
         , name (other.name)
         , value(other.value->duplicate())
         , flags(other.flags)
-    {}
+    {
+        initAudiences();
+    }
 
     ~Impl()
     {
         delete value;
     }
 
+    void initAudiences()
+    {
+        // Values are set much more often than observers come and go.
+        audienceForChange    .setSynchronization(ChangeAudience::ThreadSafeSnapshot);
+        audienceForChangeFrom.setSynchronization(ChangeFromAudience::ThreadSafeSnapshot);
+    }
+
     DENG2_PIMPL_AUDIENCE(Deletion)
     DENG2_PIMPL_AUDIENCE(Change)
     DENG2_PIMPL_AUDIENCE(ChangeFrom)
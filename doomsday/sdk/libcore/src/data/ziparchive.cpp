@@ -20,6 +20,7 @@
 #include "de/ZipArchive"
 #include "de/Block"
 #include "de/ByteArrayFile"
+#include "de/ByteRefArray"
 #include "de/ByteSubArray"
 #include "de/Date"
 #include "de/File"
@@ -28,13 +29,17 @@
 #include "de/LittleEndianByteOrder"
 #include "de/LogBuffer"
 #include "de/MetadataBank"
+#include "de/NativeFile"
 #include "de/Reader"
+#include "de/TaskGroup"
 #include "de/Writer"
 #include "de/Zeroed"
 
 // Interpretations:
 #include "de/ArchiveFolder"
 
+#include <QFile>
+#include <QSet>
 #include <cstring>
 #include <zlib.h>
 
@@ -57,6 +62,9 @@ namespace internal {
 // Deflate minimum compression. Worse than this will be stored uncompressed.
 #define REQUIRED_DEFLATE_PERCENTAGE .98
 
+// Compressed data that isn't in memory is read from the source in pieces of this size.
+#define INFLATE_INPUT_SIZE      (64 * 1024)
+
 // File header flags.
 #define ZFH_ENCRYPTED           0x1
 #define ZFH_COMPRESSION_OPTS    0x6
@@ -269,8 +277,212 @@ DENG2_PIMPL(ZipArchive)
     CentralEnd zipSummary;
     QVector<std::pair<Block, CentralFileHeader>> centralHeaders;
 
+    /// Contents of the source, if accessible directly in memory.
+    IByteArray::Byte const *sourceData = nullptr;
+    dsize sourceSize = 0;
+    QFile mappedFile;
+    uchar *mapping = nullptr;
+
     Impl(Public *i) : Base(i) {}
 
+    ~Impl()
+    {
+        if (mapping)
+        {
+            mappedFile.unmap(mapping);
+        }
+    }
+
+    /**
+     * Looks for a way to access the source data without copying it. Blocks are
+     * used as-is, and native files that are not going to be written are mapped
+     * to memory.
+     */
+    void accessSourceDirectly(IByteArray const &source)
+    {
+        if (Block const *block = maybeAs<Block>(source))
+        {
+            sourceData = block->data();
+            sourceSize = block->size();
+        }
+        else if (NativeFile const *native = maybeAs<NativeFile>(source))
+        {
+            if (native->mode().testFlag(File::Write)) return;
+
+            mappedFile.setFileName(native->nativePath());
+            if (mappedFile.open(QFile::ReadOnly))
+            {
+                mapping = mappedFile.map(0, mappedFile.size());
+                mappedFile.close(); // The mapping remains valid.
+            }
+            if (mapping)
+            {
+                sourceData = mapping;
+                sourceSize = dsize(mappedFile.size());
+            }
+        }
+    }
+
+    /**
+     * Returns the serialized data of an entry, if it is available in memory.
+     */
+    IByteArray::Byte const *serializedData(ZipEntry const &entry) const
+    {
+        if (entry.dataInArchive)
+        {
+            return entry.dataInArchive->data();
+        }
+        if (!self().source() || !sourceData) return nullptr;
+        if (entry.offset + entry.sizeInArchive > sourceSize) return nullptr;
+        return sourceData + entry.offset;
+    }
+
+    /**
+     * Determines if the source can be read from several threads at once.
+     */
+    bool isSourceConcurrent() const
+    {
+        return sourceData || maybeAs<NativeFile>(self().source());
+    }
+
+    /**
+     * Decompresses the data of an entry into @a buffer. The compressed data is
+     * read from the source in pieces unless it is in memory, so no copy of the
+     * compressed data is needed.
+     *
+     * @param entry       Compressed entry.
+     * @param buffer      Output buffer.
+     * @param bufferSize  Size of @a buffer.
+     * @param sink        Called with the number of produced bytes whenever the buffer
+     *                    is full, and at the end of the data. Returns @c false to
+     *                    stop decompressing. If @c nullptr, the whole entry is
+     *                    decompressed into @a buffer, and it must decompress to
+     *                    exactly @a bufferSize bytes.
+     *
+     * @return Total number of decompressed bytes.
+     */
+    dsize inflateEntry(ZipEntry const &entry, IByteArray::Byte *buffer, dsize bufferSize,
+                       std::function<bool (dsize)> const &sink) const
+    {
+        DENG2_ASSERT(entry.compression == DEFLATED);
+
+        z_stream stream;
+        zap(stream);
+
+        /*
+         * Set up a raw inflate with a window of -15 bits.
+         *
+         * From zlib documentation:
+         *
+         * "windowBits can also be –8..–15 for raw inflate. In this case,
+         * -windowBits determines the window size. inflate() will then process
+         * raw deflate data, not looking for a zlib or gzip header, not
+         * generating a check value, and not looking for any check values for
+         * comparison at the end of the stream. This is for use with other
+         * formats that use the deflate compressed data format such as 'zip'."
+         */
+        if (inflateInit2(&stream, -MAX_WBITS) != Z_OK)
+        {
+            /// @throw InflateError Problem with zlib: inflateInit2 failed.
+            throw InflateError("ZipArchive::readEntry",
+                               "Inflation failed because initialization failed");
+        }
+
+        IByteArray::Byte const *input = serializedData(entry);
+        Block inputPiece;
+        dsize inputPos = 0;
+        dsize produced = 0;
+        dint result = Z_OK;
+        bool stopped = false;
+
+        // When reading the whole entry, output beyond the buffer goes here.
+        IByteArray::Byte *output = buffer;
+        dsize outputSize = bufferSize;
+        IByteArray::Byte excess = 0;
+        try
+        {
+            forever
+            {
+                if (!stream.avail_in && inputPos < entry.sizeInArchive)
+                {
+                    if (input)
+                    {
+                        stream.next_in  = const_cast<IByteArray::Byte *>(input);
+                        stream.avail_in = uInt(entry.sizeInArchive);
+                        inputPos = entry.sizeInArchive;
+                    }
+                    else
+                    {
+                        DENG2_ASSERT(self().source() != NULL);
+                        dsize const count = de::min(dsize(INFLATE_INPUT_SIZE),
+                                                    entry.sizeInArchive - inputPos);
+                        inputPiece.resize(count);
+                        self().source()->get(entry.offset + inputPos, inputPiece.data(), count);
+                        stream.next_in  = inputPiece.data();
+                        stream.avail_in = uInt(count);
+                        inputPos += count;
+                    }
+                }
+
+                stream.next_out  = output + produced;
+                stream.avail_out = uInt(outputSize - produced);
+                result = inflate(&stream, Z_NO_FLUSH);
+                produced = outputSize - stream.avail_out;
+
+                if (result != Z_OK && result != Z_STREAM_END && result != Z_BUF_ERROR)
+                {
+                    break; // Corrupt data.
+                }
+                bool const inputEnded = (!stream.avail_in && inputPos >= entry.sizeInArchive);
+                if (!sink)
+                {
+                    if (result == Z_STREAM_END || (result == Z_BUF_ERROR && inputEnded) ||
+                        stream.total_out > bufferSize)
+                    {
+                        break;
+                    }
+                    if (produced == outputSize)
+                    {
+                        // The buffer is full. The data must end without any
+                        // further output.
+                        output     = &excess;
+                        outputSize = 1;
+                        produced   = 0;
+                    }
+                    continue;
+                }
+                if (result == Z_STREAM_END || produced == bufferSize ||
+                    (result == Z_BUF_ERROR && inputEnded))
+                {
+                    stopped = !sink(produced);
+                    produced = 0;
+                    if (stopped || result != Z_OK) break;
+                }
+            }
+        }
+        catch (...)
+        {
+            inflateEnd(&stream);
+            throw;
+        }
+
+        dsize const total = stream.total_out;
+        String const msg = (stream.msg? stream.msg : "");
+        inflateEnd(&stream);
+
+        bool const corrupt = (result != Z_OK && result != Z_STREAM_END && result != Z_BUF_ERROR);
+        if (corrupt || (stopped? total > entry.size : total != entry.size))
+        {
+            /// @throw InflateError The actual decompressed size is not equal to the
+            /// size listed in the central directory.
+            throw InflateError("ZipArchive::readEntry",
+                               "Failure due to " +
+                               String((result == Z_DATA_ERROR ? "corrupt data in archive"
+                                                              : "zlib error")) + ": " + msg);
+        }
+        return total;
+    }
+
     /**
      * Locates the central directory. Start from the earliest location where
      * the signature might be.
@@ -529,6 +741,7 @@ ZipArchive::ZipArchive(IByteArray const &archive, Block const &dirCacheId)
     setIndex(new Index);
 
     d->directoryCacheId = dirCacheId;
+    d->accessSourceDirectly(archive);
 
     if (d->restoreFromCache())
     {
@@ -558,9 +771,9 @@ void ZipArchive::readFromSource(Entry const &e, Path const &, IBlock &uncompress
     if (entry.compression == NO_COMPRESSION)
     {
         // Data is not compressed so we can just read it.
-        if (entry.dataInArchive)
+        if (IByteArray::Byte const *data = d->serializedData(entry))
         {
-            uncompressedData.copyFrom(*entry.dataInArchive, 0, entry.size);
+            uncompressedData.copyFrom(ByteRefArray(data, entry.size), 0, entry.size);
         }
         else
         {
@@ -573,57 +786,119 @@ void ZipArchive::readFromSource(Entry const &e, Path const &, IBlock &uncompress
         // Prepare the output buffer for the decompressed data.
         uncompressedData.resize(entry.size);
 
-        // Take a copy of the compressed data for zlib.
-        if (!entry.dataInArchive)
-        {
-            DENG2_ASSERT(source() != NULL);
-            entry.dataInArchive.reset(new Block(*source(), entry.offset, entry.sizeInArchive));
-        }
+        // Inflate directly to the output buffer.
+        d->inflateEntry(entry, const_cast<IByteArray::Byte *>(uncompressedData.data()), entry.size,
+                        nullptr);
 
-        z_stream stream;
-        zap(stream);
-        stream.next_in = const_cast<IByteArray::Byte *>(entry.dataInArchive->data());
-        stream.avail_in = entry.sizeInArchive;
-        stream.zalloc = Z_NULL;
-        stream.zfree = Z_NULL;
-        stream.next_out = const_cast<IByteArray::Byte *>(uncompressedData.data());
-        stream.avail_out = entry.size;
+        entry.dataInArchive.reset(); // Now have the decompressed version.
+    }
+}
 
-        /*
-         * Set up a raw inflate with a window of -15 bits.
-         *
-         * From zlib documentation:
-         *
-         * "windowBits can also be –8..–15 for raw inflate. In this case,
-         * -windowBits determines the window size. inflate() will then process
-         * raw deflate data, not looking for a zlib or gzip header, not
-         * generating a check value, and not looking for any check values for
-         * comparison at the end of the stream. This is for use with other
-         * formats that use the deflate compressed data format such as 'zip'."
-         */
-        if (inflateInit2(&stream, -MAX_WBITS) != Z_OK)
+void ZipArchive::streamEntry(Path const &path, StreamFunc const &consumer, dsize pieceSize) const
+{
+    ZipEntry const *entry = static_cast<ZipEntry const *>(
+                index().tryFind(path, PathTree::MatchFull | PathTree::NoBranch));
+    if (!entry)
+    {
+        /// @throw NotFoundError Entry with @a path was not found.
+        throw NotFoundError("ZipArchive::streamEntry", String("'%1' not found").arg(path));
+    }
+    if (!entry->size) return;
+
+    DENG2_ASSERT(pieceSize > 0);
+    pieceSize = de::min(pieceSize, entry->size);
+
+    IByteArray::Byte const *inMemory = nullptr;
+    if (entry->data)
+    {
+        inMemory = entry->data->data();
+    }
+    else if (entry->compression == NO_COMPRESSION)
+    {
+        inMemory = d->serializedData(*entry);
+    }
+
+    if (inMemory)
+    {
+        for (dsize pos = 0; pos < entry->size; pos += pieceSize)
         {
-            /// @throw InflateError Problem with zlib: inflateInit2 failed.
-            throw InflateError("ZipArchive::readEntry",
-                               "Inflation failed because initialization failed");
+            if (!consumer(inMemory + pos, de::min(pieceSize, entry->size - pos))) break;
         }
+    }
+    else if (entry->compression == NO_COMPRESSION)
+    {
+        DENG2_ASSERT(source() != NULL);
+        Block piece;
+        for (dsize pos = 0; pos < entry->size; pos += pieceSize)
+        {
+            piece.resize(de::min(pieceSize, entry->size - pos));
+            source()->get(entry->offset + pos, piece.data(), piece.size());
+            if (!consumer(piece.data(), piece.size())) break;
+        }
+    }
+    else
+    {
+        Block piece(pieceSize);
+        d->inflateEntry(*entry, piece.data(), pieceSize, [&piece, &consumer] (dsize size)
+        {
+            return consumer(piece.data(), size);
+        });
+    }
+}
 
-        // Do the inflation in one call.
-        dint result = inflate(&stream, Z_FINISH);
+void ZipArchive::prefetch(QList<Path> const &paths) const
+{
+    QVector<ZipEntry *> entries;
+    QSet<ZipEntry *> included; // each entry is read only once
+    for (Path const &path : paths)
+    {
+        if (auto *entry = static_cast<ZipEntry *>(const_cast<Index &>(index()).tryFind(
+                              path, PathTree::MatchFull | PathTree::NoBranch)))
+        {
+            if (!entry->data && entry->size && !included.contains(entry))
+            {
+                included.insert(entry);
+                entries << entry;
+            }
+        }
+    }
+    if (entries.isEmpty()) return;
 
-        if (stream.total_out != entry.size)
+    // The entries are read in parallel and stored afterwards in this thread.
+    QVector<Block *> blocks(entries.size());
+    auto readEntries = [this, &entries, &blocks] (int begin, int end)
+    {
+        for (int i = begin; i < end; ++i)
         {
-            /// @throw InflateError The actual decompressed size is not equal to the
-            /// size listed in the central directory.
-            throw InflateError("ZipArchive::readEntry",
-                               "Failure due to " +
-                               String((result == Z_DATA_ERROR ? "corrupt data in archive"
-                                                              : "zlib error")) + ": " + stream.msg);
+            std::unique_ptr<Block> block(new Block);
+            try
+            {
+                readFromSource(*entries.at(i), Path(), *block);
+                blocks[i] = block.release();
+            }
+            catch (Error const &er)
+            {
+                // The error is thrown again when the entry is accessed.
+                LOG_RES_WARNING("Failed to prefetch \"%s\": %s")
+                        << entries.at(i)->path() << er.asText();
+            }
         }
+    };
+    if (d->isSourceConcurrent())
+    {
+        parallelFor(0, entries.size(), readEntries);
+    }
+    else
+    {
+        readEntries(0, entries.size());
+    }
 
-        // We're done.
-        inflateEnd(&stream);
-        entry.dataInArchive.reset(); // Now have the decompressed version.
+    for (int i = 0; i < entries.size(); ++i)
+    {
+        if (blocks.at(i))
+        {
+            entries[i]->data.reset(blocks.at(i));
+        }
     }
 }
 
@@ -17,25 +17,163 @@
  */
 
 #include "de/FileIndex"
+#include "de/Folder"
 #include "de/ReadWriteLockable"
 #include "de/PackageLoader"
 #include "de/App"
 #include "de/LogBuffer"
 
+#include <QHash>
+#include <QVarLengthArray>
+#include <QVector>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
 namespace de {
 
-DENG2_PIMPL(FileIndex), public ReadWriteLockable
+DENG2_PIMPL(FileIndex), public Lockable
 {
+    typedef duint32 NameId; ///< Zero is not a valid identifier.
+
+    /**
+     * Interned lower-case names of files and folders. Only modified while the
+     * index is locked for modification.
+     */
+    struct Names : public ReadWriteLockable
+    {
+        QHash<String, NameId> ids;
+        QVector<String> strings; ///< Indexed by NameId - 1.
+
+        /// Looks up the identifier of a name. Returns zero if not interned.
+        NameId find(String const &lowerName) const
+        {
+            DENG2_GUARD_READ(this);
+            return ids.value(lowerName);
+        }
+
+        NameId intern(String const &lowerName)
+        {
+            // Only the modifying thread adds names, so no need to lock for reading.
+            if (NameId id = ids.value(lowerName)) return id;
+
+            DENG2_GUARD_WRITE(this);
+            strings.append(lowerName);
+            NameId const id = NameId(strings.size());
+            ids.insert(lowerName, id);
+            return id;
+        }
+
+        String string(NameId id) const
+        {
+            DENG2_GUARD_READ(this);
+            return strings.at(int(id) - 1);
+        }
+    };
+
+    /**
+     * Parent folder of indexed files. Folders with the same path share the same
+     * chain. Chains are not modified or deleted while the index exists.
+     */
+    struct FolderChain
+    {
+        FolderChain const *parent;
+        NameId name;
+        QHash<NameId, FolderChain *> children; ///< Accessed only when modifying.
+
+        FolderChain(FolderChain const *up = nullptr, NameId id = 0)
+            : parent(up), name(id) {}
+
+        ~FolderChain() { qDeleteAll(children); }
+    };
+
+    struct Entry
+    {
+        NameId name;
+        FolderChain const *folder;
+        File *file;
+    };
+
+    struct Link;
+    typedef std::shared_ptr<Link> BucketRef;
+
+    /**
+     * Buckets are persistent singly linked lists, newest entry first. Links are not
+     * modified after they have been published in the table: adding prepends a new
+     * link, and removing copies only the links ahead of the removed one and shares
+     * the rest of the list.
+     */
+    struct Link
+    {
+        Entry entry;
+        BucketRef next;
+
+        Link(Entry const &e, BucketRef const &rest) : entry(e), next(rest) {}
+
+        ~Link()
+        {
+            // Release the unshared part of the list iteratively rather than recursing
+            // through every destructor.
+            BucketRef rest = std::move(next);
+            while (rest && rest.use_count() == 1)
+            {
+                rest = std::move(rest->next);
+            }
+        }
+    };
+
+    struct Table
+    {
+        std::vector<BucketRef> buckets; ///< Size is a power of two.
+
+        Table(dsize size) : buckets(size) {}
+
+        BucketRef &bucket(NameId id) { return buckets[id & (buckets.size() - 1)]; }
+        BucketRef const &bucket(NameId id) const { return buckets[id & (buckets.size() - 1)]; }
+    };
+
+    /**
+     * Lookups are not locked, so a removed file may still be in use by lookups that
+     * began before it was removed. Removal waits until those lookups have ended
+     * before the file is allowed to be destroyed. Readers count themselves in the
+     * slot of the current epoch; removal advances the epoch and waits for the
+     * previous slot to empty.
+     */
+    struct ReadSection
+    {
+        Impl const &index;
+        duint epoch;
+
+        ReadSection(Impl const &idx) : index(idx), epoch(idx.epoch.load())
+        {
+            index.readers[epoch & 1].fetch_add(1);
+        }
+
+        ~ReadSection()
+        {
+            index.readers[epoch & 1].fetch_sub(1);
+        }
+    };
+
     IPredicate const *predicate;
-    Index index;
+    Names names;
+    FolderChain rootChain;              ///< Above the root folder.
+    std::shared_ptr<Table> table;       ///< Replaced when the table grows.
+    std::atomic_int count { 0 };
+    std::atomic_uint epoch { 0 };
+    mutable std::atomic_int readers[2] {{0}, {0}};
 
     Impl(Public *i)
         : Base(i)
         , predicate(0)
+        , table(std::make_shared<Table>(64))
     {
-        // File operations may occur in several threads.
-        audienceForAddition.setAdditionAllowedDuringIteration(true);
-        audienceForRemoval .setAdditionAllowedDuringIteration(true);
+        // File operations may occur in several threads. Files are added and removed
+        // far more often than the audiences change.
+        audienceForAddition.setSynchronization(AdditionAudience::ThreadSafeSnapshot);
+        audienceForRemoval .setSynchronization(RemovalAudience::ThreadSafeSnapshot);
     }
 
     static String indexedName(File const &file)
@@ -51,34 +189,133 @@ DENG2_PIMPL(FileIndex), public ReadWriteLockable
         return name;
     }
 
-    void add(File const &file)
+    std::shared_ptr<Table const> currentTable() const
     {
-        DENG2_GUARD_WRITE(this);
+        return std::atomic_load(&table);
+    }
 
-        index.insert(std::pair<String, File *>(indexedName(file), const_cast<File *>(&file)));
+    FolderChain const *folderChainOf(File const &file)
+    {
+        QVarLengthArray<Folder const *, 16> folders;
+        for (Folder const *folder = file.parent(); folder; folder = folder->parent())
+        {
+            folders.append(folder);
+        }
+        FolderChain *chain = &rootChain;
+        for (int i = folders.size() - 1; i >= 0; --i)
+        {
+            NameId const id = names.intern(folders.at(i)->name().lower());
+            FolderChain *&child = chain->children[id];
+            if (!child) child = new FolderChain(chain, id);
+            chain = child;
+        }
+        return chain;
     }
 
-    void remove(File const &file)
+    void growTableIfNeeded()
     {
-        DENG2_GUARD_WRITE(this);
+        Table const &current = *table;
+        if (dsize(names.strings.size()) <= current.buckets.size() * 2) return;
 
-        if (index.empty())
+        auto grown = std::make_shared<Table>(current.buckets.size() * 4);
+        QVector<Entry> entries;
+        for (BucketRef const &bucket : current.buckets)
         {
-            return;
+            entries.clear();
+            for (Link const *link = bucket.get(); link; link = link->next.get())
+            {
+                entries.append(link->entry);
+            }
+            // Each new bucket receives entries from only one old bucket, so prepending
+            // the oldest entries first keeps the order intact.
+            for (int i = entries.size() - 1; i >= 0; --i)
+            {
+                BucketRef &slot = grown->bucket(entries.at(i).name);
+                slot = std::make_shared<Link>(entries.at(i), slot);
+            }
         }
+        std::atomic_store(&table, grown);
+    }
 
-        // Look up the ones that might be this file.
-        IndexRange range = index.equal_range(indexedName(file));
+    void add(File const &file)
+    {
+        DENG2_GUARD(this);
 
-        for (Index::iterator i = range.first; i != range.second; ++i)
+        Entry const entry { names.intern(indexedName(file)), folderChainOf(file),
+                            const_cast<File *>(&file) };
+        growTableIfNeeded();
+
+        // Lookups in progress keep using the old head of the list.
+        BucketRef &slot = table->bucket(entry.name);
+        std::atomic_store(&slot, std::make_shared<Link>(entry, slot));
+        ++count;
+    }
+
+    void remove(File const &file)
+    {
+        DENG2_GUARD(this);
+
+        if (!count.load()) return;
+
+        NameId const id = names.ids.value(indexedName(file));
+        if (!id) return;
+
+        BucketRef &slot = table->bucket(id);
+        QVarLengthArray<Link const *, 16> ahead;
+        for (Link const *link = slot.get(); link; link = link->next.get())
         {
-            if (i->second == &file)
+            if (link->entry.file == &file)
             {
-                // This is the one to deindex.
-                index.erase(i);
+                // This is the one to deindex. Copy the links ahead of it and share
+                // the rest of the list.
+                BucketRef updated = link->next;
+                for (int i = ahead.size() - 1; i >= 0; --i)
+                {
+                    updated = std::make_shared<Link>(ahead.at(i)->entry, updated);
+                }
+                std::atomic_store(&slot, updated);
+                --count;
+                waitForReaders();
                 break;
             }
+            ahead.append(link);
+        }
+    }
+
+    /// Waits until all lookups that may have seen the current contents have ended.
+    void waitForReaders()
+    {
+        duint const previous = epoch.fetch_add(1);
+        while (readers[previous & 1].load())
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    /// Composes the path of a folder without accessing the folder itself.
+    String folderPath(FolderChain const *folder) const
+    {
+        if (!folder->parent)
+        {
+            return String(); // File without a parent.
+        }
+        if (folder->parent == &rootChain)
+        {
+            return "/" + names.string(folder->name);
+        }
+        return folderPath(folder->parent) / names.string(folder->name);
+    }
+
+    static bool folderEndsWith(FolderChain const *folder, QVarLengthArray<NameId, 8> const &segments)
+    {
+        // The segments are in reverse order. The root chain has no name, so it never
+        // matches a segment.
+        for (int i = 0; i < segments.size(); ++i)
+        {
+            if (folder->name != segments.at(i)) return false;
+            folder = folder->parent;
         }
+        return true;
     }
 
     void findPartialPath(String const &path, FoundFiles &found) const
@@ -92,17 +329,65 @@ DENG2_PIMPL(FileIndex), public ReadWriteLockable
             dir = "/" + dir;
         }
 
-        DENG2_GUARD_READ(this);
+        NameId const nameId = names.find(baseName);
+        if (!nameId) return;
 
-        ConstIndexRange range = index.equal_range(baseName);
-        for (Index::const_iterator i = range.first; i != range.second; ++i)
+        // Look up the folder names, deepest first. Unusual paths (e.g., with empty
+        // segments) are compared as strings.
+        QVarLengthArray<NameId, 8> segments;
+        bool bySegment = true;
+        if (!dir.empty())
         {
-            File *file = i->second;
-            if (file->path().fileNamePath().endsWith(dir, String::CaseInsensitive))
+            QStringList const parts = dir.mid(1).split(QChar('/'));
+            bySegment = !parts.contains(QString());
+            for (int i = parts.size() - 1; bySegment && i >= 0; --i)
             {
-                found.push_back(file);
+                NameId const id = names.find(parts.at(i));
+                if (!id) return; // No such folder.
+                segments.append(id);
             }
         }
+
+        auto const current = currentTable();
+        BucketRef const bucket = std::atomic_load(&current->bucket(nameId));
+
+        // The list is newest first; results are inserted so they appear in the order
+        // the files were indexed.
+        auto insertAt = found.end();
+        for (Link const *link = bucket.get(); link; link = link->next.get())
+        {
+            Entry const &entry = link->entry;
+            if (entry.name != nameId) continue;
+            if (bySegment? folderEndsWith(entry.folder, segments)
+                         : folderPath(entry.folder).endsWith(dir, String::CaseInsensitive))
+            {
+                insertAt = found.insert(insertAt, entry.file);
+            }
+        }
+    }
+
+    /// Returns all indexed entries, sorted by name.
+    QList<std::pair<String, File *>> sortedEntries() const
+    {
+        QList<std::pair<String, File *>> sorted;
+        auto const current = currentTable();
+        for (BucketRef const &slot : current->buckets)
+        {
+            BucketRef const bucket = std::atomic_load(&slot);
+            int const first = sorted.size();
+            for (Link const *link = bucket.get(); link; link = link->next.get())
+            {
+                sorted.append(std::make_pair(names.string(link->entry.name), link->entry.file));
+            }
+            // Oldest first within the bucket.
+            std::reverse(sorted.begin() + first, sorted.end());
+        }
+        std::stable_sort(sorted.begin(), sorted.end(),
+                         [] (std::pair<String, File *> const &a,
+                             std::pair<String, File *> const &b) {
+            return a.first < b.first;
+        });
+        return sorted;
     }
 
     DENG2_PIMPL_AUDIENCE(Addition)
@@ -151,8 +436,7 @@ void FileIndex::remove(File const &file)
 
 int FileIndex::size() const
 {
-    DENG2_GUARD_READ(d);
-    return int(d->index.size());
+    return d->count.load();
 }
 
 static bool fileNotInAnyLoadedPackage(File *file)
@@ -163,6 +447,8 @@ static bool fileNotInAnyLoadedPackage(File *file)
 
 void FileIndex::findPartialPath(String const &path, FoundFiles &found, Behavior behavior) const
 {
+    Impl::ReadSection const reading(*d);
+
     d->findPartialPath(path, found);
 
     if (behavior == FindOnlyInLoadedPackages)
@@ -174,6 +460,8 @@ void FileIndex::findPartialPath(String const &path, FoundFiles &found, Behavior
 void FileIndex::findPartialPath(Folder const &rootFolder, String const &path,
                                 FoundFiles &found, Behavior behavior) const
 {
+    Impl::ReadSection const reading(*d);
+
     findPartialPath(path, found, behavior);
 
     // Remove any matches outside the given root.
@@ -189,6 +477,8 @@ void FileIndex::findPartialPath(String const &packageId, String const &path,
     Package const &pkg = App::packageLoader().package(packageId);
     if (is<Folder>(pkg.file()))
     {
+        Impl::ReadSection const reading(*d);
+
         findPartialPath(pkg.root(), path, found, FindInEntireIndex);
 
         // Remove any matches not in the given package.
@@ -205,32 +495,22 @@ int FileIndex::findPartialPathInPackageOrder(String const &path, FoundFiles &fou
     return int(found.size());
 }
 
-FileIndex::Index::const_iterator FileIndex::begin() const
-{
-    return d.getConst()->index.begin();
-}
-
-FileIndex::Index::const_iterator FileIndex::end() const
-{
-    return d.getConst()->index.end();
-}
-
 void FileIndex::print() const
 {
-    DENG2_GUARD_READ(d);
-    for (auto i = begin(); i != end(); ++i)
+    Impl::ReadSection const reading(*d);
+
+    for (auto const &entry : d->sortedEntries())
     {
-        LOG_TRACE("\"%s\": ", i->first << i->second->description());
+        LOG_TRACE("\"%s\": ", entry.first << entry.second->description());
     }
 }
 
 QList<File *> FileIndex::files() const
 {
-    DENG2_GUARD_READ(d);
     QList<File *> list;
-    for (auto i = begin(); i != end(); ++i)
+    for (auto const &entry : d->sortedEntries())
     {
-        list.append(i->second);
+        list.append(entry.second);
     }
     return list;
 }
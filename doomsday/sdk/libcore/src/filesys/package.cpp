@@ -18,6 +18,7 @@
 
 #include "de/Package"
 #include "de/App"
+#include "de/ArchiveEntryFile"
 #include "de/DotPath"
 #include "de/LogBuffer"
 #include "de/PackageLoader"
@@ -27,6 +28,7 @@
 #include "de/ScriptedInfo"
 #include "de/TextValue"
 #include "de/TimeValue"
+#include "de/ZipArchive"
 
 #include <QRegularExpression>
 
@@ -53,6 +55,28 @@ static String const VAR_ID  ("ID");
 static String const VAR_PATH("path");
 static String const VAR_TAGS("tags");
 
+/**
+ * Decompresses the given files concurrently if they are entries of the same ZIP
+ * archive, so reading them afterwards does not have to wait for each one in turn.
+ */
+static void prefetchArchiveEntries(std::initializer_list<File const *> files)
+{
+    ZipArchive const *zip = nullptr;
+    QList<Path> paths;
+    for (File const *file : files)
+    {
+        if (!file) continue;
+        if (auto const *entry = maybeAs<ArchiveEntryFile>(file->source()))
+        {
+            auto const *arch = maybeAs<ZipArchive>(entry->archive());
+            if (!arch || (zip && zip != arch)) continue;
+            zip = arch;
+            paths << entry->entryPath();
+        }
+    }
+    if (zip) zip->prefetch(paths);
+}
+
 Package::Asset::Asset(Record const &rec) : RecordAccessor(rec) {}
 
 Package::Asset::Asset(Record const *rec) : RecordAccessor(rec) {}
@@ -269,6 +293,9 @@ void Package::parseMetadata(File &packageFile) // static
             if (!needParse) return;
         }
 
+        // Both sources are read right away.
+        prefetchArchiveEntries({ metadataInfo, initializerScript });
+
         // The package identifier and path are automatically set.
         Record &metadata = initializeMetadata(packageFile);
 
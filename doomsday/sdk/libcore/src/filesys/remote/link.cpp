@@ -286,10 +286,30 @@ void Link::chunkReceived(QueryId id, duint64 startOffset, Block const &chunk, du
             return;
         }
 
-        // Before the first chunk, notify about the total size.
+        if (startOffset != query->receivedBytes)
+        {
+            if (!startOffset)
+            {
+                // The transfer starts over: the requested range was ignored, or the
+                // file changed on the remote end. The size is announced again and
+                // the data received earlier is overwritten.
+                query->startOffset = query->receivedBytes = 0;
+                query->fileSize = 0;
+            }
+            else
+            {
+                LOG_NET_WARNING("Received data at offset %i of \"%s\", expected offset %i")
+                        << startOffset << query->path << query->receivedBytes;
+                d->pendingQueries.remove(id);
+                return;
+            }
+        }
+
+        // Before the first chunk, notify about the total size and where the data
+        // begins. Data beginning at zero replaces anything received earlier.
         if (!query->fileSize)
         {
-            query->fileContents->call(0, Block(), fileSize);
+            query->fileContents->call(startOffset, Block(), fileSize);
         }
 
         query->fileSize = fileSize;
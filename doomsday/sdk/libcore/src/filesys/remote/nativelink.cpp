@@ -160,6 +160,8 @@ void NativeLink::transmit(Query const &query)
     else if (query.fileContents)
     {
         packet.setQuery(RemoteFeedQueryPacket::FileContents);
+        packet.setStartOffset(query.startOffset);
+        packet.setResumeValidator(query.resumeMetaId, query.resumeFileSize);
     }
     d->socket.sendPacket(packet);
 }
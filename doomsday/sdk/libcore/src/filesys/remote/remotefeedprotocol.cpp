@@ -42,6 +42,17 @@ void RemoteFeedQueryPacket::setPath(String const &path)
     _path = path;
 }
 
+void RemoteFeedQueryPacket::setStartOffset(duint64 offset)
+{
+    _startOffset = offset;
+}
+
+void RemoteFeedQueryPacket::setResumeValidator(Block const &metaId, duint64 fileSize)
+{
+    _resumeMetaId   = metaId;
+    _resumeFileSize = fileSize;
+}
+
 RemoteFeedQueryPacket::Query RemoteFeedQueryPacket::query() const
 {
     return _query;
@@ -52,16 +63,44 @@ String RemoteFeedQueryPacket::path() const
     return _path;
 }
 
+duint64 RemoteFeedQueryPacket::startOffset() const
+{
+    return _startOffset;
+}
+
+Block RemoteFeedQueryPacket::resumeMetaId() const
+{
+    return _resumeMetaId;
+}
+
+duint64 RemoteFeedQueryPacket::resumeFileSize() const
+{
+    return _resumeFileSize;
+}
+
 void RemoteFeedQueryPacket::operator >> (Writer &to) const
 {
     IdentifiedPacket::operator >> (to);
-    to << duint8(_query) << _path;
+    to << duint8(_query) << _path << _startOffset << _resumeMetaId << _resumeFileSize;
 }
 
 void RemoteFeedQueryPacket::operator << (Reader &from)
 {
     IdentifiedPacket::operator << (from);
     from.readAs<duint8>(_query) >> _path;
+
+    // Queries from older versions do not specify an offset or a validator.
+    _startOffset = 0;
+    _resumeMetaId.clear();
+    _resumeFileSize = 0;
+    if (!from.atEnd())
+    {
+        from >> _startOffset;
+    }
+    if (!from.atEnd())
+    {
+        from >> _resumeMetaId >> _resumeFileSize;
+    }
 }
 
 Packet *RemoteFeedQueryPacket::fromBlock(Block const &block)
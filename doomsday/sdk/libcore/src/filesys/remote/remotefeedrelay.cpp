@@ -176,7 +176,9 @@ RemoteFeedRelay::fetchFileList(String const &repository, String folderPath, File
 }
 
 Request<FileContents>
-RemoteFeedRelay::fetchFileContents(String const &repository, String filePath, FileContents contentsReceived)
+RemoteFeedRelay::fetchFileContents(String const &repository, String filePath,
+                                   FileContents contentsReceived, duint64 startOffset,
+                                   Block const &metaId, duint64 fileSize)
 {
     DENG2_ASSERT(d->repositories.contains(repository));
 
@@ -187,7 +189,13 @@ RemoteFeedRelay::fetchFileContents(String const &repository, String filePath, Fi
         // The repository sockets are handled in the main thread.
         auto *repo = d->repositories[repository];
         request.reset(new Request<FileContents>::element_type(contentsReceived));
-        repo->sendQuery(Query(request, filePath));
+        Query query(request, filePath, startOffset);
+        if (startOffset)
+        {
+            query.resumeMetaId   = metaId;
+            query.resumeFileSize = fileSize;
+        }
+        repo->sendQuery(query);
         done.post();
     });
     done.wait();
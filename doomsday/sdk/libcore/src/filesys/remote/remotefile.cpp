@@ -39,6 +39,7 @@ DENG2_PIMPL(RemoteFile)
     Block remoteMetaId;
     String repositoryAddress; // If empty, use feed's repository.
     Block buffer;
+    duint64 bufferedBytes = 0; ///< Contiguous data received from the start of the file.
     Request<FileContents> fetching;
 
     Impl(Public *i) : Base(i) {}
@@ -147,7 +148,14 @@ void RemoteFile::download()
         return;
     }
 
-    LOG_NET_MSG("Requesting download of \"%s\"") << name();
+    if (d->bufferedBytes)
+    {
+        LOG_NET_MSG("Resuming download of \"%s\" from offset %i") << name() << d->bufferedBytes;
+    }
+    else
+    {
+        LOG_NET_MSG("Requesting download of \"%s\"") << name();
+    }
 
     d->fetching = filesys::RemoteFeedRelay::get().fetchFileContents
             (d->repository(),
@@ -161,12 +169,33 @@ void RemoteFile::download()
         }
 
         // Keep received data in a buffer.
-        if (d->buffer.size() < remainingBytes)
+        if (chunk.isEmpty() && (!startOffset || startOffset == d->bufferedBytes))
+        {
+            // The size of the file and the offset of the data are announced before
+            // the data. If the transfer starts from the beginning, the file may have
+            // changed on the remote end, so the earlier data is dropped.
+            if (!startOffset)
+            {
+                d->buffer.clear();
+                d->bufferedBytes = 0;
+            }
+            d->buffer.resize(remainingBytes);
+        }
+        else if (d->buffer.size() < remainingBytes)
         {
             d->buffer.resize(remainingBytes);
         }
 
         d->buffer.set(startOffset, chunk.data(), chunk.size());
+        if (!startOffset && !chunk.isEmpty())
+        {
+            // Data from the beginning replaces anything received earlier.
+            d->bufferedBytes = chunk.size();
+        }
+        else if (startOffset <= d->bufferedBytes)
+        {
+            d->bufferedBytes = de::max(d->bufferedBytes, duint64(startOffset + chunk.size()));
+        }
 
         // When fully transferred, the file can be cached locally and interpreted.
         if (remainingBytes == 0)
@@ -180,6 +209,7 @@ void RemoteFile::download()
             File &data = cacheFolder.replaceFile(fn);
             data << d->buffer;
             d->buffer.clear();
+            d->bufferedBytes = 0;
             data.flush();
 
             // Override the last modified time.
@@ -204,22 +234,27 @@ void RemoteFile::download()
             // Now this RemoteFile can become the source of an interpreted file,
             // which replaces the RemoteFile within the parent folder.
         }
-    });
+    },
+    d->bufferedBytes,
+    d->remoteMetaId,
+    d->bufferedBytes? d->buffer.size() : 0);
 }
 
 void RemoteFile::cancelDownload()
 {
     if (d->fetching)
     {
+        // The data received so far is kept so the download can be resumed.
         d->fetching->cancel();
         d->fetching = nullptr;
-        d->buffer.clear();
         setState(NotReady);
     }
 }
 
 void RemoteFile::deleteCache()
 {
+    d->buffer.clear();
+    d->bufferedBytes = 0;
     setState(NotReady);
     FS::get().root().tryDestroyFile(d->cachePath());
 }
@@ -101,16 +101,47 @@ DENG2_PIMPL(WebHostedLink), public Lockable
         if (reply->error() == QNetworkReply::NoError)
         {
             //qDebug() << "Content-Length:" << reply->header(QNetworkRequest::ContentLengthHeader);
-            dsize const contentLength = reply->header(QNetworkRequest::ContentLengthHeader).toULongLong();
+            dsize fileSize = reply->header(QNetworkRequest::ContentLengthHeader).toULongLong();
 
             //qDebug() << "pos:" << pos << contentLength << reply->url();
 
-            // Ths is the complete downloaded file.
-            QByteArray const data = reply->readAll();
+            Query *query = self().findQuery(id);
+            if (!query) return;
 
-            Query const *query = self().findQuery(id);
-            self().chunkReceived(id, query->receivedBytes, data,
-                                 contentLength? contentLength : dsize(data.size()));
+            // Unless the server responds with partial content, the entire file is
+            // coming regardless of the requested range.
+            duint64 chunkOffset = 0;
+            if (query->startOffset &&
+                reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() == 206)
+            {
+                // The full size of the file is given in Content-Range
+                // ("bytes first-last/size").
+                QByteArray const range = reply->rawHeader("Content-Range");
+                int const dash  = range.indexOf('-');
+                int const slash = range.lastIndexOf('/');
+                if (range.startsWith("bytes ") && dash > 6 && slash > dash)
+                {
+                    chunkOffset = range.mid(6, dash - 6).trimmed().toULongLong();
+                    fileSize    = range.mid(slash + 1).toULongLong();
+                }
+                if (query->resumeFileSize && fileSize != query->resumeFileSize)
+                {
+                    // The file has changed since the interrupted transfer, so the rest
+                    // of it cannot be appended to the earlier contents.
+                    LOG_NET_MSG("%s has changed since the interrupted transfer, "
+                                "requesting it again") << query->path;
+                    reply->abort();
+                    query->startOffset = query->receivedBytes = 0;
+                    query->resumeMetaId.clear();
+                    query->resumeFileSize = 0;
+                    self().transmit(*query);
+                    return;
+                }
+            }
+
+            QByteArray const data = reply->readAll();
+            self().chunkReceived(id, chunkOffset, data,
+                                 fileSize? fileSize : dsize(chunkOffset + data.size()));
         }
         else
         {
@@ -194,6 +225,10 @@ void WebHostedLink::transmit(Query const &query)
     QNetworkRequest req(url.concatenateRelativePath(query.path));
     qDebug() << req.url().toString();
     req.setRawHeader("User-Agent", Version::currentBuild().userAgent().toLatin1());
+    if (query.startOffset)
+    {
+        req.setRawHeader("Range", QByteArray("bytes=") + QByteArray::number(query.startOffset) + "-");
+    }
 
     QNetworkReply *reply = RemoteFeedRelay::get().network().get(req);
     d->pendingRequests.insert(reply);
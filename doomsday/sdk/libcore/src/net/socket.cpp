@@ -62,6 +62,16 @@
  * Messages larger than or equal to 2^22 bytes (about 4MB) must be broken into
  * smaller pieces before sending.
  *
+ * @par Stream compression
+ * If both ends have agreed to it, a connection may send medium-sized messages
+ * compressed with a raw deflate stream that persists for the lifetime of the
+ * connection (see Socket::enableStreamCompression()). Each message ends in a
+ * sync flush, whose final empty stored block (00 00 FF FF) is left out and
+ * restored by the receiver. Message structure:
+ * - 1 byte: 0x80 | (payload size & 0x7f)
+ * - 1 byte: 0x20 | (payload size >> 7)
+ * - @em n bytes: payload contents (deflate stream)
+ *
  * @see Protocol_Send()
  * @see Protocol_Receive()
  */
@@ -74,6 +84,7 @@
 #include "de/data/huffman.h"
 
 #include <QThread>
+#include <zlib.h>
 
 namespace de {
 
@@ -101,10 +112,21 @@ static int const MAX_SIZE_LARGE  = DENG2_SOCKET_MAX_PAYLOAD_SIZE;
 /// the Huffman coded payload is used (unless it doesn't fit in a medium-sized packet).
 static int const MAX_HUFFMAN_INPUT_SIZE = 4096; // bytes
 
+/// With stream compression, messages of this size are compressed using the stream.
+/// Smaller ones are Huffman coded. Larger ones are compressed individually, because
+/// the stream output must fit in a medium-sized message.
+static int const MIN_STREAM_INPUT_SIZE = 16;   // bytes
+static int const MAX_STREAM_INPUT_SIZE = 4000; // bytes
+
+static int const STREAM_COMPRESSION_LEVEL = 6;
+static int const STREAM_WINDOW_BITS       = -15; // raw deflate
+static dsize const MAX_STREAM_DICTIONARY  = 32768;
+
 #define TRMF_CONTINUE           0x80
 #define TRMF_DEFLATED           0x40
+#define TRMF_STREAM             0x20
 #define TRMF_SIZE_MASK          0x7f
-#define TRMF_SIZE_MASK_MEDIUM   0x3f
+#define TRMF_SIZE_MASK_MEDIUM   0x1f
 #define TRMF_SIZE_SHIFT         7
 
 namespace internal {
@@ -117,21 +139,26 @@ struct MessageHeader : public ISerializable
     int size;
     bool isHuffmanCoded;
     bool isDeflated;
+    bool isStreamCompressed;
     duint channel; /// @todo include in the written header
 
-    MessageHeader() : size(0), isHuffmanCoded(false), isDeflated(false), channel(0)
+    MessageHeader()
+        : size(0), isHuffmanCoded(false), isDeflated(false), isStreamCompressed(false)
+        , channel(0)
     {}
 
     void operator >> (Writer &writer) const
     {
-        if (size <= MAX_SIZE_SMALL && !isDeflated)
+        if (size <= MAX_SIZE_SMALL && !isDeflated && !isStreamCompressed)
         {
             writer << dbyte(size);
         }
         else if (size <= MAX_SIZE_MEDIUM)
         {
             writer << dbyte(TRMF_CONTINUE | (size & TRMF_SIZE_MASK));
-            writer << dbyte((isDeflated? TRMF_DEFLATED : 0) | (size >> TRMF_SIZE_SHIFT));
+            writer << dbyte((isDeflated? TRMF_DEFLATED : 0) |
+                            (isStreamCompressed? TRMF_STREAM : 0) |
+                            (size >> TRMF_SIZE_SHIFT));
         }
         else if (size <= MAX_SIZE_LARGE)
         {
@@ -161,6 +188,7 @@ struct MessageHeader : public ISerializable
 
         isDeflated = false;
         isHuffmanCoded = true;
+        isStreamCompressed = false;
 
         if (b & TRMF_CONTINUE) // More follows...
         {
@@ -185,6 +213,11 @@ struct MessageHeader : public ISerializable
                     isDeflated = true;
                     isHuffmanCoded = false;
                 }
+                else if (b & TRMF_STREAM)
+                {
+                    isStreamCompressed = true;
+                    isHuffmanCoded = false;
+                }
                 size |= ((b & TRMF_SIZE_MASK_MEDIUM) << TRMF_SIZE_SHIFT);
             }
         }
@@ -222,14 +255,165 @@ DENG2_PIMPL_NOREF(Socket)
     /// Number of bytes written to the socket so far.
     dint64 totalBytesWritten = 0;
 
+    /// Persistent compression streams (see Socket::enableStreamCompression()).
+    bool streamCompression = false;
+    Block streamDictionary;
+    z_stream deflater;
+    z_stream inflater;
+    bool deflaterReady = false;
+    bool inflaterReady = false;
+
+    LockableT<CompressionStats> stats;
+
     ~Impl()
     {
         // Delete received messages left in the buffer.
         foreach (Message *msg, receivedMessages) delete msg;
+
+        resetStreams();
+    }
+
+    void resetStreams()
+    {
+        if (deflaterReady)
+        {
+            deflateEnd(&deflater);
+            deflaterReady = false;
+        }
+        if (inflaterReady)
+        {
+            inflateEnd(&inflater);
+            inflaterReady = false;
+        }
+    }
+
+    void initDeflater()
+    {
+        zap(deflater);
+        if (deflateInit2(&deflater, STREAM_COMPRESSION_LEVEL, Z_DEFLATED, STREAM_WINDOW_BITS,
+                         8, Z_DEFAULT_STRATEGY) != Z_OK)
+        {
+            throw ProtocolError("Socket::Impl::initDeflater", "Failed to initialize deflate stream");
+        }
+        deflaterReady = true;
+        if (!streamDictionary.isEmpty())
+        {
+            deflateSetDictionary(&deflater, streamDictionary.data(), uInt(streamDictionary.size()));
+        }
+    }
+
+    void initInflater()
+    {
+        zap(inflater);
+        if (inflateInit2(&inflater, STREAM_WINDOW_BITS) != Z_OK)
+        {
+            throw ProtocolError("Socket::Impl::initInflater", "Failed to initialize inflate stream");
+        }
+        inflaterReady = true;
+        if (!streamDictionary.isEmpty())
+        {
+            inflateSetDictionary(&inflater, streamDictionary.data(), uInt(streamDictionary.size()));
+        }
     }
 
-    void serializeMessage(MessageHeader &header, Block &payload)
+    /**
+     * Compresses @a payload using the connection's deflate stream. The output ends
+     * in a sync flush, without the final empty stored block.
+     */
+    Block streamCompress(Block const &payload)
     {
+        if (!deflaterReady) initDeflater();
+
+        Block out(deflateBound(&deflater, uLong(payload.size())) + 16);
+        deflater.next_in  = const_cast<Bytef *>(payload.data());
+        deflater.avail_in = uInt(payload.size());
+        dsize produced = 0;
+        forever
+        {
+            deflater.next_out  = out.data() + produced;
+            deflater.avail_out = uInt(out.size() - produced);
+            int const result = deflate(&deflater, Z_SYNC_FLUSH);
+            produced = out.size() - deflater.avail_out;
+            if (result != Z_OK && result != Z_BUF_ERROR)
+            {
+                throw ProtocolError("Socket::Impl::streamCompress", "Deflate stream failed");
+            }
+            if (deflater.avail_out > 0) break;
+            out.resize(out.size() * 2); // More output is pending.
+        }
+        DENG2_ASSERT(produced >= 4);
+        DENG2_ASSERT(out.at(produced - 1) == char(0xff) && out.at(produced - 2) == char(0xff));
+        out.resize(produced - 4);
+        return out;
+    }
+
+    /**
+     * Decompresses a message sent using the peer's deflate stream.
+     */
+    Block streamDecompress(dbyte const *data, dsize size)
+    {
+        static dbyte const syncFlushTail[4] = { 0x00, 0x00, 0xff, 0xff };
+
+        if (!inflaterReady) initInflater();
+
+        Block out(de::max(dsize(256), size * 4));
+        dsize produced = 0;
+        auto inflateInput = [this, &out, &produced] (dbyte const *in, dsize inSize)
+        {
+            inflater.next_in  = const_cast<Bytef *>(in);
+            inflater.avail_in = uInt(inSize);
+            forever
+            {
+                if (produced == out.size()) out.resize(out.size() * 2);
+                inflater.next_out  = out.data() + produced;
+                inflater.avail_out = uInt(out.size() - produced);
+                int const result = inflate(&inflater, Z_SYNC_FLUSH);
+                produced = out.size() - inflater.avail_out;
+                if (result != Z_OK && result != Z_BUF_ERROR)
+                {
+                    throw ProtocolError("Socket::Impl::streamDecompress", "Inflate stream failed");
+                }
+                if (!inflater.avail_in && inflater.avail_out) break;
+            }
+        };
+        inflateInput(data, size);
+        inflateInput(syncFlushTail, sizeof(syncFlushTail));
+        out.resize(produced);
+        return out;
+    }
+
+    void serializeMessage(MessageHeader &header, Block &payload, bool allowStream = false)
+    {
+        Time const startedAt;
+        dsize const payloadSize = payload.size();
+        compressMessage(header, payload, allowStream);
+
+        DENG2_GUARD(stats);
+        stats.value.sentPayloadBytes    += payloadSize;
+        stats.value.sentCompressedBytes += payload.size();
+        stats.value.compressTime        += startedAt.since();
+        if (header.isStreamCompressed)
+        {
+            stats.value.streamPayloadBytes += payloadSize;
+        }
+    }
+
+    void compressMessage(MessageHeader &header, Block &payload, bool allowStream)
+    {
+        if (allowStream && streamCompression &&
+            int(payload.size()) >= MIN_STREAM_INPUT_SIZE &&
+            int(payload.size()) <= MAX_STREAM_INPUT_SIZE)
+        {
+            payload = streamCompress(payload);
+            if (int(payload.size()) > MAX_SIZE_MEDIUM)
+            {
+                throw ProtocolError("Socket::send", "Stream-compressed payload is too large");
+            }
+            header.isStreamCompressed = true;
+            header.size = payload.size();
+            return;
+        }
+
         Block huffData;
 
         // Let's find the appropriate compression method of the payload. First see
@@ -328,6 +512,9 @@ DENG2_PIMPL_NOREF(Socket)
             counters.value.sentUncompressedBytes += payload.size();
         }
 
+        // Large messages never use the compression stream, so they can be compressed
+        // in the background.
+        static_assert(MAX_SIZE_BIG > MAX_STREAM_INPUT_SIZE, "Large messages must not be stream compressed");
         if (!retainOrder && packet.size() >= MAX_SIZE_BIG)
         {
             async([this, payload] ()
@@ -350,7 +537,7 @@ DENG2_PIMPL_NOREF(Socket)
         else
         {
             MessageHeader header;
-            serializeMessage(header, payload);
+            serializeMessage(header, payload, true /* stream allowed */);
             sendMessage(header, payload);
         }
     }
@@ -389,14 +576,30 @@ DENG2_PIMPL_NOREF(Socket)
             {
                 if (int(receivedBytes.size()) >= incomingHeader.size)
                 {
-                    // Extract the payload from the incoming buffer.
-                    Block payload = receivedBytes.left(incomingHeader.size);
+                    Time const startedAt;
+                    dsize const codedSize = dsize(incomingHeader.size);
+                    Block payload;
+                    if (incomingHeader.isHuffmanCoded)
+                    {
+                        // Decode directly from the incoming buffer.
+                        payload.resize(codec::huffmanDecodedSizeMax(codedSize));
+                        payload.resize(codec::huffmanDecode(receivedBytes.dataConst(), codedSize,
+                                                            payload.data(), payload.size()));
+                    }
+                    else if (incomingHeader.isStreamCompressed)
+                    {
+                        payload = streamDecompress(receivedBytes.dataConst(), codedSize);
+                    }
+                    else
+                    {
+                        // Extract the payload from the incoming buffer.
+                        payload = receivedBytes.left(incomingHeader.size);
+                    }
                     receivedBytes.remove(0, incomingHeader.size);
 
                     // We have the full payload, but it still may need to uncompressed.
                     if (incomingHeader.isHuffmanCoded)
                     {
-                        payload = codec::huffmanDecode(payload);
                         if (!payload.size())
                         {
                             throw ProtocolError("Socket::Impl::deserializeMessages", "Huffman decoding failed");
@@ -411,6 +614,13 @@ DENG2_PIMPL_NOREF(Socket)
                         }
                     }
 
+                    {
+                        DENG2_GUARD(stats);
+                        stats.value.receivedCompressedBytes += codedSize;
+                        stats.value.receivedPayloadBytes    += payload.size();
+                        stats.value.decompressTime          += startedAt.since();
+                    }
+
                     receivedMessages << new Message(Address(socket->peerAddress(), socket->peerPort()),
                                                     incomingHeader.channel, payload);
 
@@ -472,6 +682,10 @@ void Socket::open(Address const &address) // non-blocking
     LOG_AS("Socket");
     if (!d->quiet) LOG_NET_MSG("Opening connection to %s") << address.asText();
 
+    // Compression streams are specific to a connection.
+    d->resetStreams();
+    d->streamCompression = false;
+
     d->socket->connectToHost(address.host(), address.port());
     d->peer = address;
 }
@@ -621,6 +835,44 @@ void Socket::setRetainOrder(bool retainOrder)
     d->retainOrder = retainOrder;
 }
 
+String Socket::CompressionStats::asText() const
+{
+    return String("sent %1 bytes of %2 (%3%, %4% of the payloads via stream) in %5 ms; "
+                  "received %6 bytes of %7 in %8 ms")
+            .arg(sentCompressedBytes)
+            .arg(sentPayloadBytes)
+            .arg(sentRatio() * 100, 0, 'f', 1)
+            .arg(sentPayloadBytes? 100.0 * streamPayloadBytes / sentPayloadBytes : 0.0, 0, 'f', 1)
+            .arg(compressTime.asMilliSeconds(), 0, 'f', 1)
+            .arg(receivedCompressedBytes)
+            .arg(receivedPayloadBytes)
+            .arg(decompressTime.asMilliSeconds(), 0, 'f', 1);
+}
+
+void Socket::enableStreamCompression(bool yes)
+{
+    d->streamCompression = yes;
+}
+
+bool Socket::isStreamCompressionEnabled() const
+{
+    return d->streamCompression;
+}
+
+void Socket::setStreamDictionary(Block const &dictionary)
+{
+    DENG2_ASSERT(!d->deflaterReady && !d->inflaterReady);
+
+    // Only the end of the dictionary fits in the window.
+    d->streamDictionary = dictionary.right(int(de::min(dictionary.size(), MAX_STREAM_DICTIONARY)));
+}
+
+Socket::CompressionStats Socket::compressionStats() const
+{
+    DENG2_GUARD(d->stats);
+    return d->stats.value;
+}
+
 void Socket::send(IByteArray const &packet)
 {
     send(packet, d->activeChannel);
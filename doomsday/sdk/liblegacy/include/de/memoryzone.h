@@ -178,6 +178,64 @@ DENG_PUBLIC void *ZBlockSet_Allocate(zblockset_t *set);
 
 DENG_PUBLIC void Z_PrintStatus(void);
 
+/**
+ * @defgroup zoneProfile Zone Profiling
+ * @ingroup memzone
+ *
+ * When profiling is enabled, the zone keeps count of allocations, bytes, peak
+ * usage and block lifetimes per purge tag and per call site. Profiling can be
+ * enabled at runtime (or with the -zoneprofile option). Call sites are only
+ * known for code built with LIBDENG_ZONE_CALL_SITES (the DENG_ZONE_CALL_SITES
+ * CMake option), which makes the allocation functions record __FILE__ and
+ * __LINE__; otherwise all allocations are attributed to an unknown site.
+ */
+///@{
+
+DENG_PUBLIC void *Z_MallocAt(size_t size, int tag, void *user, char const *file, int line);
+DENG_PUBLIC void *Z_CallocAt(size_t size, int tag, void *user, char const *file, int line);
+DENG_PUBLIC void *Z_ReallocAt(void *ptr, size_t n, int mallocTag, char const *file, int line);
+DENG_PUBLIC void *Z_RecallocAt(void *ptr, size_t n, int callocTag, char const *file, int line);
+
+#ifdef LIBDENG_ZONE_CALL_SITES
+#  define Z_Malloc(size, tag, user)     Z_MallocAt(size, tag, user, __FILE__, __LINE__)
+#  define Z_Calloc(size, tag, user)     Z_CallocAt(size, tag, user, __FILE__, __LINE__)
+#  define Z_Realloc(ptr, n, tag)        Z_ReallocAt(ptr, n, tag, __FILE__, __LINE__)
+#  define Z_Recalloc(ptr, n, tag)       Z_RecallocAt(ptr, n, tag, __FILE__, __LINE__)
+#endif
+
+/**
+ * Enables or disables profiling. The collected statistics are kept when profiling
+ * is disabled, but blocks allocated while profiling are no longer tracked.
+ */
+DENG_PUBLIC void Z_EnableProfiling(dd_bool enable);
+
+DENG_PUBLIC dd_bool Z_IsProfiling(void);
+
+/**
+ * Clears the collected statistics. Blocks that are currently tracked remain
+ * counted as live.
+ */
+DENG_PUBLIC void Z_ResetProfile(void);
+
+/**
+ * Prints the profile to the log.
+ *
+ * @param maxSites  Maximum number of call sites to print (the ones with the most
+ *                  allocations).
+ */
+DENG_PUBLIC void Z_PrintProfile(int maxSites);
+
+/**
+ * Writes the profile and the volume fragmentation as JSON.
+ *
+ * @param nativePath  Output file.
+ *
+ * @return @c true if the file was written.
+ */
+DENG_PUBLIC dd_bool Z_WriteProfile(char const *nativePath);
+
+///@}
+
 /**
  * Puts a region of memory allocated with Z_Malloc() or malloc() up for garbage
  * collection.
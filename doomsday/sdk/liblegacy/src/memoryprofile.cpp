@@ -0,0 +1,453 @@
+/**
+ * @file memoryprofile.cpp
+ * Memory zone profiling.
+ *
+ * Allocation statistics are collected per purge tag and per call site. Each
+ * tracked block remembers its call site, tag, size and allocation time, so that
+ * frees can be attributed and the block lifetimes recorded in a histogram.
+ *
+ * Blocks allocated while profiling was disabled are not tracked, and neither are
+ * their frees.
+ *
+ * @authors Copyright © 2026 agent <agent@local>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#include "de/timer.h"
+#include "memoryzone_private.h"
+#include <QFile>
+#include <QHash>
+#include <QMap>
+#include <QMutex>
+#include <QTextStream>
+#include <de/Log>
+#include <atomic>
+#include <algorithm>
+
+using namespace de;
+
+#define LIFETIME_BUCKETS    8
+
+/// Upper limits of the lifetime histogram buckets (milliseconds).
+static unsigned const lifetimeLimits[LIFETIME_BUCKETS - 1] = {
+    1, 10, 100, 1000, 10000, 60000, 600000
+};
+
+static char const *lifetimeLabels[LIFETIME_BUCKETS] = {
+    "<1ms", "<10ms", "<100ms", "<1s", "<10s", "<1min", "<10min", ">=10min"
+};
+
+namespace {
+
+struct AllocStats
+{
+    duint64 allocCount = 0;
+    duint64 freeCount  = 0;
+    duint64 allocBytes = 0;     ///< Total number of bytes allocated.
+    duint64 liveCount  = 0;
+    duint64 liveBytes  = 0;
+    duint64 peakBytes  = 0;
+    duint64 lifetimes[LIFETIME_BUCKETS] {};
+
+    void allocated(dsize size)
+    {
+        allocCount++;
+        allocBytes += size;
+        addLive(size);
+    }
+
+    void addLive(dsize size)
+    {
+        liveCount++;
+        liveBytes += size;
+        peakBytes = de::max(peakBytes, liveBytes);
+    }
+
+    void removeLive(dsize size)
+    {
+        liveCount--;
+        liveBytes -= size;
+    }
+
+    void freed(dsize size, duint lifetime)
+    {
+        freeCount++;
+        removeLive(size);
+
+        int bucket = 0;
+        while (bucket < LIFETIME_BUCKETS - 1 && lifetime >= lifetimeLimits[bucket]) bucket++;
+        lifetimes[bucket]++;
+    }
+
+    void resetCounters()
+    {
+        allocCount = freeCount = allocBytes = 0;
+        peakBytes = liveBytes;
+        std::fill(lifetimes, lifetimes + LIFETIME_BUCKETS, 0);
+    }
+};
+
+struct CallSite
+{
+    char const *file;
+    int line;
+    AllocStats stats;
+};
+
+struct TrackedBlock
+{
+    CallSite *site;
+    int tag;
+    dsize size;
+    duint allocTime;
+};
+
+typedef QPair<char const *, int> CallSiteKey;
+
+} // namespace
+
+static std::atomic_bool profiling { false };
+static QMutex profileMutex;
+static duint profileStartTime;
+static QMap<int, AllocStats> tagStats;
+static QHash<CallSiteKey, CallSite *> callSites;
+static QHash<void const *, TrackedBlock> tracked;
+
+static CallSite &callSite(char const *file, int line)
+{
+    CallSiteKey const key(file, file? line : 0);
+    auto found = callSites.constFind(key);
+    if (found != callSites.constEnd()) return **found;
+
+    CallSite *site = new CallSite;
+    site->file = file;
+    site->line = key.second;
+    callSites.insert(key, site);
+    return *site;
+}
+
+static void untrack(QHash<void const *, TrackedBlock>::iterator found, duint now)
+{
+    TrackedBlock const &block = found.value();
+    duint const lifetime = now - block.allocTime;
+    tagStats[block.tag].freed(block.size, lifetime);
+    block.site->stats.freed(block.size, lifetime);
+}
+
+void Z_ProfileAlloc(void const *ptr, size_t size, int tag, char const *file, int line)
+{
+    QMutexLocker lock(&profileMutex);
+    if (!profiling) return;
+
+    CallSite &site = callSite(file, line);
+    site.stats.allocated(size);
+    tagStats[tag].allocated(size);
+
+    auto found = tracked.find(ptr);
+    if (found != tracked.end())
+    {
+        // The previous block at this address was released without being seen.
+        untrack(found, Timer_RealMilliseconds());
+    }
+
+    TrackedBlock &block = tracked[ptr];
+    block.site      = &site;
+    block.tag       = tag;
+    block.size      = size;
+    block.allocTime = Timer_RealMilliseconds();
+}
+
+void Z_ProfileFree(void const *ptr)
+{
+    QMutexLocker lock(&profileMutex);
+
+    auto found = tracked.find(ptr);
+    if (found == tracked.end()) return;
+
+    untrack(found, Timer_RealMilliseconds());
+    tracked.erase(found);
+}
+
+void Z_ProfileFreeTags(int lowTag, int highTag)
+{
+    QMutexLocker lock(&profileMutex);
+
+    // Slab pages may be released without freeing their blocks individually.
+    duint const now = Timer_RealMilliseconds();
+    for (auto i = tracked.begin(); i != tracked.end(); )
+    {
+        if (i.value().tag >= lowTag && i.value().tag <= highTag)
+        {
+            untrack(i, now);
+            i = tracked.erase(i);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+}
+
+void Z_ProfileChangeTag(void const *ptr, int tag)
+{
+    QMutexLocker lock(&profileMutex);
+
+    auto found = tracked.find(ptr);
+    if (found == tracked.end() || found.value().tag == tag) return;
+
+    TrackedBlock &block = found.value();
+    tagStats[block.tag].removeLive(block.size);
+    tagStats[tag].addLive(block.size);
+    block.tag = tag;
+}
+
+void Z_ShutdownProfile(void)
+{
+    QMutexLocker lock(&profileMutex);
+
+    profiling = false;
+    tracked.clear();
+    tagStats.clear();
+    qDeleteAll(callSites);
+    callSites.clear();
+}
+
+void Z_EnableProfiling(dd_bool enable)
+{
+    QMutexLocker lock(&profileMutex);
+
+    if (profiling == bool(enable)) return;
+
+    profiling = bool(enable);
+    if (enable)
+    {
+        profileStartTime = Timer_RealMilliseconds();
+
+        // Nothing is being tracked yet.
+        for (AllocStats &stats : tagStats)
+        {
+            stats.liveCount = stats.liveBytes = 0;
+        }
+        for (CallSite *site : callSites)
+        {
+            site->stats.liveCount = site->stats.liveBytes = 0;
+        }
+    }
+    else
+    {
+        // Frees are no longer seen, so the blocks can't be tracked.
+        tracked.clear();
+    }
+}
+
+dd_bool Z_IsProfiling(void)
+{
+    return profiling.load(std::memory_order_relaxed);
+}
+
+void Z_ResetProfile(void)
+{
+    QMutexLocker lock(&profileMutex);
+
+    profileStartTime = Timer_RealMilliseconds();
+    for (AllocStats &stats : tagStats)
+    {
+        stats.resetCounters();
+    }
+    for (CallSite *site : callSites)
+    {
+        site->stats.resetCounters();
+    }
+}
+
+static String callSiteName(CallSite const &site)
+{
+    if (!site.file) return "(unknown)";
+    return String("%1:%2").arg(site.file).arg(site.line);
+}
+
+static String statsAsText(AllocStats const &stats)
+{
+    return String("%1 allocs (%2 KB), %3 frees, %4 live (%5 KB), peak %6 KB")
+            .arg(stats.allocCount)
+            .arg(stats.allocBytes / 1024.0, 0, 'f', 1)
+            .arg(stats.freeCount)
+            .arg(stats.liveCount)
+            .arg(stats.liveBytes / 1024.0, 0, 'f', 1)
+            .arg(stats.peakBytes / 1024.0, 0, 'f', 1);
+}
+
+static String lifetimesAsText(AllocStats const &stats)
+{
+    String text;
+    for (int i = 0; i < LIFETIME_BUCKETS; ++i)
+    {
+        if (!stats.lifetimes[i]) continue;
+        if (!text.isEmpty()) text += " ";
+        text += String("%1:%2").arg(lifetimeLabels[i]).arg(stats.lifetimes[i]);
+    }
+    return text;
+}
+
+/// Call sites in descending order of allocation count. Called with the profile locked.
+static QList<CallSite *> sortedCallSites()
+{
+    QList<CallSite *> sites = callSites.values();
+    std::sort(sites.begin(), sites.end(), [] (CallSite const *a, CallSite const *b) {
+        return a->stats.allocCount > b->stats.allocCount;
+    });
+    return sites;
+}
+
+void Z_PrintProfile(int maxSites)
+{
+    LOG_AS("Z_PrintProfile");
+
+    // Volume statistics are collected first, as they need the zone locked.
+    QList<zvolumestats_t> volumes;
+    zvolumestats_t volStats;
+    for (int i = 0; Z_GetVolumeStats(i, &volStats); ++i)
+    {
+        volumes << volStats;
+    }
+
+    QMutexLocker lock(&profileMutex);
+
+    LOG_MSG(_E(b) "Memory zone profile" _E(.) " (%s, %.1f seconds)")
+            << (profiling? "enabled" : "disabled")
+            << (Timer_RealMilliseconds() - profileStartTime) / 1000.0;
+
+    for (int i = 0; i < volumes.size(); ++i)
+    {
+        zvolumestats_t const &vol = volumes.at(i);
+        LOG_MSG("Volume %i: %.1f MB in use, %i free blocks, largest %i KB, %.1f%% fragmented")
+                << i << vol.allocatedBytes / 1024.0 / 1024.0 << vol.freeBlockCount
+                << int(vol.largestFreeBlock / 1024) << vol.fragmentation * 100;
+    }
+
+    for (auto i = tagStats.constBegin(); i != tagStats.constEnd(); ++i)
+    {
+        LOG_MSG("Tag %3i: %s") << i.key() << statsAsText(i.value());
+        LOG_MSG("  Lifetimes: %s") << lifetimesAsText(i.value());
+    }
+
+    QList<CallSite *> const sites = sortedCallSites();
+    for (int i = 0; i < sites.size() && i < maxSites; ++i)
+    {
+        LOG_MSG("%s: %s") << callSiteName(*sites.at(i)) << statsAsText(sites.at(i)->stats);
+    }
+}
+
+static void writeStatsJSON(QTextStream &os, AllocStats const &stats)
+{
+    os << "\"allocCount\": " << stats.allocCount
+       << ", \"allocBytes\": " << stats.allocBytes
+       << ", \"freeCount\": " << stats.freeCount
+       << ", \"liveCount\": " << stats.liveCount
+       << ", \"liveBytes\": " << stats.liveBytes
+       << ", \"peakBytes\": " << stats.peakBytes
+       << ", \"lifetimes\": [";
+    for (int i = 0; i < LIFETIME_BUCKETS; ++i)
+    {
+        os << (i? ", " : "") << stats.lifetimes[i];
+    }
+    os << "]";
+}
+
+static String escapedJSON(String text)
+{
+    return text.replace("\\", "\\\\").replace("\"", "\\\"");
+}
+
+dd_bool Z_WriteProfile(char const *nativePath)
+{
+    LOG_AS("Z_WriteProfile");
+
+    QList<zvolumestats_t> volumes;
+    zvolumestats_t volStats;
+    for (int i = 0; Z_GetVolumeStats(i, &volStats); ++i)
+    {
+        volumes << volStats;
+    }
+
+    QFile file(nativePath);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate))
+    {
+        LOG_WARNING("Failed to open \"%s\" for writing") << nativePath;
+        return false;
+    }
+
+    QMutexLocker lock(&profileMutex);
+
+    QTextStream os(&file);
+    os.setCodec("UTF-8");
+    os << "{\n\"profiling\": " << (profiling? "true" : "false")
+       << ",\n\"duration\": " << (Timer_RealMilliseconds() - profileStartTime) / 1000.0;
+
+    os << ",\n\"volumes\": [";
+    for (int i = 0; i < volumes.size(); ++i)
+    {
+        zvolumestats_t const &vol = volumes.at(i);
+        os << (i? "," : "") << "\n  { \"size\": " << duint64(vol.size)
+           << ", \"allocatedBytes\": " << duint64(vol.allocatedBytes)
+           << ", \"freeBytes\": " << duint64(vol.freeBytes)
+           << ", \"freeBlockCount\": " << vol.freeBlockCount
+           << ", \"largestFreeBlock\": " << duint64(vol.largestFreeBlock)
+           << ", \"fragmentation\": " << vol.fragmentation << " }";
+    }
+
+    os << "\n],\n\"lifetimeBuckets\": [";
+    for (int i = 0; i < LIFETIME_BUCKETS; ++i)
+    {
+        os << (i? ", " : "") << "\"" << lifetimeLabels[i] << "\"";
+    }
+
+    os << "],\n\"tags\": [";
+    for (auto i = tagStats.constBegin(); i != tagStats.constEnd(); ++i)
+    {
+        os << (i != tagStats.constBegin()? "," : "") << "\n  { \"tag\": " << i.key() << ", ";
+        writeStatsJSON(os, i.value());
+        os << " }";
+    }
+
+    os << "\n],\n\"sites\": [";
+    QList<CallSite *> const sites = sortedCallSites();
+    for (int i = 0; i < sites.size(); ++i)
+    {
+        CallSite const &site = *sites.at(i);
+        os << (i? "," : "") << "\n  { \"file\": ";
+        if (site.file)
+        {
+            os << "\"" << escapedJSON(site.file) << "\", \"line\": " << site.line << ", ";
+        }
+        else
+        {
+            os << "null, \"line\": null, ";
+        }
+        writeStatsJSON(os, site.stats);
+        os << " }";
+    }
+    os << "\n]\n}\n";
+    os.flush();
+
+    if (file.error() != QFile::NoError)
+    {
+        LOG_WARNING("Failed to write \"%s\": %s") << nativePath << file.errorString();
+        return false;
+    }
+    LOG_MSG("Memory zone profile written to \"%s\"") << nativePath;
+    return true;
+}
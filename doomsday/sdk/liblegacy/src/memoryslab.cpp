@@ -0,0 +1,728 @@
+/**
+ * @file memoryslab.cpp
+ * Memory zone slabs for small blocks.
+ *
+ * Small non-purgable blocks are allocated from fixed-size slots in slab pages.
+ * There is one arena per tag; a page belongs to one arena and one size class,
+ * and is itself an ordinary volume block that has the arena's tag. Therefore
+ * Z_FreeTags() can free the slab blocks by releasing entire pages, and only
+ * needs to look at the individual blocks of a page if some of them have a user
+ * pointer that must be cleared, or if their tag has been changed.
+ *
+ * Each thread keeps a small cache (a bin) of free slots for each arena and size
+ * class. Allocating from and freeing to a bin does not require any locking.
+ * Bins are refilled from (and flushed to) the arena's free lists, which are
+ * protected by a mutex per size class. Whenever an arena's pages are released,
+ * the arena's generation is incremented so that slots cached in the bins are
+ * discarded instead of being reused.
+ *
+ * Blocks whose tag is changed to something other than the tag of the page are
+ * called foreign blocks. If a page is released while it still contains foreign
+ * blocks, the page is orphaned: it is detached from its arena, its tag is
+ * changed to PU_APPSTATIC, and it is freed when the last foreign block in it is
+ * freed.
+ *
+ * Lock order: zone mutex first, then a size class mutex.
+ *
+ * @authors Copyright © 2026 agent <agent@local>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#include "de/c_wrapper.h"
+#include "memoryzone_private.h"
+#include <atomic>
+#include <climits>
+#include <mutex>
+#include <new>
+#include <string.h>
+
+#ifndef LIBDENG_FAKE_MEMORY_ZONE
+
+#define ALIGNED(x) (((x) + sizeof(void *) - 1)&(~(sizeof(void *) - 1)))
+
+#define MEMBLOCK_USER_ANONYMOUS    ((void *) 2)
+
+/// Size of one slab page, including the page header.
+#define SLAB_PAGE_SIZE      0x10000
+
+/// Maximum number of arenas (i.e., different tags) that use slabs. Blocks with
+/// other tags are allocated from the volumes.
+#define SLAB_MAX_ARENAS     8
+
+#define SLAB_CLASS_COUNT    8
+
+/// Number of free slots a thread can keep in each bin.
+#define SLAB_BIN_SIZE       32
+
+/// Largest block size allocated from the slabs.
+#define SLAB_MAX_SIZE       256
+
+#define ARENA_UNASSIGNED    -1
+#define ARENA_NONE          -2
+
+/// Sizes of the blocks in each size class (not including the block header).
+static size_t const slabClassSizes[SLAB_CLASS_COUNT] = {
+    16, 32, 48, 64, 96, 128, 192, SLAB_MAX_SIZE
+};
+
+struct zslabpage_s
+{
+    zslabpage_s *next;               ///< Next page in the size class.
+    zslabpage_s *allNext, *allPrev;  ///< All pages (zone locked).
+    int arena;
+    int sizeClass;
+    int tag;                         ///< Tag of the arena.
+    size_t slotSize;                 ///< Includes the block header.
+    unsigned capacity;               ///< Number of slots.
+    unsigned carved;                 ///< Number of slots taken into use so far.
+    std::atomic_int userCount;       ///< In-use slots with a user pointer.
+    int foreignCount;                ///< In-use foreign slots (zone locked).
+    bool orphan;                     ///< Detached from the arena (zone locked).
+
+    memblock_t *slot(unsigned index)
+    {
+        return reinterpret_cast<memblock_t *>(reinterpret_cast<byte *>(this)
+                                              + ALIGNED(sizeof(zslabpage_s))
+                                              + index * slotSize);
+    }
+};
+
+typedef struct zslabpage_s zslabpage_t;
+
+struct SlabClass
+{
+    std::mutex mutex;
+    memblock_t *freeList = nullptr;  ///< Linked via memblock_t::next.
+    zslabpage_t *pages = nullptr;    ///< Slots are carved from the first page.
+};
+
+struct SlabArena
+{
+    int tag = 0;
+    std::atomic_uint generation { 1 };
+    SlabClass classes[SLAB_CLASS_COUNT];
+};
+
+static SlabArena arenas[SLAB_MAX_ARENAS];
+static std::atomic_int arenaCount { 0 };
+static std::atomic_int arenaForTag[PU_PURGELEVEL];
+static std::atomic_bool slabsInited { false };
+
+static zslabpage_t *allPages;        ///< Zone locked.
+static int foreignSlots;             ///< Total number of foreign slots (zone locked).
+
+/**
+ * Free slots of one arena and size class, cached by a thread.
+ */
+struct SlabBin
+{
+    unsigned generation = 0;         ///< Arena generation of the cached slots.
+    int count = 0;
+    memblock_t *slots[SLAB_BIN_SIZE];
+};
+
+struct SlabThreadCache
+{
+    SlabBin bins[SLAB_MAX_ARENAS][SLAB_CLASS_COUNT];
+
+    ~SlabThreadCache()
+    {
+        if (!slabsInited) return;
+
+        // Give the cached slots back to the arenas.
+        for (int a = 0; a < arenaCount; ++a)
+        {
+            for (int c = 0; c < SLAB_CLASS_COUNT; ++c)
+            {
+                SlabBin &bin = bins[a][c];
+                if (!bin.count) continue;
+
+                SlabClass &sc = arenas[a].classes[c];
+                std::lock_guard<std::mutex> lock(sc.mutex);
+
+                // The generation only changes while the size classes are locked.
+                if (bin.generation != arenas[a].generation) continue;
+
+                while (bin.count > 0)
+                {
+                    memblock_t *block = bin.slots[--bin.count];
+                    block->next = sc.freeList;
+                    sc.freeList = block;
+                }
+            }
+        }
+    }
+};
+
+static thread_local SlabThreadCache threadCache;
+
+static int sizeClassFor(size_t size)
+{
+    for (int i = 0; i < SLAB_CLASS_COUNT; ++i)
+    {
+        if (size <= slabClassSizes[i]) return i;
+    }
+    return -1;
+}
+
+/**
+ * Finds the arena for a tag, creating a new arena if needed.
+ * @return Arena index, or ARENA_NONE if the tag cannot use the slabs.
+ */
+static int arenaFor(int tag)
+{
+    int index = arenaForTag[tag].load(std::memory_order_acquire);
+    if (index != ARENA_UNASSIGNED) return index;
+
+    Z_Lock();
+    index = arenaForTag[tag].load(std::memory_order_relaxed);
+    if (index == ARENA_UNASSIGNED)
+    {
+        if (arenaCount < SLAB_MAX_ARENAS)
+        {
+            index = arenaCount;
+            arenas[index].tag = tag;
+            ++arenaCount;
+        }
+        else
+        {
+            index = ARENA_NONE;
+        }
+        arenaForTag[tag].store(index, std::memory_order_release);
+    }
+    Z_Unlock();
+    return index;
+}
+
+static inline bool isForeign(zslabpage_t const *page, memblock_t const *block)
+{
+    return page->orphan || block->tag != page->tag;
+}
+
+/// Called with the zone locked.
+static void linkPage(zslabpage_t *page)
+{
+    page->allPrev = nullptr;
+    page->allNext = allPages;
+    if (allPages) allPages->allPrev = page;
+    allPages = page;
+}
+
+/// Called with the zone locked.
+static void releasePageMemory(zslabpage_t *page)
+{
+    if (page->allPrev) page->allPrev->allNext = page->allNext;
+    else allPages = page->allNext;
+    if (page->allNext) page->allNext->allPrev = page->allPrev;
+
+    page->~zslabpage_s();
+    Z_Free(page);
+}
+
+/**
+ * Allocates a new page for an arena's size class. Called with the zone locked.
+ */
+static zslabpage_t *newPage(int arena, int sizeClass)
+{
+    void *mem = Z_MallocFromVolume(SLAB_PAGE_SIZE, arenas[arena].tag, NULL);
+    if (!mem) return nullptr;
+
+    zslabpage_t *page = new (mem) zslabpage_t;
+    page->next         = nullptr;
+    page->arena        = arena;
+    page->sizeClass    = sizeClass;
+    page->tag          = arenas[arena].tag;
+    page->slotSize     = sizeof(memblock_t) + slabClassSizes[sizeClass];
+    page->capacity     = unsigned((SLAB_PAGE_SIZE - ALIGNED(sizeof(zslabpage_t))) / page->slotSize);
+    page->carved       = 0;
+    page->userCount    = 0;
+    page->foreignCount = 0;
+    page->orphan       = false;
+    linkPage(page);
+    return page;
+}
+
+/**
+ * Moves free slots to the bin, from the free list or from the current page.
+ * Called with the size class locked.
+ */
+static void takeFreeSlots(SlabClass &sc, SlabBin &bin)
+{
+    while (bin.count < SLAB_BIN_SIZE/2 && sc.freeList)
+    {
+        memblock_t *block = sc.freeList;
+        sc.freeList = block->next;
+        bin.slots[bin.count++] = block;
+    }
+    zslabpage_t *page = sc.pages;
+    while (bin.count < SLAB_BIN_SIZE/2 && page && page->carved < page->capacity)
+    {
+        memblock_t *block = page->slot(page->carved++);
+        memset(block, 0, sizeof(*block));
+        block->slabPage = page;
+        bin.slots[bin.count++] = block;
+    }
+}
+
+static bool refillBin(int arena, int sizeClass, SlabBin &bin)
+{
+    SlabArena &ar = arenas[arena];
+    SlabClass &sc = ar.classes[sizeClass];
+    {
+        std::lock_guard<std::mutex> lock(sc.mutex);
+        bin.generation = ar.generation;
+        bin.count = 0;
+        takeFreeSlots(sc, bin);
+        if (bin.count) return true;
+    }
+
+    // A new page is needed. The zone must be locked before the size class.
+    Z_Lock();
+    {
+        std::lock_guard<std::mutex> lock(sc.mutex);
+        bin.generation = ar.generation;
+        takeFreeSlots(sc, bin); // Another thread may have added a page.
+        if (!bin.count)
+        {
+            if (zslabpage_t *page = newPage(arena, sizeClass))
+            {
+                page->next = sc.pages;
+                sc.pages = page;
+                takeFreeSlots(sc, bin);
+            }
+        }
+    }
+    Z_Unlock();
+    return bin.count > 0;
+}
+
+/**
+ * Frees an in-use slot in the page: the user pointer is cleared and the slot is
+ * marked free. The slot is not put in any free list. Called with the zone locked.
+ */
+static void freeSlot(zslabpage_t *page, memblock_t *block)
+{
+    if (block->user > (void **) 0x100)
+    {
+        *block->user = 0;
+        page->userCount--;
+    }
+    if (isForeign(page, block))
+    {
+        page->foreignCount--;
+        foreignSlots--;
+    }
+    block->user = NULL;
+    block->tag  = 0;
+    block->id   = 0;
+}
+
+static inline bool isInUse(memblock_t const *block)
+{
+    return block->id == LIBDENG_ZONEID;
+}
+
+static inline bool isTagInRange(int tag, int lowTag, int highTag)
+{
+    return tag >= lowTag && tag <= highTag;
+}
+
+/**
+ * Frees the foreign slots in the tag range in all the pages that are not going to
+ * be released by Z_SlabFreeTags().
+ *
+ * @return Number of slots freed.
+ */
+static int freeForeignSlots(int lowTag, int highTag)
+{
+    int count = 0;
+    Z_Lock();
+    for (int a = 0; a < arenaCount; ++a)
+    {
+        if (isTagInRange(arenas[a].tag, lowTag, highTag)) continue;
+
+        for (SlabClass &sc : arenas[a].classes)
+        {
+            std::lock_guard<std::mutex> lock(sc.mutex);
+            for (zslabpage_t *page = sc.pages; page; page = page->next)
+            {
+                if (!page->foreignCount) continue;
+
+                for (unsigned i = 0; i < page->carved; ++i)
+                {
+                    memblock_t *block = page->slot(i);
+                    if (isInUse(block) && isForeign(page, block) &&
+                        isTagInRange(block->tag, lowTag, highTag))
+                    {
+                        freeSlot(page, block);
+                        block->next = sc.freeList;
+                        sc.freeList = block;
+                        ++count;
+                    }
+                }
+            }
+        }
+    }
+
+    // Orphaned pages only contain foreign slots.
+    zslabpage_t *next;
+    for (zslabpage_t *page = allPages; page; page = next)
+    {
+        next = page->allNext;
+        if (!page->orphan) continue;
+
+        for (unsigned i = 0; i < page->carved; ++i)
+        {
+            memblock_t *block = page->slot(i);
+            if (isInUse(block) && isTagInRange(block->tag, lowTag, highTag))
+            {
+                freeSlot(page, block);
+                ++count;
+            }
+        }
+        if (!page->foreignCount)
+        {
+            releasePageMemory(page);
+        }
+    }
+    Z_Unlock();
+    return count;
+}
+
+/**
+ * Releases a page that has been detached from its arena, whose tag is in the
+ * range being freed.
+ */
+static void releasePage(zslabpage_t *page, int lowTag, int highTag)
+{
+    Z_Lock();
+    if (page->userCount > 0 || page->foreignCount > 0)
+    {
+        // Some of the slots need individual attention.
+        for (unsigned i = 0; i < page->carved; ++i)
+        {
+            memblock_t *block = page->slot(i);
+            if (isInUse(block) && isTagInRange(block->tag, lowTag, highTag))
+            {
+                freeSlot(page, block);
+            }
+        }
+    }
+    if (page->foreignCount > 0)
+    {
+        // The remaining slots have been retagged outside the range; keep the page
+        // until they have been freed.
+        page->orphan = true;
+        Z_SetVolumeBlockTag(Z_GetBlock(page), PU_APPSTATIC);
+    }
+    else
+    {
+        releasePageMemory(page);
+    }
+    Z_Unlock();
+}
+
+void Z_InitSlabs(void)
+{
+    for (std::atomic_int &index : arenaForTag)
+    {
+        index = ARENA_UNASSIGNED;
+    }
+    arenaCount   = 0;
+    allPages     = nullptr;
+    foreignSlots = 0;
+    slabsInited  = true;
+}
+
+void Z_ShutdownSlabs(void)
+{
+    slabsInited = false;
+
+    // The pages are destroyed along with the volumes.
+    for (SlabArena &arena : arenas)
+    {
+        for (SlabClass &sc : arena.classes) sc.mutex.lock();
+        arena.generation++;
+        arena.tag = 0;
+        for (SlabClass &sc : arena.classes)
+        {
+            sc.freeList = nullptr;
+            sc.pages    = nullptr;
+            sc.mutex.unlock();
+        }
+    }
+    for (std::atomic_int &index : arenaForTag)
+    {
+        index = ARENA_UNASSIGNED;
+    }
+    arenaCount   = 0;
+    allPages     = nullptr;
+    foreignSlots = 0;
+}
+
+void *Z_SlabMalloc(size_t size, int tag, void *user)
+{
+    if (!slabsInited || !size || size > SLAB_MAX_SIZE) return NULL;
+
+    // Purgable blocks are left to the volume rovers.
+    if (tag < PU_APPSTATIC || tag >= PU_PURGELEVEL) return NULL;
+
+    int const arena = arenaFor(tag);
+    if (arena < 0) return NULL;
+
+    int const sizeClass = sizeClassFor(ALIGNED(size));
+    SlabBin &bin = threadCache.bins[arena][sizeClass];
+    if (bin.generation != arenas[arena].generation)
+    {
+        // Cached slots are from pages that have since been released.
+        bin.generation = arenas[arena].generation;
+        bin.count = 0;
+    }
+    if (!bin.count && !refillBin(arena, sizeClass, bin))
+    {
+        return NULL;
+    }
+
+    memblock_t *block = bin.slots[--bin.count];
+    zslabpage_t *page = block->slabPage;
+
+    block->size     = page->slotSize;
+    block->tag      = tag;
+    block->volume   = NULL;
+    block->next     = block->prev = NULL;
+    block->seqFirst = block->seqLast = NULL;
+
+    void *ptr = reinterpret_cast<byte *>(block) + sizeof(memblock_t);
+    if (user)
+    {
+        block->user = (void **) user;
+        *(void **) user = ptr;
+        page->userCount++;
+    }
+    else
+    {
+        block->user = (void **) MEMBLOCK_USER_ANONYMOUS;
+    }
+    block->id = LIBDENG_ZONEID;
+    return ptr;
+}
+
+void Z_SlabFree(memblock_t *block)
+{
+    zslabpage_t *page = block->slabPage;
+
+    if (isForeign(page, block))
+    {
+        Z_Lock();
+        bool const orphan = page->orphan;
+        freeSlot(page, block);
+        if (orphan)
+        {
+            if (!page->foreignCount) releasePageMemory(page);
+            Z_Unlock();
+            return;
+        }
+        Z_Unlock();
+    }
+    else
+    {
+        if (block->user > (void **) 0x100)
+        {
+            *block->user = 0;
+            page->userCount--;
+        }
+        block->user = NULL;
+        block->tag  = 0;
+        block->id   = 0;
+    }
+
+    SlabArena &arena = arenas[page->arena];
+    SlabBin &bin = threadCache.bins[page->arena][page->sizeClass];
+    if (bin.generation != arena.generation)
+    {
+        bin.generation = arena.generation;
+        bin.count = 0;
+    }
+    if (bin.count == SLAB_BIN_SIZE)
+    {
+        // Give half of the bin back to the arena.
+        SlabClass &sc = arena.classes[page->sizeClass];
+        std::lock_guard<std::mutex> lock(sc.mutex);
+        if (bin.generation != arena.generation)
+        {
+            // The arena's pages were released after the check above.
+            bin.generation = arena.generation;
+            bin.count = 0;
+            return;
+        }
+        while (bin.count > SLAB_BIN_SIZE/2)
+        {
+            memblock_t *freed = bin.slots[--bin.count];
+            freed->next = sc.freeList;
+            sc.freeList = freed;
+        }
+    }
+    bin.slots[bin.count++] = block;
+}
+
+void Z_SlabFreeTags(int lowTag, int highTag)
+{
+    if (!slabsInited) return;
+
+    Z_Lock();
+    bool const haveForeign = foreignSlots > 0;
+    Z_Unlock();
+    if (haveForeign)
+    {
+        freeForeignSlots(lowTag, highTag);
+    }
+
+    for (int a = 0; a < arenaCount; ++a)
+    {
+        SlabArena &arena = arenas[a];
+        if (!isTagInRange(arena.tag, lowTag, highTag)) continue;
+
+        // Detach all the pages and invalidate the slots cached by the threads.
+        // All the size classes are locked while the generation changes, so a
+        // thread cannot give back a cached slot after the pages are detached.
+        zslabpage_t *pages[SLAB_CLASS_COUNT];
+        for (SlabClass &sc : arena.classes) sc.mutex.lock();
+        arena.generation++;
+        for (int c = 0; c < SLAB_CLASS_COUNT; ++c)
+        {
+            SlabClass &sc = arena.classes[c];
+            pages[c]    = sc.pages;
+            sc.pages    = nullptr;
+            sc.freeList = nullptr;
+        }
+        for (SlabClass &sc : arena.classes) sc.mutex.unlock();
+
+        for (zslabpage_t *page : pages)
+        {
+            while (page)
+            {
+                zslabpage_t *next = page->next;
+                releasePage(page, lowTag, highTag);
+                page = next;
+            }
+        }
+    }
+}
+
+int Z_SlabPurge(void)
+{
+    if (!slabsInited) return 0;
+
+    Z_Lock();
+    bool const haveForeign = foreignSlots > 0;
+    Z_Unlock();
+    if (!haveForeign) return 0;
+
+    // Slab arenas are never purgable, so all purgable blocks are foreign.
+    return freeForeignSlots(PU_PURGELEVEL, INT_MAX);
+}
+
+void Z_SlabChangeTag(memblock_t *block, int tag)
+{
+    // If the new tag is purgable, the block becomes foreign and is freed by
+    // Z_SlabPurge() when the volumes run out of space.
+    zslabpage_t *page = block->slabPage;
+    bool const wasForeign = isForeign(page, block);
+    block->tag = tag;
+    bool const nowForeign = isForeign(page, block);
+    if (wasForeign != nowForeign)
+    {
+        int const delta = (nowForeign? 1 : -1);
+        page->foreignCount += delta;
+        foreignSlots += delta;
+    }
+}
+
+void Z_SlabChangeUser(memblock_t *block, void *newUser)
+{
+    zslabpage_t *page = block->slabPage;
+    if (block->user > (void **) 0x100) page->userCount--;
+    if ((void **) newUser > (void **) 0x100) page->userCount++;
+    block->user = (void **) newUser;
+}
+
+void Z_SlabCheck(void)
+{
+    if (!slabsInited) return;
+
+    int foreignTotal = 0;
+    for (zslabpage_t *page = allPages; page; page = page->allNext)
+    {
+        memblock_t const *pageBlock = Z_GetBlock(page);
+        if (pageBlock->id != LIBDENG_ZONEID || pageBlock->slabPage)
+        {
+            App_FatalError("Z_CheckHeap: slab page is not a valid block");
+        }
+        if (pageBlock->tag != (page->orphan? PU_APPSTATIC : page->tag))
+        {
+            App_FatalError("Z_CheckHeap: slab page has the wrong tag");
+        }
+        if (page->carved > page->capacity ||
+            page->capacity * page->slotSize > SLAB_PAGE_SIZE)
+        {
+            App_FatalError("Z_CheckHeap: slab page has an invalid number of slots");
+        }
+        if (page->foreignCount < 0 || page->userCount < 0)
+        {
+            App_FatalError("Z_CheckHeap: slab page has invalid slot counts");
+        }
+        foreignTotal += page->foreignCount;
+    }
+    if (foreignTotal != foreignSlots)
+    {
+        App_FatalError("Z_CheckHeap: mismatched number of retagged slab blocks");
+    }
+}
+
+void Z_SlabPrintStatus(void)
+{
+    if (!slabsInited) return;
+
+    Z_Lock();
+    int pageCount = 0, orphanCount = 0;
+    for (zslabpage_t *page = allPages; page; page = page->allNext)
+    {
+        ++pageCount;
+        if (page->orphan) ++orphanCount;
+    }
+    App_Log(DE2_LOG_DEBUG,
+            "Memory zone slabs: %i arenas, %i pages (%.1f MB), %i orphaned pages, "
+            "%i retagged blocks",
+            int(arenaCount), pageCount, pageCount * SLAB_PAGE_SIZE / 1024.0 / 1024.0,
+            orphanCount, foreignSlots);
+    Z_Unlock();
+}
+
+#else // LIBDENG_FAKE_MEMORY_ZONE
+
+// The fake zone allocates every block separately.
+void Z_InitSlabs(void) {}
+void Z_ShutdownSlabs(void) {}
+void *Z_SlabMalloc(size_t, int, void *) { return NULL; }
+void Z_SlabFree(memblock_t *) {}
+void Z_SlabFreeTags(int, int) {}
+int Z_SlabPurge(void) { return 0; }
+void Z_SlabChangeTag(memblock_t *, int) {}
+void Z_SlabChangeUser(memblock_t *, void *) {}
+void Z_SlabCheck(void) {}
+void Z_SlabPrintStatus(void) {}
+
+#endif // LIBDENG_FAKE_MEMORY_ZONE
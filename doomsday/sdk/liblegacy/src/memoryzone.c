@@ -31,6 +31,15 @@
  * all of them efficiently. This is possible because no block inside the
  * sequence could be purged by Z_Malloc() anyway.
  *
+ * @par Slabs
+ * Small blocks with non-purgable tags are allocated from slabs (see
+ * memoryslab.cpp) rather than by scanning the volumes. The slab pages are
+ * themselves volume blocks.
+ *
+ * @par Profiling
+ * When profiling is enabled, allocations and frees are reported to
+ * memoryprofile.cpp, which keeps statistics per tag and per call site.
+ *
  * @author Copyright &copy; 1999-2017 Jaakko Keränen <jaakko.keranen@iki.fi>
  * @author Copyright &copy; 2006-2013 Daniel Swanson <danij@dengine.net>
  * @author Copyright &copy; 2006 Jamie Jones <jamie_jones_au@yahoo.com.au>
@@ -59,6 +68,12 @@
 #include "de/c_wrapper.h"
 #include "memoryzone_private.h"
 
+// The definitions below are not affected by the call site macros.
+#undef Z_Malloc
+#undef Z_Calloc
+#undef Z_Realloc
+#undef Z_Recalloc
+
 // Size of one memory zone volume.
 #define MEMORY_VOLUME_SIZE  0x2000000   // 32 Mb
 
@@ -103,6 +118,16 @@ static __inline void unlockZone(void)
     Sys_Unlock(zoneMutex);
 }
 
+void Z_Lock(void)
+{
+    lockZone();
+}
+
+void Z_Unlock(void)
+{
+    unlockZone();
+}
+
 /**
  * Conversion from string to long, with the "k" and "m" suffixes.
  */
@@ -160,6 +185,7 @@ static memvolume_t *createVolume(size_t volumeSize)
     block->prev = block->next = &vol->zone->blockList;
     block->user = NULL;         // free block
     block->seqFirst = block->seqLast = NULL;
+    block->slabPage = NULL;
     block->size = vol->zone->size - sizeof(memzone_t);
 
     unlockZone();
@@ -183,6 +209,13 @@ int Z_Init(void)
 
     // Create the first volume.
     createVolume(MEMORY_VOLUME_SIZE);
+
+    Z_InitSlabs();
+
+    if (CommandLine_Exists("-zoneprofile"))
+    {
+        Z_EnableProfiling(true);
+    }
     return true;
 }
 
@@ -194,6 +227,11 @@ void Z_Shutdown(void)
     // Get rid of possible zone-allocated memory in the garbage.
     Garbage_RecycleAllWithDestructor(Z_Free);
 
+    Z_ShutdownProfile();
+
+    // The slab pages are destroyed along with the volumes.
+    Z_ShutdownSlabs();
+
     // Destroy all the memory volumes.
     while (volumeRoot)
     {
@@ -256,6 +294,21 @@ static void freeBlock(void *ptr, memblock_t **tracked)
 
     if (!ptr) return;
 
+    if (Z_IsProfiling())
+    {
+        Z_ProfileFree(ptr);
+    }
+
+#ifndef LIBDENG_FAKE_MEMORY_ZONE
+    block = Z_GetBlock(ptr);
+    if (block->id == LIBDENG_ZONEID && block->slabPage)
+    {
+        // Small blocks are returned to their slab.
+        Z_SlabFree(block);
+        return;
+    }
+#endif
+
     lockZone();
 
     block = Z_GetBlock(ptr);
@@ -270,6 +323,7 @@ static void freeBlock(void *ptr, memblock_t **tracked)
 
     // The block was allocated from this volume.
     volume = block->volume;
+    volume->tagBlocks[block->tag]--;
 
     if (block->user > (void **) 0x100) // Smaller values are not pointers.
         *block->user = 0; // Clear the user's mark.
@@ -434,6 +488,7 @@ static void splitFreeBlock(memblock_t *block, size_t size)
     newBlock->next = block->next;
     newBlock->next->prev = newBlock;
     newBlock->seqFirst = newBlock->seqLast = NULL;
+    newBlock->slabPage = NULL;
 #ifdef LIBDENG_FAKE_MEMORY_ZONE
     newBlock->area = 0;
     newBlock->areaSize = 0;
@@ -442,7 +497,40 @@ static void splitFreeBlock(memblock_t *block, size_t size)
     block->size = size;
 }
 
+static void *mallocFromVolume(size_t size, int tag, void *user, dd_bool mayPurgeSlabs);
+
 void *Z_Malloc(size_t size, int tag, void *user)
+{
+    return Z_MallocAt(size, tag, user, NULL, 0);
+}
+
+void *Z_MallocAt(size_t size, int tag, void *user, char const *file, int line)
+{
+    void *ptr = NULL;
+
+#ifndef LIBDENG_FAKE_MEMORY_ZONE
+    // Small blocks are allocated from the slabs, when possible.
+    ptr = Z_SlabMalloc(size, tag, user);
+#endif
+    if (!ptr)
+    {
+        ptr = mallocFromVolume(size, tag, user, true);
+    }
+    if (ptr && Z_IsProfiling())
+    {
+        Z_ProfileAlloc(ptr, size, tag, file, line);
+    }
+    return ptr;
+}
+
+void *Z_MallocFromVolume(size_t size, int tag, void *user)
+{
+    // Slab pages are allocated with a size class locked, so the slabs cannot
+    // be purged here.
+    return mallocFromVolume(size, tag, user, false);
+}
+
+static void *mallocFromVolume(size_t size, int tag, void *user, dd_bool mayPurgeSlabs)
 {
     memblock_t *start, *iter;
     memvolume_t *volume;
@@ -473,6 +561,20 @@ void *Z_Malloc(size_t size, int tag, void *user)
         uint numChecked = 0;
         dd_bool gotoNextVolume = false;
 
+#ifndef LIBDENG_FAKE_MEMORY_ZONE
+        if (volume == NULL && mayPurgeSlabs)
+        {
+            // Purgable blocks in the slabs are not seen by the rovers. Purge
+            // them before growing the zone, and look again if pages of
+            // retagged blocks were released as a result.
+            mayPurgeSlabs = false;
+            if (Z_SlabPurge() > 0)
+            {
+                volume = volumeRoot;
+            }
+        }
+#endif
+
         if (volume == NULL)
         {
             // We've run out of volumes.  Let's allocate a new one
@@ -601,6 +703,7 @@ void *Z_Malloc(size_t size, int tag, void *user)
             iter->user = MEMBLOCK_USER_ANONYMOUS; // mark as in use, but unowned
         }
         iter->tag = tag;
+        volume->tagBlocks[tag]++;
 
         if (tag == PU_MAPSTATIC)
         {
@@ -634,6 +737,7 @@ void *Z_Malloc(size_t size, int tag, void *user)
         volume->allocatedBytes += iter->size;
 
         iter->volume = volume;
+        iter->slabPage = NULL;
         iter->id = LIBDENG_ZONEID;
 
         unlockZone();
@@ -647,6 +751,11 @@ void *Z_Malloc(size_t size, int tag, void *user)
 }
 
 void *Z_Realloc(void *ptr, size_t n, int mallocTag)
+{
+    return Z_ReallocAt(ptr, n, mallocTag, NULL, 0);
+}
+
+void *Z_ReallocAt(void *ptr, size_t n, int mallocTag, char const *file, int line)
 {
     int     tag = ptr ? Z_GetTag(ptr) : mallocTag;
     void   *p;
@@ -654,7 +763,7 @@ void *Z_Realloc(void *ptr, size_t n, int mallocTag)
     lockZone();
 
     n = ALIGNED(n);
-    p = Z_Malloc(n, tag, 0);    // User always 0;
+    p = Z_MallocAt(n, tag, 0, file, line);    // User always 0;
 
     if (ptr)
     {
@@ -675,6 +784,20 @@ void *Z_Realloc(void *ptr, size_t n, int mallocTag)
     return p;
 }
 
+/**
+ * Determines whether @a volume has allocated blocks with tags in the range
+ * [lowTag, highTag].
+ */
+static dd_bool volumeHasTags(memvolume_t const *volume, int lowTag, int highTag)
+{
+    int tag;
+    for (tag = MAX_OF(lowTag, 0); tag <= MIN_OF(highTag, PU_PURGELEVEL); ++tag)
+    {
+        if (volume->tagBlocks[tag]) return true;
+    }
+    return false;
+}
+
 void Z_FreeTags(int lowTag, int highTag)
 {
     memvolume_t *volume;
@@ -684,8 +807,19 @@ void Z_FreeTags(int lowTag, int highTag)
             "MemoryZone: Freeing all blocks in tag range:[%i, %i)",
             lowTag, highTag+1);
 
+    if (Z_IsProfiling())
+    {
+        Z_ProfileFreeTags(lowTag, highTag);
+    }
+
+    // Entire slab pages are released at once.
+    Z_SlabFreeTags(lowTag, highTag);
+
     for (volume = volumeRoot; volume; volume = volume->next)
     {
+        // Volumes without blocks in the tag range don't need to be walked.
+        if (!volumeHasTags(volume, lowTag, highTag)) continue;
+
         for (block = volume->zone->blockList.next;
             block != &volume->zone->blockList;
             block = next)
@@ -722,6 +856,9 @@ void Z_CheckHeap(void)
     for (volume = volumeRoot; volume; volume = volume->next)
     {
         size_t total = 0;
+        unsigned int tagBlocks[PU_PURGELEVEL + 1];
+
+        memset(tagBlocks, 0, sizeof(tagBlocks));
 
         // Validate the counter.
         if (allocatedMemoryInVolume(volume) != volume->allocatedBytes)
@@ -737,6 +874,11 @@ void Z_CheckHeap(void)
             block != &volume->zone->blockList; block = block->next)
         {
             total += block->size;
+            if (block->user) tagBlocks[block->tag]++;
+        }
+        if (memcmp(tagBlocks, volume->tagBlocks, sizeof(tagBlocks)))
+        {
+            App_FatalError("Z_CheckHeap: tag counters are wrong");
         }
         if (total != volume->size - sizeof(memzone_t))
         {
@@ -811,9 +953,23 @@ void Z_CheckHeap(void)
         }
     }
 
+#ifndef LIBDENG_FAKE_MEMORY_ZONE
+    Z_SlabCheck();
+#endif
+
     unlockZone();
 }
 
+void Z_SetVolumeBlockTag(memblock_t *block, int tag)
+{
+    DENG_ASSERT(block->volume && !block->slabPage);
+    DENG_ASSERT(tag >= PU_APPSTATIC && tag <= PU_PURGELEVEL);
+
+    block->volume->tagBlocks[block->tag]--;
+    block->volume->tagBlocks[tag]++;
+    block->tag = tag;
+}
+
 void Z_ChangeTag2(void *ptr, int tag)
 {
     lockZone();
@@ -822,14 +978,29 @@ void Z_ChangeTag2(void *ptr, int tag)
 
         DENG_ASSERT(block->id == LIBDENG_ZONEID);
 
-        if (tag >= PU_PURGELEVEL && PTR2INT(block->user) < 0x100)
+        if (tag < PU_APPSTATIC || tag > PU_PURGELEVEL)
+        {
+            App_Log(DE2_LOG_ERROR, "Z_ChangeTag: Invalid purgelevel %i.", tag);
+        }
+        else if (tag >= PU_PURGELEVEL && PTR2INT(block->user) < 0x100)
         {
             App_Log(DE2_LOG_ERROR,
                 "Z_ChangeTag: An owner is required for purgable blocks.");
         }
         else
         {
-            block->tag = tag;
+            if (block->slabPage)
+            {
+                Z_SlabChangeTag(block, tag);
+            }
+            else
+            {
+                Z_SetVolumeBlockTag(block, tag);
+            }
+            if (Z_IsProfiling())
+            {
+                Z_ProfileChangeTag(ptr, tag);
+            }
         }
     }
     unlockZone();
@@ -841,7 +1012,14 @@ void Z_ChangeUser(void *ptr, void *newUser)
     {
         memblock_t *block = Z_GetBlock(ptr);
         DENG_ASSERT(block->id == LIBDENG_ZONEID);
-        block->user = newUser;
+        if (block->slabPage)
+        {
+            Z_SlabChangeUser(block, newUser);
+        }
+        else
+        {
+            block->user = newUser;
+        }
     }
     unlockZone();
 }
@@ -894,13 +1072,23 @@ dd_bool Z_Contains(void *ptr)
 
 void *Z_Calloc(size_t size, int tag, void *user)
 {
-    void *ptr = Z_Malloc(size, tag, user);
+    return Z_CallocAt(size, tag, user, NULL, 0);
+}
+
+void *Z_CallocAt(size_t size, int tag, void *user, char const *file, int line)
+{
+    void *ptr = Z_MallocAt(size, tag, user, file, line);
 
     memset(ptr, 0, ALIGNED(size));
     return ptr;
 }
 
 void *Z_Recalloc(void *ptr, size_t n, int callocTag)
+{
+    return Z_RecallocAt(ptr, n, callocTag, NULL, 0);
+}
+
+void *Z_RecallocAt(void *ptr, size_t n, int callocTag, char const *file, int line)
 {
     memblock_t     *block;
     void           *p;
@@ -912,7 +1100,7 @@ void *Z_Recalloc(void *ptr, size_t n, int callocTag)
 
     if (ptr)                     // Has old data.
     {
-        p = Z_Malloc(n, Z_GetTag(ptr), NULL);
+        p = Z_MallocAt(n, Z_GetTag(ptr), NULL, file, line);
         block = Z_GetBlock(ptr);
 #ifdef LIBDENG_FAKE_MEMORY_ZONE
         bsize = block->areaSize;
@@ -933,7 +1121,7 @@ void *Z_Recalloc(void *ptr, size_t n, int callocTag)
     }
     else
     {   // Totally new allocation.
-        p = Z_Calloc(n, callocTag, NULL);
+        p = Z_CallocAt(n, callocTag, NULL, file, line);
     }
 
     unlockZone();
@@ -1038,14 +1226,70 @@ size_t Z_FreeMemory(void)
     return free;
 }
 
+dd_bool Z_GetVolumeStats(int index, zvolumestats_t *stats)
+{
+    memvolume_t *volume;
+    memblock_t *block;
+
+    if (index < 0) return false;
+
+    lockZone();
+
+    volume = volumeRoot;
+    while (volume && index-- > 0)
+    {
+        volume = volume->next;
+    }
+    if (!volume)
+    {
+        unlockZone();
+        return false;
+    }
+
+    memset(stats, 0, sizeof(*stats));
+    stats->size           = volume->size;
+    stats->allocatedBytes = volume->allocatedBytes;
+    for (block = volume->zone->blockList.next; !isRootBlock(volume, block);
+        block = block->next)
+    {
+        if (isFreeBlock(block))
+        {
+            stats->freeBytes += block->size;
+            stats->freeBlockCount++;
+            stats->largestFreeBlock = MAX_OF(stats->largestFreeBlock, block->size);
+        }
+    }
+    if (stats->freeBytes)
+    {
+        stats->fragmentation = 1.f - (float)stats->largestFreeBlock / (float)stats->freeBytes;
+    }
+
+    unlockZone();
+    return true;
+}
+
 void Z_PrintStatus(void)
 {
     size_t allocated = Z_AllocatedMemory();
     size_t wasted    = Z_FreeMemory();
+    zvolumestats_t stats;
+    int i;
 
     App_Log(DE2_LOG_DEBUG,
             "Memory zone status: %u volumes, %u bytes allocated, %u bytes free (%f%% in use)",
             Z_VolumeCount(), (uint)allocated, (uint)wasted, (float)allocated/(float)(allocated+wasted)*100.f);
+
+    for (i = 0; Z_GetVolumeStats(i, &stats); ++i)
+    {
+        App_Log(DE2_LOG_DEBUG,
+                "  Volume %i: %u free blocks, largest %u bytes (%.1f%% fragmented)",
+                i, stats.freeBlockCount, (uint)stats.largestFreeBlock,
+                stats.fragmentation * 100.f);
+    }
+
+#ifndef LIBDENG_FAKE_MEMORY_ZONE
+    Z_SlabPrintStatus();
+#endif
 }
 
 void Garbage_Trash(void *ptr)
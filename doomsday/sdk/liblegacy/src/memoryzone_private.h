@@ -50,6 +50,8 @@ void Z_Shutdown(void);
 
 size_t Z_FreeMemory(void);
 
+struct zslabpage_s;
+
 typedef struct memblock_s {
     size_t          size; // Including header and possibly tiny fragments.
     void **         user; // NULL if a free block.
@@ -58,6 +60,7 @@ typedef struct memblock_s {
     struct memvolume_s *volume; // Volume this block belongs to.
     struct memblock_s *next, *prev;
     struct memblock_s *seqLast, *seqFirst;
+    struct zslabpage_s *slabPage; // Slab page of a small block (NULL if in a volume).
 #ifdef LIBDENG_FAKE_MEMORY_ZONE
     void *          area; // The real memory area.
     size_t          areaSize; // Size of the allocated memory area.
@@ -79,6 +82,7 @@ typedef struct memvolume_s {
     memzone_t *zone;
     size_t size;
     size_t allocatedBytes;  ///< Total number of allocated bytes.
+    unsigned int tagBlocks[PU_PURGELEVEL + 1]; ///< Number of allocated blocks with each tag.
     struct memvolume_s *next;
 } memvolume_t;
 
@@ -105,6 +109,108 @@ struct zblockset_s {
     struct zblockset_block_s *_blocks;
 };
 
+/// Locks the zone mutex. Recursive locking is allowed.
+void Z_Lock(void);
+void Z_Unlock(void);
+
+/**
+ * Allocates a block directly from the memory volumes, bypassing the slabs.
+ * Used for allocating the slab pages.
+ */
+void *Z_MallocFromVolume(size_t size, int tag, void *user);
+
+/**
+ * Changes the tag of a block allocated directly from a volume (i.e., not from
+ * a slab). The zone must be locked.
+ */
+void Z_SetVolumeBlockTag(memblock_t *block, int tag);
+
+/**
+ * @defgroup memslab Memory Zone Slabs
+ * @ingroup memzone
+ *
+ * Small non-purgable blocks are allocated from slabs instead of the volumes. The
+ * slab pages are ordinary volume blocks with the same tag as the blocks inside
+ * them, so freeing a tag range releases entire pages at once. Each thread keeps a
+ * cache of free blocks, so most small allocations don't need the zone mutex.
+ * (Implemented in memoryslab.cpp.)
+ */
+///@{
+void    Z_InitSlabs(void);
+void    Z_ShutdownSlabs(void);
+
+/**
+ * Allocates a small block from the slabs.
+ *
+ * @return  Pointer to the block's memory, or @c NULL if the block is not suitable
+ *          for the slabs (the caller should then allocate from a volume).
+ */
+void   *Z_SlabMalloc(size_t size, int tag, void *user);
+
+void    Z_SlabFree(memblock_t *block);
+
+/**
+ * Frees all slab blocks in the tag range, mostly by releasing entire pages.
+ * Called by Z_FreeTags() before the volume blocks are freed.
+ */
+void    Z_SlabFreeTags(int lowTag, int highTag);
+
+/**
+ * Frees all purgable slab blocks (i.e., blocks retagged to a purge level),
+ * clearing their user pointers. Called by Z_Malloc() before it resorts to
+ * creating a new volume.
+ *
+ * @return Number of blocks freed.
+ */
+int     Z_SlabPurge(void);
+
+/// Called with the zone locked.
+void    Z_SlabChangeTag(memblock_t *block, int tag);
+
+/// Called with the zone locked.
+void    Z_SlabChangeUser(memblock_t *block, void *newUser);
+
+/// Validates the slab pages. Called with the zone locked.
+void    Z_SlabCheck(void);
+
+void    Z_SlabPrintStatus(void);
+///@}
+
+/**
+ * Usage of a memory volume.
+ */
+typedef struct zvolumestats_s {
+    size_t size;
+    size_t allocatedBytes;
+    size_t freeBytes;
+    size_t largestFreeBlock;
+    int freeBlockCount;
+    float fragmentation; ///< 1 - largest free block / free bytes (0 = contiguous).
+} zvolumestats_t;
+
+/**
+ * Determines the usage of a volume. The zone is locked while the blocks are
+ * checked.
+ *
+ * @return @c false if there is no volume @a index.
+ */
+dd_bool Z_GetVolumeStats(int index, zvolumestats_t *stats);
+
+/**
+ * @defgroup memprofile Memory Zone Profiling
+ * @ingroup memzone
+ *
+ * Hooks for collecting allocation statistics. Only called when Z_IsProfiling().
+ * (Implemented in memoryprofile.cpp.)
+ */
+///@{
+void    Z_ProfileAlloc(void const *ptr, size_t size, int tag, char const *file, int line);
+void    Z_ProfileFree(void const *ptr);
+void    Z_ProfileFreeTags(int lowTag, int highTag);
+void    Z_ProfileChangeTag(void const *ptr, int tag);
+void    Z_ShutdownProfile(void);
+///@}
+
 #ifdef LIBDENG_FAKE_MEMORY_ZONE
 memblock_t *Z_GetBlock(void *ptr);
 #else
@@ -85,6 +85,11 @@ public:
      */
     Status status() const;
 
+    /**
+     * Returns the socket of the link, or @c nullptr if there is none.
+     */
+    Socket *socket() const;
+
     /**
      * Returns the time when the link was successfully connected.
      */
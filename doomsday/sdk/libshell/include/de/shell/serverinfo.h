@@ -32,7 +32,11 @@ namespace de { namespace shell {
 class LIBSHELL_PUBLIC ServerInfo
 {
 public:
-    enum Flag { AllowJoin = 0x1, DefaultFlags = AllowJoin };
+    enum Flag {
+        AllowJoin         = 0x1,
+        StreamCompression = 0x2, ///< Joining clients may ask for stream compression.
+        DefaultFlags      = AllowJoin
+    };
     Q_DECLARE_FLAGS(Flags, Flag)
 
     ServerInfo();
@@ -143,6 +143,11 @@ AbstractLink::Status AbstractLink::status() const
     return d->status;
 }
 
+Socket *AbstractLink::socket() const
+{
+    return d->socket.get();
+}
+
 Time AbstractLink::connectedAt() const
 {
     return d->connectedAt;
@@ -22,7 +22,9 @@
 #include <de/MonospaceLogSinkFormatter>
 #include <de/MemoryLogSink>
 #include <de/LogBuffer>
+#include <de/Loop>
 #include <QList>
+#include <atomic>
 
 namespace de { namespace shell {
 
@@ -37,11 +39,20 @@ public:
 
     void addedNewEntry(LogEntry &)
     {
-        _widget.root().requestDraw();
+        // Local entries are added in the log flushing thread.
+        if (!_drawPending.exchange(true))
+        {
+            Loop::mainCall([this] ()
+            {
+                _drawPending = false;
+                _widget.root().requestDraw();
+            });
+        }
     }
 
 private:
     LogWidget &_widget;
+    std::atomic_bool _drawPending { false };
 };
 
 DENG2_PIMPL(LogWidget)
@@ -32,6 +32,7 @@ using namespace de;
 
 int main(int argc, char **argv)
 {
+    bool streamMismatch = false;
     try
     {
         TextApp app(argc, argv);
@@ -77,10 +78,49 @@ int main(int argc, char **argv)
         zip2.setMode(File::Write | File::Truncate);
         ZipArchive arch;
         arch.add(Path("world.txt"), content.toUtf8());
+
+        // A compressible entry that is streamed in several pieces.
+        Block large;
+        for (int i = 0; large.size() < 300 * 1024; ++i)
+        {
+            large += String("Line %1 of a compressible entry.\n").arg(i).toUtf8();
+        }
+        arch.add(Path("large.txt"), large);
         Writer(zip2) << arch;
         LOG_MSG("Wrote ") << zip2.path();
         LOG_MSG("") << zip2.objectNamespace();
 
+        // Read the entry back in small pieces.
+        {
+            Block const serialized(zip2);
+            ZipArchive reread(serialized);
+            Block streamed;
+            reread.streamEntry(Path("world.txt"), [&streamed] (IByteArray::Byte const *data, dsize size)
+            {
+                streamed.append(reinterpret_cast<char const *>(data), int(size));
+                return true;
+            }, 4);
+            reread.prefetch(QList<Path>() << Path("world.txt"));
+            streamMismatch = (streamed != reread.entryBlock(Path("world.txt")));
+
+            Block streamedLarge;
+            int pieces = 0;
+            reread.streamEntry(Path("large.txt"), [&streamedLarge, &pieces] (IByteArray::Byte const *data, dsize size)
+            {
+                streamedLarge.append(reinterpret_cast<char const *>(data), int(size));
+                ++pieces;
+                return true;
+            });
+            ZipArchive prefetched(serialized);
+            prefetched.prefetch(QList<Path>() << Path("world.txt") << Path("large.txt"));
+            streamMismatch |= (pieces < 2 ||
+                               streamedLarge != large ||
+                               streamedLarge != reread.entryBlock(Path("large.txt")) ||
+                               prefetched.entryBlock(Path("large.txt")) != large);
+            LOG_MSG("Streamed %i bytes of large.txt in %i pieces") << streamedLarge.size() << pieces;
+            LOG_MSG("Streamed entries match: %b") << !streamMismatch;
+        }
+
         LOG_MSG    ("General description: %s")   << zip2.description();
         LOG_VERBOSE("Verbose description: %s")   << zip2.description();
         LOGDEV_MSG ("Developer description: %s") << zip2.description();
@@ -142,5 +182,5 @@ int main(int argc, char **argv)
     }
 
     qDebug() << "Exiting main()...";
-    return 0;
+    return streamMismatch? 1 : 0;
 }
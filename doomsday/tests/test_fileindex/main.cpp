@@ -0,0 +1,137 @@
+/*
+ * The Doomsday Engine Project
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <de/TextApp>
+#include <de/FileIndex>
+#include <de/FileSystem>
+#include <de/Folder>
+#include <de/TaskGroup>
+#include <de/Time>
+#include <QDebug>
+#include <atomic>
+#include <memory>
+
+using namespace de;
+
+static int const FOLDER_COUNT = 400;
+static int const FILE_COUNT   = 100; // per folder
+static int const LOOKUP_COUNT = 100000;
+
+static String pathFor(int i)
+{
+    return String("set%1/entry%2.dat").arg(i % FOLDER_COUNT, 3, 10, QChar('0'))
+                                      .arg(i % FILE_COUNT,   3, 10, QChar('0'));
+}
+
+int main(int argc, char **argv)
+{
+    try
+    {
+        TextApp app(argc, argv);
+        app.initSubsystems(App::DisablePlugins);
+
+        // The same file names appear in every folder.
+        std::unique_ptr<Folder> root(new Folder("data"));
+        QList<Folder *> sets;
+        QList<File *> files;
+        for (int i = 0; i < FOLDER_COUNT; ++i)
+        {
+            Folder &set = root->add(new Folder(String("set%1").arg(i, 3, 10, QChar('0')))).as<Folder>();
+            sets << &set;
+            for (int k = 0; k < FILE_COUNT; ++k)
+            {
+                files << &set.add(new Folder(String("entry%1.dat").arg(k, 3, 10, QChar('0'))));
+            }
+        }
+
+        FileIndex index;
+        Time startedAt;
+        for (File *file : files) index.maybeAdd(*file);
+        qDebug() << "Added" << index.size() << "files in" << startedAt.since() << "seconds";
+
+        FileIndex::FoundFiles found;
+        startedAt = Time();
+        for (int i = 0; i < LOOKUP_COUNT; ++i)
+        {
+            found.clear();
+            index.findPartialPath(pathFor(i), found);
+        }
+        qDebug() << "Partial path lookup:" << startedAt.since() / LOOKUP_COUNT * 1.0e6 << "us";
+        if (found.size() != 1) throw Error("main", "Partial path not found");
+
+        // Lookups do not wait for modifications.
+        std::atomic_int lookups { 0 };
+        std::atomic_bool stop { false };
+        TaskGroup readers;
+        readers.start([&] () {
+            FileIndex::FoundFiles results;
+            for (int i = 0; !stop; ++i)
+            {
+                results.clear();
+                index.findPartialPath(pathFor(i), results);
+                ++lookups;
+            }
+        });
+        startedAt = Time();
+        for (File *file : files) index.remove(*file);
+        TimeSpan const elapsed = startedAt.since();
+        stop = true;
+        readers.wait();
+        qDebug() << "Removed all files in" << elapsed << "seconds during"
+                 << lookups.load() << "concurrent lookups";
+        if (index.size() != 0) throw Error("main", "Index not empty");
+
+        // Files deindex themselves when destroyed. Lookups in progress may still be
+        // looking at them, so destruction has to wait for the lookups to end.
+        for (File *file : files) index.maybeAdd(*file);
+        App::fileSystem().addUserIndex(index);
+        lookups = 0;
+        stop = false;
+        readers.start([&] () {
+            FileIndex::FoundFiles results;
+            for (int i = 0; !stop; ++i)
+            {
+                results.clear();
+                index.findPartialPath(*root, pathFor(i), results);
+                for (File const *file : results)
+                {
+                    if (file->name().isEmpty()) throw Error("main", "Found a destroyed file");
+                }
+                ++lookups;
+            }
+        });
+        startedAt = Time();
+        for (Folder *set : sets) delete root->remove(*set);
+        TimeSpan const destroyed = startedAt.since();
+        stop = true;
+        readers.wait();
+        App::fileSystem().removeUserIndex(index);
+        qDebug() << "Destroyed all files in" << destroyed << "seconds during"
+                 << lookups.load() << "concurrent lookups";
+        if (index.size() != 0) throw Error("main", "Destroyed files remain in the index");
+    }
+    catch (Error const &err)
+    {
+        qWarning() << err.asText();
+        return 1;
+    }
+
+    qDebug() << "Exiting main()...";
+    return 0;
+}
@@ -0,0 +1,128 @@
+/*
+ * The Doomsday Engine Project
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <doomsday/DoomsdayApp>
+#include <doomsday/Games>
+#include <doomsday/player.h>
+#include <doomsday/filesys/filehandle.h>
+#include <doomsday/filesys/fs_main.h>
+#include <doomsday/filesys/zip.h>
+#include <de/TextApp>
+#include <de/Time>
+#include <de/Writer>
+#include <de/ZipArchive>
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <cstdio>
+
+using namespace de;
+
+static int const ENTRY_COUNT  = 50000; // per package
+static int const FOLDER_COUNT = 100;
+
+class TestApp : public TextApp, public DoomsdayApp
+{
+public:
+    TestApp(int &argc, char **argv)
+        : TextApp(argc, argv)
+        , DoomsdayApp([] () -> Player * { return new Player; })
+    {}
+};
+
+static Zip *makePackage(NativePath const &path, String const &name)
+{
+    ZipArchive arch;
+    for (int i = 0; i < ENTRY_COUNT; ++i)
+    {
+        arch.add(Path(String("data/%1/set%2/entry%3.lmp")
+                      .arg(name)
+                      .arg(i % FOLDER_COUNT, 3, 10, QChar('0'))
+                      .arg(i, 5, 10, QChar('0'))), Block("test"));
+    }
+    Block serialized;
+    Writer(serialized) << arch;
+    QFile out(path);
+    out.open(QFile::WriteOnly | QFile::Truncate);
+    out.write(serialized);
+    out.close();
+
+    FILE *file = fopen(path.toString().toUtf8().constData(), "rb");
+    return new Zip(*FileHandle::fromNativeFile(*file, 0), path.withSeparators('/'), FileInfo());
+}
+
+static void search(String const &pattern, int expected)
+{
+    FS1::PathList found;
+    Time startedAt;
+    App_FileSystem().findAllPaths(pattern, 0, found);
+    qDebug() << pattern << "found" << found.size() << "in" << startedAt.since() * 1000 << "ms";
+
+    if (found.size() != expected)
+    {
+        throw Error("search", QString("Expected %1 paths").arg(expected));
+    }
+}
+
+int main(int argc, char **argv)
+{
+    try
+    {
+        TestApp app(argc, argv);
+        app.initSubsystems(App::DisablePlugins);
+        DoomsdayApp::setGame(DoomsdayApp::games().nullGame());
+        F_Init();
+
+        NativePath const dir = NativePath(QDir::tempPath()) / "test_fs1";
+        QDir().mkpath(dir);
+
+        QList<Zip *> packages;
+        for (String const &name : QStringList() << "first" << "second")
+        {
+            packages << makePackage(dir / (name + ".pk3"), name);
+            App_FileSystem().index(*packages.last());
+        }
+
+        String const base = App_BasePath();
+        search(base / "data/first/set042/*", ENTRY_COUNT / FOLDER_COUNT);
+        search(base / "data/second/set04*", 10 * ENTRY_COUNT / FOLDER_COUNT);
+        search(base / "*.lmp", 2 * ENTRY_COUNT);
+
+        // The second search is answered from the cached directory listing.
+        search(dir.withSeparators('/') / "*.pk3", 2);
+        search(dir.withSeparators('/') / "*.pk3", 2);
+
+        for (Zip *zip : packages)
+        {
+            App_FileSystem().deindex(*zip);
+            delete zip;
+        }
+        F_Shutdown();
+        QDir(dir).removeRecursively();
+    }
+    catch (Error const &err)
+    {
+        qWarning() << err.asText();
+        return 1;
+    }
+
+    qDebug() << "Exiting main()...";
+    return 0;
+}
@@ -0,0 +1,146 @@
+/**
+ * @file main.cpp
+ *
+ * Huffman codec tests and benchmark. @ingroup tests
+ *
+ * Any files given on the command line are used as recorded payloads in addition
+ * to the generated ones.
+ *
+ * @author Copyright &copy; 2026 agent <agent@local>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#include <de/data/huffman.h>
+#include <de/Time>
+#include <de/math.h>
+#include <QFile>
+#include <QList>
+#include <QDebug>
+
+using namespace de;
+
+/**
+ * Generates payloads that resemble game frames: mostly small values and zeros.
+ */
+static QList<Block> generatePayloads(int count)
+{
+    QList<Block> payloads;
+    duint32 seed = 1;
+    auto random = [&seed] () {
+        seed = seed * 1103515245 + 12345;
+        return (seed >> 16) & 0x7fff;
+    };
+    for (int i = 0; i < count; ++i)
+    {
+        Block payload(i < 64? i : (4 + random() % 160));
+        for (dsize k = 0; k < payload.size(); ++k)
+        {
+            int const r = random() % 10;
+            payload.data()[k] = dbyte(r < 3? 0 : r < 6? random() % 16 : random());
+        }
+        payloads << payload;
+    }
+    return payloads;
+}
+
+int main(int argc, char **argv)
+{
+    try
+    {
+        QList<Block> payloads = generatePayloads(10000);
+        for (int i = 1; i < argc; ++i)
+        {
+            QFile file(argv[i]);
+            if (file.open(QFile::ReadOnly))
+            {
+                payloads << Block(file.readAll());
+            }
+        }
+
+        // Both implementations produce the same output.
+        for (int i = 0; i < payloads.size(); ++i)
+        {
+            Block const &payload = payloads.at(i);
+            Block const coded = codec::huffmanEncode(payload);
+            if (coded != codec::huffmanEncodeTree(payload))
+            {
+                throw Error("main", QString("Payload %1 encoded differently").arg(i));
+            }
+            if (coded.size() > codec::huffmanEncodedSizeMax(payload.size()))
+            {
+                throw Error("main", QString("Payload %1 exceeds the maximum encoded size").arg(i));
+            }
+            if (codec::huffmanDecode(coded) != payload ||
+                codec::huffmanDecodeTree(coded) != payload)
+            {
+                throw Error("main", QString("Payload %1 not decoded correctly").arg(i));
+            }
+        }
+        qDebug() << "Checked" << payloads.size() << "payloads";
+
+        // Malformed input is decoded the same way, too.
+        for (int i = 0; i < payloads.size(); ++i)
+        {
+            if (codec::huffmanDecode(payloads.at(i)) != codec::huffmanDecodeTree(payloads.at(i)))
+            {
+                throw Error("main", QString("Payload %1 decoded differently as coded data").arg(i));
+            }
+        }
+
+        // Benchmark.
+        int const rounds = 20;
+        dsize total = 0;
+        {
+            Time startedAt;
+            for (int r = 0; r < rounds; ++r)
+            {
+                for (Block const &payload : payloads)
+                {
+                    total += codec::huffmanDecodeTree(codec::huffmanEncodeTree(payload)).size();
+                }
+            }
+            qDebug() << "Tree:  " << startedAt.since() << "seconds";
+        }
+        {
+            dsize maxSize = 0;
+            for (Block const &payload : payloads) maxSize = de::max(maxSize, payload.size());
+
+            Time startedAt;
+            Block coded(codec::huffmanEncodedSizeMax(maxSize));
+            Block decoded(codec::huffmanDecodedSizeMax(coded.size()));
+            for (int r = 0; r < rounds; ++r)
+            {
+                for (Block const &payload : payloads)
+                {
+                    dsize const size = codec::huffmanEncode(payload.data(), payload.size(),
+                                                            coded.data());
+                    total += codec::huffmanDecode(coded.data(), size,
+                                                  decoded.data(), decoded.size());
+                }
+            }
+            qDebug() << "Table: " << startedAt.since() << "seconds";
+        }
+        qDebug() << "Processed" << total << "bytes";
+    }
+    catch (Error const &err)
+    {
+        qWarning() << err.asText();
+        return 1;
+    }
+
+    qDebug() << "Exiting main()...";
+    return 0;
+}
@@ -0,0 +1,412 @@
+/*
+ * The Doomsday Engine Project
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <de/Error>
+#include <de/Vector>
+#include <de/aabox.h>
+#include <de/mathutil.h>
+#include <de/vector1.h>
+#include "world/bsp/partitioncost.h"
+
+#include <QDebug>
+#include <QList>
+#include <cmath>
+#include <memory>
+
+using namespace de;
+using namespace world::bsp;
+
+/**
+ * Line segment side with the same cached geometry as LineSegment::Side.
+ */
+struct Segment
+{
+    Vector2d from, to;
+    Vector2d direction;
+    coord_t length;
+    coord_t perp;
+    slopetype_t slope;
+    bool isMap;
+    void const *sourceLine;
+
+    Segment(Vector2d const &from, Vector2d const &to, bool isMap, void const *sourceLine)
+        : from(from), to(to), isMap(isMap), sourceLine(sourceLine)
+    {
+        direction = to - from;
+        length    = direction.length();
+        slope     = M_SlopeTypeXY(direction.x, direction.y);
+        perp      = from.y * direction.x - from.x * direction.y;
+    }
+
+    /// cf. LineSegment::Side::relationship()
+    LineRelationship relationship(Segment const &other, coord_t *fromDist, coord_t *toDist) const
+    {
+        if(sourceLine && sourceLine == other.sourceLine)
+        {
+            *fromDist = *toDist = 0;
+        }
+        else
+        {
+            coord_t const otherDir[2] = { other.direction.x, other.direction.y };
+            coord_t const fromV1[2]   = { from.x, from.y };
+            coord_t const toV1[2]     = { to.x, to.y };
+            *fromDist = V2d_PointLinePerpDistance(fromV1, otherDir, other.perp, other.length);
+            *toDist   = V2d_PointLinePerpDistance(toV1,   otherDir, other.perp, other.length);
+        }
+        return lineRelationship(*fromDist, *toDist);
+    }
+
+    /// cf. LineSegment::Side::boxOnSide()
+    int boxOnSide(AABoxd const &box) const
+    {
+        coord_t const fromV1[2]      = { from.x, from.y };
+        coord_t const directionV1[2] = { direction.x, direction.y };
+        return M_BoxOnLineSide2(&box, fromV1, directionV1, perp, length,
+                                LINESEGMENT_INCIDENT_DISTANCE_EPSILON);
+    }
+};
+
+/**
+ * Block tree of segment indices, subdivided like the partitioner's block map.
+ */
+struct Block
+{
+    AABox bounds;
+    QList<int> segs;     ///< Linked to this block.
+    int mapCount  = 0;   ///< At/under this block.
+    int partCount = 0;
+    std::unique_ptr<Block> right;
+    std::unique_ptr<Block> left;
+
+    Block(AABox const &bounds) : bounds(bounds) {}
+
+    bool contains(Segment const &seg) const
+    {
+        return de::min(seg.from.x, seg.to.x) >= bounds.minX &&
+               de::max(seg.from.x, seg.to.x) <= bounds.maxX &&
+               de::min(seg.from.y, seg.to.y) >= bounds.minY &&
+               de::max(seg.from.y, seg.to.y) <= bounds.maxY;
+    }
+
+    void link(QList<Segment> const &all, int index)
+    {
+        Segment const &seg = all.at(index);
+        if(seg.isMap) mapCount  += 1;
+        else          partCount += 1;
+
+        int const width  = bounds.maxX - bounds.minX;
+        int const height = bounds.maxY - bounds.minY;
+        if(width <= 256 && height <= 256)
+        {
+            segs << index;
+            return;
+        }
+
+        if(!right)
+        {
+            AABox rightBounds = bounds, leftBounds = bounds;
+            if(width >= height)
+            {
+                rightBounds.minX = leftBounds.maxX = bounds.minX + width / 2;
+            }
+            else
+            {
+                rightBounds.minY = leftBounds.maxY = bounds.minY + height / 2;
+            }
+            right.reset(new Block(rightBounds));
+            left .reset(new Block(leftBounds));
+        }
+
+        if     (right->contains(seg)) right->link(all, index);
+        else if(left ->contains(seg)) left ->link(all, index);
+        else                          segs << index;
+    }
+
+    int pack(QList<Segment> const &all, PackedSegments &packed, QList<int> &order) const
+    {
+        int const index = packed.addBlock(AABoxd(bounds.minX, bounds.minY, bounds.maxX, bounds.maxY),
+                                          mapCount, partCount);
+        for(int i : segs)
+        {
+            Segment const &seg = all.at(i);
+            packed.addSegment(seg.from, seg.to, seg.slope, seg.isMap, seg.sourceLine);
+            order << i;
+        }
+        if(right && (right->mapCount || right->partCount))
+        {
+            int const r = right->pack(all, packed, order);
+            packed.blocks[index].right = r;
+        }
+        if(left && (left->mapCount || left->partCount))
+        {
+            int const l = left->pack(all, packed, order);
+            packed.blocks[index].left = l;
+        }
+        return index;
+    }
+};
+
+/**
+ * Segment-at-a-time costing, in the manner of PartitionEvaluator::Reference.
+ */
+static void referenceCostForBlock(QList<Segment> const &all, Block const &block,
+                                  Segment const &partition, int splitCostFactor,
+                                  PartitionCost &cost)
+{
+    if(!block.mapCount && !block.partCount) return;
+
+    AABoxd const bounds = partitionTestBounds(AABoxd(block.bounds.minX, block.bounds.minY,
+                                                     block.bounds.maxX, block.bounds.maxY));
+    int side = partition.boxOnSide(bounds);
+    if(side > 0)
+    {
+        cost.mapRight  += block.mapCount;
+        cost.partRight += block.partCount;
+        return;
+    }
+    if(side < 0)
+    {
+        cost.mapLeft  += block.mapCount;
+        cost.partLeft += block.partCount;
+        return;
+    }
+
+    for(int i : block.segs)
+    {
+        Segment const &seg = all.at(i);
+        coord_t fromDist, toDist;
+        LineRelationship rel = seg.relationship(partition, &fromDist, &toDist);
+        addPartitionSegmentCost(cost, splitCostFactor, rel, fromDist, toDist, seg.isMap,
+                                rel == Collinear && seg.direction.dot(partition.direction) < 0);
+    }
+
+    if(block.right) referenceCostForBlock(all, *block.right, partition, splitCostFactor, cost);
+    if(block.left)  referenceCostForBlock(all, *block.left,  partition, splitCostFactor, cost);
+}
+
+/// Deterministic pseudo-random numbers, so that failures are reproducible.
+struct Random
+{
+    duint32 state;
+    Random(duint32 seed) : state(seed) {}
+    int operator () (int range)
+    {
+        state = state * 1664525u + 1013904223u;
+        return int((state >> 8) % duint32(range));
+    }
+};
+
+static char sourceLines[1000]; ///< Identities of "map lines".
+
+/// Adds a map line as a pair of twinned map segments.
+static void addLine(QList<Segment> &segs, Vector2d const &a, Vector2d const &b, int lineId)
+{
+    segs << Segment(a, b, true, &sourceLines[lineId])
+         << Segment(b, a, true, &sourceLines[lineId]);
+}
+
+static QList<Segment> randomLayout(duint32 seed)
+{
+    QList<Segment> segs;
+    Random rnd(seed);
+    for(int i = 0; i < 120; ++i)
+    {
+        Vector2d a(rnd(1536) - 768, rnd(1536) - 768);
+        Vector2d b = a + Vector2d(rnd(512) - 256, rnd(512) - 256);
+        if(a == b) b.x += 1;
+        if(rnd(4)) addLine(segs, a, b, i);
+        else       segs << Segment(a, b, false, nullptr); // mini-segment
+    }
+    return segs;
+}
+
+static QList<Segment> gridLayout()
+{
+    QList<Segment> segs;
+    int id = 0;
+    for(int i = -4; i <= 4; ++i)
+    {
+        addLine(segs, Vector2d(i * 128, -512), Vector2d(i * 128, 512), id++);
+        addLine(segs, Vector2d(-512, i * 128), Vector2d(512, i * 128), id++);
+    }
+    return segs;
+}
+
+/// Lines split into several collinear pieces, with off-by-epsilon cut points.
+static QList<Segment> splitLayout()
+{
+    QList<Segment> segs;
+    int id = 0;
+    for(int k = 0; k < 6; ++k)
+    {
+        Vector2d const start(-600 + k * 17, -500 + k * 190);
+        Vector2d const end(700 - k * 31, -300 + k * 113);
+        Vector2d prev = start;
+        for(int piece = 1; piece <= 5; ++piece)
+        {
+            Vector2d next = start + (end - start) * (piece / 5.0);
+            if(piece < 5) next += Vector2d(1.0 / 512, -1.0 / 512);
+            segs << Segment(prev, next, true, &sourceLines[id])
+                 << Segment(next, prev, true, &sourceLines[id]);
+            prev = next;
+        }
+        id++;
+    }
+    // Something on both sides of everything.
+    addLine(segs, Vector2d(-900, -900), Vector2d(-880, 900), id++);
+    addLine(segs, Vector2d( 900,  900), Vector2d( 880, -900), id++);
+    return segs;
+}
+
+/// Segments ending within SHORT_HEDGE_EPSILON of each other's lines.
+static QList<Segment> nearMissLayout()
+{
+    QList<Segment> segs;
+    int id = 0;
+    addLine(segs, Vector2d(-512, 0), Vector2d(512, 0), id++);
+    addLine(segs, Vector2d(0, -512), Vector2d(0, 512), id++);
+    double const offsets[] = { 0.001, 1.0 / 256, 1.0 / 128, 0.5, 1, 2, 3.99, 4, 4.01 };
+    int n = 0;
+    for(double off : offsets)
+    {
+        double const x = -480 + 100 * n++;
+        addLine(segs, Vector2d(x,  off), Vector2d(x + 20,  60), id++);
+        addLine(segs, Vector2d(x, -off), Vector2d(x + 20, -60), id++);
+        addLine(segs, Vector2d(-10, x + off), Vector2d(10, x - off), id++); // crossing near the end
+        addLine(segs, Vector2d(off, x), Vector2d(off + 30, x + 30), id++);
+        segs << Segment(Vector2d(x, -off - 1), Vector2d(x + 7, off + 1), false, nullptr);
+    }
+    return segs;
+}
+
+/// Diagonal lines at a variety of slopes.
+static QList<Segment> diagonalLayout()
+{
+    QList<Segment> segs;
+    int id = 0;
+    for(int i = 0; i < 24; ++i)
+    {
+        double const angle = i * 2 * PI / 24 + 0.1;
+        Vector2d const dir(std::cos(angle), std::sin(angle));
+        Vector2d const center(i * 37 % 300 - 150, i * 53 % 300 - 150);
+        addLine(segs, center - dir * 200, center + dir * 200, id++);
+    }
+    return segs;
+}
+
+static void compare(String const &name, QList<Segment> const &all, int splitCostFactor)
+{
+    AABox rootBounds;
+    rootBounds.minX = rootBounds.minY = -1024;
+    rootBounds.maxX = rootBounds.maxY =  1024;
+    Block root(rootBounds);
+    for(int i = 0; i < all.count(); ++i)
+    {
+        if(!root.contains(all.at(i)))
+        {
+            throw Error("compare", String("%1: segment %2 is out of bounds").arg(name).arg(i));
+        }
+        root.link(all, i);
+    }
+
+    PackedSegments packed;
+    packed.reserve(all.count());
+    QList<int> order; ///< Packed index => segment index.
+    root.pack(all, packed, order);
+    if(packed.count() != all.count())
+    {
+        throw Error("compare", String("%1: %2 of %3 segments packed")
+                                   .arg(name).arg(packed.count()).arg(all.count()));
+    }
+
+    PackedCostEvaluator evaluator(packed, splitCostFactor);
+    int suitableCount = 0;
+    int referenceBest = -1, packedBest = -1;
+    PartitionCost referenceBestCost, packedBestCost;
+    for(int k = 0; k < packed.count(); ++k)
+    {
+        Segment const &partition = all.at(order.at(k));
+        if(!partition.isMap) continue;
+
+        PartitionCost expected;
+        referenceCostForBlock(all, root, partition, splitCostFactor, expected);
+        bool const expectedSuitable = finishPartitionCost(expected, partition.slope);
+
+        PartitionCost actual;
+        bool const actualSuitable = evaluator.evaluate(k, actual);
+
+        if(expectedSuitable != actualSuitable || (expectedSuitable && !(expected == actual)))
+        {
+            throw Error("compare", String("%1: candidate %2 differs:\n  reference %3 (%4)\n  packed    %5 (%6)")
+                                       .arg(name).arg(order.at(k))
+                                       .arg(expected.asText()).arg(expectedSuitable)
+                                       .arg(actual.asText()).arg(actualSuitable));
+        }
+
+        if(expectedSuitable)
+        {
+            suitableCount++;
+            if(referenceBest < 0 || expected < referenceBestCost)
+            {
+                referenceBest = order.at(k);
+                referenceBestCost = expected;
+            }
+            if(packedBest < 0 || actual < packedBestCost)
+            {
+                packedBest = order.at(k);
+                packedBestCost = actual;
+            }
+        }
+    }
+    if(referenceBest != packedBest)
+    {
+        throw Error("compare", String("%1: best partition %2 != %3")
+                                   .arg(name).arg(packedBest).arg(referenceBest));
+    }
+    qDebug() << name << "--" << all.count() << "segments," << suitableCount
+             << "suitable partitions, best:" << packedBest << packedBestCost.asText();
+}
+
+int main(int, char **)
+{
+    try
+    {
+        for(int splitCostFactor : { 1, 7, 23 })
+        {
+            qDebug() << "Split cost factor:" << splitCostFactor;
+
+            for(duint32 seed = 1; seed <= 8; ++seed)
+            {
+                compare(String("random %1").arg(seed), randomLayout(seed), splitCostFactor);
+            }
+            compare("grid",      gridLayout(),     splitCostFactor);
+            compare("split",     splitLayout(),    splitCostFactor);
+            compare("near miss", nearMissLayout(), splitCostFactor);
+            compare("diagonal",  diagonalLayout(), splitCostFactor);
+        }
+    }
+    catch(Error const &err)
+    {
+        qWarning() << err.asText();
+        return 1;
+    }
+
+    qDebug() << "Exiting main()...";
+    return 0;
+}
@@ -0,0 +1,110 @@
+/*
+ * The Doomsday Engine Project
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <de/TextApp>
+#include <de/PathTree>
+#include <de/Time>
+#include <QDebug>
+#include <QFile>
+#include <QVector>
+
+#ifdef UNIX
+#  include <unistd.h>
+#endif
+
+using namespace de;
+
+static int const PATH_COUNT = 200000;
+
+/// @return Resident memory of the process in bytes, or zero if not known.
+static dsize residentBytes()
+{
+#ifdef UNIX
+    QFile statm("/proc/self/statm");
+    if (statm.open(QFile::ReadOnly))
+    {
+        QList<QByteArray> const fields = statm.readAll().split(' ');
+        if (fields.size() > 1)
+        {
+            return dsize(fields.at(1).toULongLong()) * dsize(sysconf(_SC_PAGESIZE));
+        }
+    }
+#endif
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    try
+    {
+        TextApp app(argc, argv);
+        app.initSubsystems(App::DisablePlugins);
+
+        // Many branches have the same name but a different parent.
+        QVector<String> paths;
+        for (int i = 0; i < PATH_COUNT; ++i)
+        {
+            paths << String("data/set%1/%2/entry%3.lmp")
+                     .arg(i % 1000, 4, 10, QChar('0'))
+                     .arg(String(i % 2? "flats" : "textures"))
+                     .arg(i, 6, 10, QChar('0'));
+        }
+
+        UserDataPathTree tree;
+        QVector<UserDataNode *> nodes;
+        dsize const memBefore = residentBytes();
+        Time startedAt;
+        for (String const &path : paths) nodes << &tree.insert(path);
+        qDebug() << "Inserted" << tree.size() << "paths in" << startedAt.since() << "seconds";
+        dsize const memAfter = residentBytes();
+        if (memAfter > memBefore)
+        {
+            qDebug() << "Resident memory grew by" << (memAfter - memBefore) / 1024 << "KB";
+        }
+
+        startedAt = Time();
+        for (String const &path : paths)
+        {
+            tree.find(path, PathTree::MatchFull | PathTree::NoBranch);
+        }
+        qDebug() << "Found paths:" << startedAt.since() / PATH_COUNT * 1.0e9 << "ns per path";
+
+        // Existing nodes stay put while other nodes come and go.
+        for (int i = 0; i < PATH_COUNT; i += 2)
+        {
+            tree.remove(paths.at(i), PathTree::MatchFull | PathTree::NoBranch);
+        }
+        for (int i = 0; i < PATH_COUNT; i += 2) tree.insert(paths.at(i));
+        for (int i = 1; i < PATH_COUNT; i += 2)
+        {
+            if (tree.tryFind(paths.at(i), PathTree::MatchFull | PathTree::NoBranch) != nodes.at(i))
+            {
+                throw Error("main", "Node moved: " + paths.at(i));
+            }
+        }
+    }
+    catch (Error const &err)
+    {
+        qWarning() << err.asText();
+        return 1;
+    }
+
+    qDebug() << "Exiting main()...";
+    return 0;
+}
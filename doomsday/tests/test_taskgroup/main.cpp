@@ -0,0 +1,167 @@
+/**
+ * @file main.cpp
+ *
+ * TaskGroup tests. @ingroup tests
+ *
+ * @author Copyright &copy; 2026 agent <agent@local>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#include <de/TaskGroup>
+#include <de/TaskPool>
+#include <QDebug>
+#include <atomic>
+
+using namespace de;
+
+static dint64 fibonacci(int n)
+{
+    if (n < 2) return n;
+    if (n < 16)
+    {
+        return fibonacci(n - 1) + fibonacci(n - 2);
+    }
+    // Nested groups: the waiting thread helps with the work.
+    dint64 a = 0;
+    TaskGroup group;
+    group.start([&a, n] () { a = fibonacci(n - 1); });
+    dint64 const b = fibonacci(n - 2);
+    group.wait();
+    return a + b;
+}
+
+int main(int, char **)
+{
+    try
+    {
+        qDebug() << "Workers:" << TaskGroup::workerCount();
+
+        // Many small tasks in one group.
+        {
+            std::atomic_int counter { 0 };
+            TaskGroup group;
+            for (int i = 0; i < 10000; ++i)
+            {
+                group.start([&counter] () { ++counter; });
+            }
+            group.wait();
+            qDebug() << "Counted:" << counter.load();
+            if (counter.load() != 10000 || !group.isDone())
+            {
+                throw Error("main", "Not all tasks were run");
+            }
+        }
+
+        // Recursive fork/join.
+        {
+            dint64 const fib = fibonacci(27);
+            qDebug() << "fibonacci(27) =" << fib;
+            if (fib != 196418) throw Error("main", "Wrong fibonacci(27)");
+        }
+
+        // parallelFor visits each index exactly once.
+        {
+            QVector<int> visits(100000, 0);
+            int *visit = visits.data();
+            parallelFor(0, visits.size(), [visit] (int begin, int end)
+            {
+                for (int i = begin; i < end; ++i) visit[i]++;
+            });
+            qDebug() << "parallelFor visited:" << visits.count(1);
+            if (visits.count(1) != visits.size())
+            {
+                throw Error("main", "parallelFor did not visit each index once");
+            }
+        }
+
+        // parallelReduce in order.
+        {
+            dint64 const sum = parallelReduce(1, 100001, dint64(0),
+                                              [] (int begin, int end) {
+                dint64 s = 0;
+                for (int i = begin; i < end; ++i) s += i;
+                return s;
+            }, [] (dint64 a, dint64 b) { return a + b; }, 1000);
+            qDebug() << "parallelReduce sum:" << sum;
+            if (sum != dint64(100000) * 100001 / 2) throw Error("main", "Wrong parallelReduce sum");
+
+            String const text = parallelReduce(0, 26, String(),
+                                               [] (int begin, int end) {
+                String s;
+                for (int i = begin; i < end; ++i) s += QChar('a' + i);
+                return s;
+            }, [] (String const &a, String const &b) { return a + b; }, 3);
+            qDebug() << "parallelReduce text:" << text;
+            if (text != "abcdefghijklmnopqrstuvwxyz")
+            {
+                throw Error("main", "parallelReduce did not reduce in order");
+            }
+        }
+
+        // The first error of a task is rethrown by wait().
+        {
+            std::atomic_int counter { 0 };
+            TaskGroup group;
+            for (int i = 0; i < 100; ++i)
+            {
+                group.start([&counter, i] ()
+                {
+                    ++counter;
+                    if (i == 50) throw Error("task", "Deliberate error");
+                });
+            }
+            bool caught = false;
+            try
+            {
+                group.wait();
+            }
+            catch (Error const &er)
+            {
+                qDebug() << "Caught:" << er.asText();
+                caught = true;
+            }
+            if (!caught) throw Error("main", "Task error was not rethrown");
+            if (counter.load() != 100 || !group.isDone())
+            {
+                throw Error("main", "Not all tasks were run after an error");
+            }
+        }
+
+        // TaskPool runs on the same workers.
+        {
+            std::atomic_int counter { 0 };
+            TaskPool pool;
+            for (int i = 0; i < 100; ++i)
+            {
+                pool.start([&counter] () { ++counter; }, TaskPool::HighPriority);
+            }
+            pool.waitForDone();
+            qDebug() << "TaskPool counted:" << counter.load();
+            if (counter.load() != 100 || !pool.isDone())
+            {
+                throw Error("main", "Not all TaskPool tasks were run");
+            }
+        }
+    }
+    catch (Error const &err)
+    {
+        qWarning() << err.asText();
+        return 1;
+    }
+
+    qDebug() << "Exiting main()...";
+    return 0;
+}
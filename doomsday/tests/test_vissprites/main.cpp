@@ -0,0 +1,139 @@
+/*
+ * The Doomsday Engine Project
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <de/TextApp>
+#include <de/Time>
+#include <QDebug>
+#include <QVector>
+#include <cstdlib>
+
+#include "render/visspritesort.h"
+
+using namespace de;
+
+/**
+ * Stand-in for the client's vissprite_t: the sort only looks at the distance, but
+ * the rest of the struct is walked over by the old selection sort.
+ */
+struct VisSprite
+{
+    VisSprite *prev;
+    VisSprite *next;
+    ddouble distance;
+    dbyte payload[200];
+};
+
+/// The previous R_SortVisSprites(), for comparison: pull out the farthest remaining
+/// sprite n times.
+static VisSprite *selectionSort(QVector<VisSprite> &sprites, VisSprite &head)
+{
+    dint const count = sprites.size();
+    VisSprite unsorted;
+    unsorted.next = unsorted.prev = &unsorted;
+    for (dint i = 0; i < count; ++i)
+    {
+        sprites[i].next = (i + 1 < count? &sprites[i + 1] : &unsorted);
+        sprites[i].prev = (i > 0? &sprites[i - 1] : &unsorted);
+    }
+    unsorted.next = &sprites[0];
+    unsorted.prev = &sprites[count - 1];
+
+    head.next = head.prev = &head;
+    for (dint i = 0; i < count; ++i)
+    {
+        VisSprite *best = nullptr;
+        ddouble bestDist = 0;
+        for (VisSprite *s = unsorted.next; s != &unsorted; s = s->next)
+        {
+            if (s->distance >= bestDist)
+            {
+                bestDist = s->distance;
+                best = s;
+            }
+        }
+        best->next->prev = best->prev;
+        best->prev->next = best->next;
+
+        best->next = &head;
+        best->prev = head.prev;
+        head.prev->next = best;
+        head.prev = best;
+    }
+    return head.next;
+}
+
+int main(int argc, char **argv)
+{
+    try
+    {
+        TextApp app(argc, argv);
+        app.initSubsystems(App::DisablePlugins);
+
+        std::srand(1);
+        for (dint count : { 10000, 25000, 50000 })
+        {
+            // Sprites of a crowd of monsters, many of them at the same distance.
+            QVector<VisSprite> sprites(count);
+            for (VisSprite &spr : sprites) spr.distance = 1 + std::rand() % 4096;
+
+            // The old sort takes tens of seconds with the larger counts.
+            QVector<VisSprite *> selected;
+            if (count == 10000)
+            {
+                VisSprite head;
+                Time startedAt;
+                for (VisSprite *s = selectionSort(sprites, head); s != &head; s = s->next)
+                {
+                    selected << s;
+                }
+                qDebug() << count << "vissprites: selection sort" << startedAt.since() * 1000 << "ms";
+            }
+
+            // The sort used by R_SortVisSprites().
+            VisSprite head;
+            QVector<VisSpriteSortKey> keys(count);
+            Time startedAt;
+            VisSprite_SortByDistance(sprites.data(), count, head, keys.data(),
+                                     [] (VisSprite const &spr) { return spr.distance; });
+            qDebug() << count << "vissprites: key sort" << startedAt.since() * 1000 << "ms";
+            VisSprite *s = head.next;
+
+            // Back to front; equal distances in reverse order. The draw order must
+            // not change.
+            for (dint i = 0; s != &head; ++i, s = s->next)
+            {
+                VisSprite const *next = s->next;
+                if ((!selected.isEmpty() && s != selected.at(i)) ||
+                    (next != &head && (next->distance > s->distance ||
+                                       (next->distance == s->distance && next > s))))
+                {
+                    throw Error("main", "Vissprites sorted in the wrong order");
+                }
+            }
+        }
+    }
+    catch (Error const &err)
+    {
+        qWarning() << err.asText();
+        return 1;
+    }
+
+    qDebug() << "Exiting main()...";
+    return 0;
+}
@@ -0,0 +1,81 @@
+/*
+ * The Doomsday Engine Project
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * Prints the entries of a log written with the "-binlog" option as text.
+ *
+ * Usage: binlogtool (logfile) [-section]
+ */
+
+#include <de/BinaryLogSink>
+#include <de/Block>
+#include <de/CommandLine>
+#include <de/EscapeParser>
+#include <de/TextApp>
+#include <QFile>
+#include <QTextStream>
+#include <QDebug>
+
+using namespace de;
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        qWarning("Usage: binlogtool (logfile) [-section]");
+        return -1;
+    }
+    try
+    {
+        TextApp app(argc, argv);
+        app.setApplicationName("Binary Log Utility");
+
+        app.commandLine().makeAbsolutePath(1);
+        NativePath const inputFn = app.commandLine().at(1);
+
+        QFile input(inputFn);
+        if (!input.open(QFile::ReadOnly))
+        {
+            qWarning() << "Cannot open" << inputFn.toString();
+            return -1;
+        }
+        Block const log = input.readAll();
+
+        bool const showSection = app.commandLine().has("-section");
+
+        QTextStream out(stdout);
+        BinaryLogSink::readEntries(log, [&out, showSection] (LogEntry const &entry)
+        {
+            out << entry.when().asText() << " ";
+            if (showSection && !entry.section().isEmpty())
+            {
+                out << entry.section() << ": ";
+            }
+            out << entry.asText(LogEntry::Simple) << "\n";
+        });
+    }
+    catch (Error const &er)
+    {
+        EscapeParser esc;
+        esc.parse(er.asText());
+        qWarning() << esc.plainText();
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,725 @@
+/*
+ * The Doomsday Engine Project
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * Generates load on a dedicated server by connecting a number of simulated clients
+ * to it. The clients join the game like the real client does, move around according
+ * to a simple script, and receive frames. Meanwhile the server's own statistics are
+ * polled with "Stats?" queries. A report is printed at the end.
+ *
+ * Usage: clientswarm [-host address] [-clients N] [-duration sec] [-rampup sec]
+ *                    [-move circle|random|idle] [-seed N] [-password pwd]
+ *
+ * The statistics require the server's shell password, unless the server is
+ * running on the local computer.
+ */
+
+#include <de/Address>
+#include <de/Block>
+#include <de/CommandLine>
+#include <de/EscapeParser>
+#include <de/Loop>
+#include <de/Reader>
+#include <de/RecordValue>
+#include <de/Socket>
+#include <de/TextApp>
+#include <de/Writer>
+#include <de/data/json.h>
+#include <de/math.h>
+#include <de/shell/ServerInfo>
+#include <de/shell/libshell.h>
+#include <QCryptographicHash>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <QDebug>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "network/net_main.h"
+#include "network/protocol.h"
+
+using namespace de;
+
+namespace {
+
+/// Game state packet sent by the game plugins (GPT_GAME_STATE in
+/// apps/plugins/common/include/d_net.h).
+int const GPT_GAME_STATE = DDPT_FIRST_GAME_EVENT;
+
+enum MoveScript { MoveIdle, MoveCircle, MoveRandom };
+
+/// Converts an angle in radians to a binary angle.
+duint32 binaryAngle(ddouble radians)
+{
+    ddouble const turns = std::fmod(radians / (2 * PI), 1.0);
+    return duint32((turns < 0? turns + 1 : turns) * 4294967296.0);
+}
+
+/// Seconds since the tool was started.
+ddouble now()
+{
+    static QElapsedTimer timer;
+    if (!timer.isValid()) timer.start();
+    return timer.nsecsElapsed() / 1.0e9;
+}
+
+struct Average
+{
+    ddouble total = 0;
+    ddouble max   = 0;
+    duint64 count = 0;
+
+    void add(ddouble value)
+    {
+        total += value;
+        max = de::max(max, value);
+        count++;
+    }
+    ddouble average() const { return count? total / count : 0.0; }
+};
+
+/**
+ * One simulated client connected to the server.
+ */
+class SimulatedClient
+{
+public:
+    enum State { Disconnected, Joining, Handshaking, InGame };
+
+    int index;
+    State state = Disconnected;
+    std::unique_ptr<Socket> socket;
+    int console = -1;
+    ddouble joinedAt = 0;
+
+    // Movement.
+    MoveScript script;
+    bool hasPosition = false;
+    dfloat spawn[3] {};
+    dfloat pos[3] {};
+    duint32 angle = 0;
+    ddouble phase = 0;
+    dint32 fixAcked[3] {};  ///< Angles, origin, momentum.
+
+    // Statistics.
+    duint64 frameCount = 0;
+    duint64 framePayloadBytes = 0;
+    duint64 otherPayloadBytes = 0;
+    ddouble firstFrameAt = 0;
+    dfloat latestGameTime = 0;
+    ddouble minFrameOffset = 0;   ///< Smallest observed local time minus game time.
+    Average frameLatency;
+    Average frameInterval;
+    ddouble lastFrameAt = 0;
+    duint32 pingSentAt = 0;
+    Average pingTime;
+
+    SimulatedClient(int idx, MoveScript move) : index(idx), script(move) {}
+
+    String name() const
+    {
+        return String("Swarm%1").arg(index, 2, 10, QChar('0'));
+    }
+
+    void connect(Address const &address)
+    {
+        socket.reset(new Socket(address, 5.0));
+        socket->setQuiet(true);
+        QObject::connect(socket.get(), &Socket::messagesReady, [this] () { receive(); });
+        QObject::connect(socket.get(), &Socket::disconnected, [this] ()
+        {
+            state = Disconnected;
+        });
+
+        *socket << Block(String("Join+stream %1 %2")
+                         .arg(SV_VERSION, 4, 16, QChar('0'))
+                         .arg(name()).toUtf8());
+        state = Joining;
+    }
+
+    void disconnect()
+    {
+        if (state == InGame || state == Handshaking)
+        {
+            send(PCL_GOODBYE, Block());
+            socket->flush();
+        }
+        if (socket && socket->isOpen())
+        {
+            socket->close();
+        }
+        state = Disconnected;
+    }
+
+    void send(int type, Block const &payload)
+    {
+        if (!socket || !socket->isOpen()) return;
+        Block packet;
+        packet.append(char(type));
+        packet += payload;
+        *socket << packet;
+    }
+
+    void receive()
+    {
+        while (socket && socket->isOpen())
+        {
+            std::unique_ptr<Message> msg(socket->receive());
+            if (!msg) break;
+            try
+            {
+                handle(*msg);
+            }
+            catch (Error const &er)
+            {
+                qWarning() << name() << "received a malformed packet:" << er.asText();
+            }
+        }
+    }
+
+    void handle(Block const &msg)
+    {
+        if (state == Joining)
+        {
+            if (msg != "Enter")
+            {
+                qWarning() << name() << "was not allowed to join";
+                disconnect();
+                return;
+            }
+            socket->enableStreamCompression();
+            joinedAt = now();
+            state = Handshaking;
+
+            // Same as Cl_SendHello().
+            Block hello;
+            Writer writer(hello);
+            writer << duint32(0x5a000000 | (qrand() & 0xffff) << 8 | index);
+            Block gameId = gameIdentity.toUtf8().left(16);
+            gameId.append(QByteArray(16 - gameId.size(), '\0'));
+            writer.writeBytes(gameId);
+            send(PCL_HELLO2, hello);
+            return;
+        }
+
+        if (msg.isEmpty()) return;
+
+        int const type = duchar(msg.at(0));
+        Reader reader(msg);
+        reader.seek(1);
+
+        switch (type)
+        {
+        case PSV_HANDSHAKE: {
+            dbyte version, myConsole;
+            reader >> version >> myConsole;
+            if (version != SV_VERSION)
+            {
+                qWarning() << name() << "got an incompatible handshake, version" << version;
+                disconnect();
+                return;
+            }
+            console = myConsole;
+            send(PCL_ACK_SHAKE, Block());
+            break; }
+
+        case GPT_GAME_STATE:
+            // The map has been set up. Ready to receive frames.
+            send(PKT_OK, Block());
+            state = InGame;
+            break;
+
+        case PSV_PLAYER_FIX:
+            handlePlayerFix(reader);
+            break;
+
+        case PSV_FIRST_FRAME2:
+        case PSV_FRAME2: {
+            dfloat gameTime;
+            reader >> gameTime;
+            frameReceived(gameTime, msg.size());
+            break; }
+
+        case PKT_PING: {
+            duint32 time;
+            reader >> time;
+            if (pingSentAt && time == pingSentAt)
+            {
+                pingTime.add(now() - pingSentAt / 1000.0);
+                pingSentAt = 0;
+            }
+            else
+            {
+                // Someone else is pinging; respond with the same packet.
+                *socket << msg;
+            }
+            break; }
+
+        case PSV_SERVER_CLOSE:
+            qWarning() << name() << "was disconnected by the server";
+            disconnect();
+            return;
+
+        default:
+            break;
+        }
+
+        if (type != PSV_FRAME2 && type != PSV_FIRST_FRAME2)
+        {
+            otherPayloadBytes += msg.size();
+        }
+    }
+
+    void handlePlayerFix(Reader &reader)
+    {
+        dbyte plrNum;
+        duint32 fixes;
+        duint16 mobjId;
+        reader >> plrNum >> fixes >> mobjId;
+        if (plrNum != console) return;
+
+        if (fixes & 1)
+        {
+            dfloat lookDir;
+            reader >> fixAcked[0] >> angle >> lookDir;
+        }
+        if (fixes & 2)
+        {
+            reader >> fixAcked[1] >> pos[0] >> pos[1] >> pos[2];
+            if (!hasPosition)
+            {
+                hasPosition = true;
+                std::copy(pos, pos + 3, spawn);
+            }
+        }
+        if (fixes & 4)
+        {
+            dfloat mom[3];
+            reader >> fixAcked[2] >> mom[0] >> mom[1] >> mom[2];
+        }
+
+        Block ack;
+        Writer(ack) << fixAcked[0] << fixAcked[1] << fixAcked[2];
+        send(PCL_ACK_PLAYER_FIX, ack);
+    }
+
+    void frameReceived(dfloat gameTime, dsize size)
+    {
+        ddouble const at = now();
+
+        // The offset between local time and game time is smallest for frames that
+        // were delivered without delay. Latency is measured relative to that.
+        ddouble const offset = at - gameTime;
+        if (!frameCount)
+        {
+            firstFrameAt = at;
+            minFrameOffset = offset;
+        }
+        else
+        {
+            frameInterval.add(at - lastFrameAt);
+        }
+        if (offset < minFrameOffset)
+        {
+            minFrameOffset = offset;
+        }
+        frameLatency.add(offset - minFrameOffset);
+
+        lastFrameAt = at;
+        latestGameTime = gameTime;
+        frameCount++;
+        framePayloadBytes += size;
+    }
+
+    /**
+     * Moves the client according to its script and sends the new coordinates, like
+     * the real client does on every tic.
+     */
+    void tick(std::minstd_rand &rng)
+    {
+        if (state != InGame || !hasPosition) return;
+
+        dchar forwardMove = 0;
+        switch (script)
+        {
+        case MoveIdle:
+            break;
+
+        case MoveCircle: {
+            ddouble const radius = 64;
+            phase += 0.05;
+            pos[0] = dfloat(spawn[0] + radius * std::cos(phase));
+            pos[1] = dfloat(spawn[1] + radius * std::sin(phase));
+            angle = binaryAngle(phase + PI / 2);
+            forwardMove = 8;
+            break; }
+
+        case MoveRandom: {
+            phase += (ddouble(rng() % 1000) / 1000 - 0.5) * 0.4;
+            dfloat const dx = pos[0] - spawn[0];
+            dfloat const dy = pos[1] - spawn[1];
+            if (dx*dx + dy*dy > 128*128)
+            {
+                // Head back toward the spawn spot.
+                phase = std::atan2(-dy, -dx);
+            }
+            pos[0] += dfloat(4 * std::cos(phase));
+            pos[1] += dfloat(4 * std::sin(phase));
+            angle = binaryAngle(phase);
+            forwardMove = 8;
+            break; }
+        }
+
+        // Same as the coordinates sent in Net_DoUpdate().
+        Block coords;
+        Writer(coords)
+                << latestGameTime
+                << pos[0] << pos[1]
+                << DDMININT
+                << duint16(angle >> 16)
+                << dint16(0)
+                << forwardMove
+                << dchar(0);
+        send(PKT_COORDS, coords);
+    }
+
+    void ping()
+    {
+        if (state != InGame || pingSentAt) return;
+        pingSentAt = de::max(duint32(1), duint32(now() * 1000));
+        Block packet;
+        Writer(packet) << pingSentAt;
+        send(PKT_PING, packet);
+    }
+
+    duint64 receivedBytes() const
+    {
+        return socket? socket->compressionStats().receivedCompressedBytes : 0;
+    }
+
+    static String gameIdentity;
+};
+
+String SimulatedClient::gameIdentity;
+
+/**
+ * Statistics reported by the server in response to "Stats?".
+ */
+struct ServerSample
+{
+    ddouble at;
+    duint64 tickCount;
+    ddouble tickTime;
+    ddouble tickTimeMax;
+    std::unique_ptr<Record> record;
+};
+
+/**
+ * Set of simulated clients, and a separate connection for querying the server.
+ */
+class Swarm : DENG2_OBSERVES(Loop, Iteration)
+{
+public:
+    Swarm(TextApp &app, Address const &address, String const &password, int count,
+          MoveScript move, ddouble duration, ddouble rampUp, duint32 seed)
+        : _app(app)
+        , _address(address)
+        , _statsQuery("Stats?")
+        , _count(count)
+        , _duration(duration)
+        , _rampUp(rampUp)
+        , _out(stdout)
+        , _random(seed)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            _clients.emplace_back(new SimulatedClient(i + 1, move));
+        }
+        if (!password.isEmpty())
+        {
+            _statsQuery += QCryptographicHash::hash(password.toUtf8(), QCryptographicHash::Sha1);
+        }
+    }
+
+    void start()
+    {
+        // The game identity is needed for joining.
+        _query.reset(new Socket(_address, 5.0));
+        _query->setQuiet(true);
+        QObject::connect(_query.get(), &Socket::messagesReady, [this] () { receiveQueryReply(); });
+        *_query << Block("Info?");
+
+        _app.loop().audienceForIteration() += this;
+    }
+
+    void loopIteration() override
+    {
+        if (_finished || SimulatedClient::gameIdentity.isEmpty()) return;
+
+        ddouble const elapsed = now() - _startedAt;
+
+        // Connect more clients.
+        int const due = (_rampUp > 0? de::min(_count, int(elapsed / _rampUp * _count) + 1) : _count);
+        while (_connected < due)
+        {
+            SimulatedClient &client = *_clients[_connected++];
+            try
+            {
+                client.connect(_address);
+            }
+            catch (Error const &er)
+            {
+                qWarning() << client.name() << "failed to connect:" << er.asText();
+            }
+        }
+
+        for (auto &client : _clients)
+        {
+            client->tick(_random);
+        }
+
+        // Once per second, query the server and ping.
+        if (now() - _lastQueryAt >= 1.0)
+        {
+            _lastQueryAt = now();
+            if (!_statsDenied) *_query << _statsQuery;
+            for (auto &client : _clients) client->ping();
+        }
+
+        if (elapsed >= _duration + _rampUp)
+        {
+            finish();
+        }
+    }
+
+    void receiveQueryReply()
+    {
+        forever
+        {
+            std::unique_ptr<Message> reply(_query->receive());
+            if (!reply) break;
+
+            if (reply->startsWith("Info\n"))
+            {
+                shell::ServerInfo const info(parseRecord(reply->mid(5)));
+                SimulatedClient::gameIdentity = info.gameId();
+                _out << "Server: " << info.name() << " (" << info.gameId() << ", map "
+                     << info.map() << ")\n"
+                     << "Connecting " << _count << " clients...\n";
+                _out.flush();
+                _startedAt = now();
+            }
+            else if (reply->startsWith("Stats\n"))
+            {
+                addServerSample(parseRecord(reply->mid(6)));
+            }
+            else if (*reply == "Psw?")
+            {
+                qWarning() << "Server statistics require the shell password (-password)";
+                _statsDenied = true;
+            }
+        }
+    }
+
+    static Record parseRecord(Block const &json)
+    {
+        QVariant const response = parseJSON(String::fromUtf8(json));
+        std::unique_ptr<Value> rec(Value::constructFrom(response.toMap()));
+        if (!is<RecordValue>(*rec))
+        {
+            throw Error("Swarm::parseRecord", "Failed to parse response contents");
+        }
+        return *rec->as<RecordValue>().record();
+    }
+
+    void addServerSample(Record const &stats)
+    {
+        std::unique_ptr<ServerSample> sample(new ServerSample);
+        sample->at          = now();
+        sample->tickCount   = duint64(stats.getd("tickCount"));
+        sample->tickTime    = stats.getd("tickTime");
+        sample->tickTimeMax = stats.getd("tickTimeMax");
+        sample->record.reset(new Record(stats));
+
+        auto const &clients = stats.geta("clients").elements();
+        duint queued = 0;
+        for (Value const *value : clients)
+        {
+            Record const &client = *value->as<RecordValue>().record();
+            queued += duint(client.getd("queuedDeltas"));
+            _maxQueuedDeltas = de::max(_maxQueuedDeltas, duint(client.getd("queuedDeltas")));
+            _maxUnackedDeltas = de::max(_maxUnackedDeltas, duint(client.getd("unackedDeltas")));
+        }
+
+        if (!_samples.empty())
+        {
+            ServerSample const &prev = *_samples.back();
+            duint64 const ticks = sample->tickCount - prev.tickCount;
+            ddouble const avgTick = (ticks? (sample->tickTime - prev.tickTime) / ticks : 0.0);
+            _tickTime.add(avgTick);
+            _tickTimeMax = de::max(_tickTimeMax, sample->tickTimeMax);
+
+            _out << QString("[%1 s] %2 clients, server tick %3 ms (max %4 ms), "
+                            "queued deltas %5\n")
+                    .arg(sample->at - _startedAt, 0, 'f', 1)
+                    .arg(clients.size())
+                    .arg(avgTick * 1000, 0, 'f', 3)
+                    .arg(sample->tickTimeMax * 1000, 0, 'f', 3)
+                    .arg(queued);
+            _out.flush();
+        }
+        _samples.push_back(std::move(sample));
+    }
+
+    void finish()
+    {
+        _finished = true;
+
+        printReport();
+
+        for (auto &client : _clients)
+        {
+            client->disconnect();
+        }
+        _query->close();
+        _app.stopLoop(0);
+    }
+
+    void printReport()
+    {
+        ddouble const elapsed = now() - _startedAt;
+        int inGame = 0;
+
+        _out << "\nClients:\n"
+             << "  #  Name     Con  Frames  Frames/s  KB/s  Wire KB/s  "
+                "Interval ms  Latency avg/max ms  Ping ms\n";
+        for (auto const &c : _clients)
+        {
+            if (c->state == SimulatedClient::InGame) inGame++;
+            ddouble const span = de::max(0.001, (c->frameCount? now() - c->firstFrameAt : 0.0));
+            ddouble const inGameSpan = de::max(0.001, c->joinedAt > 0? now() - c->joinedAt : 0.0);
+            _out << QString("  %1 %2 %3 %4 %5 %6 %7 %8 %9/%10 %11\n")
+                    .arg(c->index, 2)
+                    .arg(c->name(), -8)
+                    .arg(c->console, 3)
+                    .arg(c->frameCount, 7)
+                    .arg(c->frameCount / span, 9, 'f', 1)
+                    .arg((c->framePayloadBytes + c->otherPayloadBytes) / inGameSpan / 1024, 5, 'f', 1)
+                    .arg(c->receivedBytes() / inGameSpan / 1024, 10, 'f', 1)
+                    .arg(c->frameInterval.average() * 1000, 12, 'f', 1)
+                    .arg(c->frameLatency.average() * 1000, 11, 'f', 1)
+                    .arg(c->frameLatency.max * 1000, 0, 'f', 1)
+                    .arg(c->pingTime.average() * 1000, 8, 'f', 1);
+        }
+
+        _out << QString("\n%1 of %2 clients in game after %3 seconds\n")
+                .arg(inGame).arg(_count).arg(elapsed, 0, 'f', 1);
+        _out << QString("Server tick: %1 ms on average, %2 ms at most\n")
+                .arg(_tickTime.average() * 1000, 0, 'f', 3)
+                .arg(_tickTimeMax * 1000, 0, 'f', 3);
+        _out << QString("Server delta pools: at most %1 queued and %2 unacknowledged deltas per client\n")
+                .arg(_maxQueuedDeltas).arg(_maxUnackedDeltas);
+
+        if (!_samples.empty())
+        {
+            _out << "Server-side per client:\n";
+            for (Value const *value : _samples.back()->record->geta("clients").elements())
+            {
+                Record const &client = *value->as<RecordValue>().record();
+                _out << QString("  %1 %2 sent %3 KB (%4 KB before compression), "
+                                "max frame %5 bytes, queued deltas %6\n")
+                        .arg(client.geti("console"), 2)
+                        .arg(client.gets("name"), -8)
+                        .arg(client.getd("sentBytes") / 1024, 0, 'f', 1)
+                        .arg(client.getd("sentPayloadBytes") / 1024, 0, 'f', 1)
+                        .arg(client.geti("maxFrameSize"))
+                        .arg(client.geti("queuedDeltas"));
+            }
+        }
+        _out.flush();
+    }
+
+private:
+    TextApp &_app;
+    Address _address;
+    Block _statsQuery;          ///< "Stats?" with the password hash (if any).
+    bool _statsDenied = false;  ///< Server wants a password for statistics.
+    int _count;
+    ddouble _duration;
+    ddouble _rampUp;
+    QTextStream _out;
+    std::minstd_rand _random;
+    std::vector<std::unique_ptr<SimulatedClient>> _clients;
+    int _connected = 0;
+    bool _finished = false;
+    std::unique_ptr<Socket> _query;
+    ddouble _startedAt = 0;
+    ddouble _lastQueryAt = 0;
+    std::vector<std::unique_ptr<ServerSample>> _samples;
+    Average _tickTime;
+    ddouble _tickTimeMax = 0;
+    duint _maxQueuedDeltas = 0;
+    duint _maxUnackedDeltas = 0;
+};
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    try
+    {
+        TextApp app(argc, argv);
+        app.setApplicationName("Client Swarm");
+
+        CommandLine &args = app.commandLine();
+        auto option = [&args] (char const *name, String const &defaultValue) -> String
+        {
+            if (int pos = args.check(name, 1)) return args.at(pos + 1);
+            return defaultValue;
+        };
+
+        Address const address = shell::checkPort(Address::parse(option("-host", "localhost")));
+        int const count        = option("-clients", "8").toInt();
+        ddouble const duration = option("-duration", "30").toDouble();
+        ddouble const rampUp   = option("-rampup", "0").toDouble();
+        String const move      = option("-move", "circle");
+
+        duint32 const seed     = option("-seed", "1").toUInt();
+
+        qsrand(seed);
+
+        MoveScript script = MoveCircle;
+        if (move == "idle")   script = MoveIdle;
+        if (move == "random") script = MoveRandom;
+
+        Swarm swarm(app, address, option("-password", ""), count, script, duration,
+                    rampUp, seed);
+        swarm.start();
+        return app.execLoop();
+    }
+    catch (Error const &er)
+    {
+        EscapeParser esc;
+        esc.parse(er.asText());
+        qWarning() << esc.plainText();
+        return -1;
+    }
+}